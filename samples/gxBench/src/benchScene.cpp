@@ -0,0 +1,441 @@
+#include "benchScene.h"
+
+#include "View/Elements/Structural/gxScaler.h"
+#include "View/Elements/Structural/gxScroller.h"
+#include "View/Elements/Structural/gxStructural.h"
+#include "View/Elements/Structural/Layers/gxLayers.h"
+#include "View/Elements/Structural/Anchors/gxRectAnchor.h"
+#include "View/Connections/gxLineConnection.h"
+#include "View/Layouts/gxBoxLayout.h"
+#include "View/Layouts/gxBorderLayout.h"
+#include "View/Layouts/Constraints/gxSizeConstraint.h"
+#include "View/Layouts/Constraints/gxRegionConstraint.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // The size of the control scenes are shown on
+    const gxPix ControlWidth  = 800;
+    const gxPix ControlHeight = 600;
+
+    // The size of the area generated elements are spread over
+    const gxPix SceneWidth  = 2000;
+    const gxPix SceneHeight = 2000;
+}
+
+const char* SceneKind::GetName( Type aKind )
+{
+    switch ( aKind )
+    {
+        case Flat:        return "flat";
+        case Deep:        return "deep";
+        case Box:         return "box";
+        case Border:      return "border";
+        case Connections: return "connections";
+        case Stack:       return "stack";
+        default:          return "";
+    }
+}
+
+SceneParams::SceneParams()
+  : mSize        ( 1000 ),
+    mDepth       ( 32 ),
+    mLevels      ( 4 ),
+    mConnections ( 1000 )
+{
+}
+
+BenchScene::BenchScene( SceneKind::Type aKind, const SceneParams &aParams )
+  : mKind    ( aKind ),
+    mParams  ( aParams ),
+    mControl ( gxRect( 0, 0, ControlWidth, ControlHeight ) ),
+    mSeed    ( 12345 )
+{
+    mLightweightSystem = new gxLightweightSystem( &mControl );
+
+    mDocument = new BenchDocument( gxRect( 0, 0, ControlWidth, ControlHeight ) );
+
+    gxScrollManager *iScrollManager = new gxScrollManager();
+    mScrollManagers.push_back( iScrollManager );
+    mLightweightSystem->SetScrollManager( iScrollManager );
+
+    gxScroller *iScroller = new gxScroller( iScrollManager );
+    mDocument->Add( iScroller );
+
+    gxZoomManager *iZoomManager = new gxZoomManager();
+    mZoomManagers.push_back( iZoomManager );
+
+    gxScaler *iScaler = new gxScaler( iZoomManager );
+    iScroller->Add( iScaler );
+
+    gxLayers *iLayers = new gxLayers();
+    mPrimaryLayer     = new gxLayer();
+    mConnectionLayer  = new gxLayer();
+    iLayers->Add( mPrimaryLayer, mConnectionLayer );
+    iScaler->Add( iLayers );
+
+    switch ( aKind )
+    {
+        case SceneKind::Flat:        CreateFlat();        break;
+        case SceneKind::Deep:        CreateDeep();        break;
+        case SceneKind::Box:         CreateBox();         break;
+        case SceneKind::Border:      CreateBorder();      break;
+        case SceneKind::Connections: CreateConnections(); break;
+        case SceneKind::Stack:       CreateStack();       break;
+        default: break;
+    }
+
+    mLightweightSystem->SetContents( mDocument );
+    Settle();
+}
+
+BenchScene::~BenchScene()
+{
+    // Deletes the document, and so all the elements
+    delete mLightweightSystem;
+
+    for ( size_t i = 0; i < mZoomManagers.size(); ++i )
+        delete mZoomManagers[i];
+
+    for ( size_t i = 0; i < mScrollManagers.size(); ++i )
+        delete mScrollManagers[i];
+}
+
+void BenchScene::Settle()
+{
+    mControl.RunFrames();
+}
+
+void BenchScene::Paint()
+{
+    mControl.RefreshRect( mControl.GetBounds() );
+    mControl.Update();
+}
+
+void BenchScene::InvalidateAll()
+{
+    for ( size_t i = 0; i < mElements.size(); ++i )
+        mElements[i]->Invalidate();
+}
+
+void BenchScene::Validate()
+{
+    mDocument->ValidateAll();
+}
+
+void BenchScene::MoveLeaf( int aIteration )
+{
+    if ( mLeaves.empty() )
+        return;
+
+    gxViewElement *iLeaf = mLeaves[ Random() % mLeaves.size() ];
+    gxRect iBounds = iLeaf->GetBounds();
+
+    // Jiggle back and forth, so the scene doesn't drift
+    gxPix iOffset = ( aIteration % 2 ) ? -3 : 3;
+    iLeaf->SetPosition( gxPoint( iBounds.X + iOffset, iBounds.Y + iOffset ) );
+}
+
+void BenchScene::ResizeContainer( int aIteration )
+{
+    if ( mContainers.empty() )
+        return;
+
+    gxViewElement *iContainer = mContainers[ Random() % mContainers.size() ];
+    gxSize iSize = iContainer->GetSize();
+
+    gxPix iOffset = ( aIteration % 2 ) ? -10 : 10;
+    iContainer->SetSize( gxSize( iSize.X + iOffset, iSize.Y + iOffset ) );
+}
+
+gxViewElement* BenchScene::HitTest( const gxPoint &aPoint )
+{
+    return HitTest( mDocument, aPoint );
+}
+
+gxViewElement* BenchScene::HitTest( gxViewElement *aElement,
+                                    const gxPoint &aPoint )
+{
+    // There's no hit testing in the view yet, so this is the straightforward
+    // one: walk down, topmost children first, comparing the point with each
+    // element absolute bounds.
+    gxRect iBounds = aElement->GetBounds();
+
+    if ( aElement->GetParent() )
+        aElement->TransformToAbsolute( iBounds );
+
+    if ( !iBounds.Contains( aPoint ) )
+        return NULL;
+
+    gxViewElement::List *iChildren = aElement->GetChildren();
+    gxViewElement::List::reverse_iterator it;
+
+    for ( it = iChildren->rbegin(); it != iChildren->rend(); ++it )
+    {
+        gxViewElement *iHit = HitTest( *it, aPoint );
+
+        if ( iHit )
+            return iHit;
+    }
+
+    // Structural elements (layers, scrollers...) are see-through
+    if ( dynamic_cast<gxStructural*>( aElement ) )
+        return NULL;
+
+    return aElement;
+}
+
+gxPoint BenchScene::GetRandomPoint()
+{
+    return gxPoint( Random() % ControlWidth, Random() % ControlHeight );
+}
+
+unsigned BenchScene::Random()
+{
+    // A linear congruential generator, so runs are repeatable
+    mSeed = mSeed * 1103515245 + 12345;
+    return ( mSeed >> 16 ) & 0x7fff;
+}
+
+gxViewElement* BenchScene::AddStackLevel( gxViewElement *aParent,
+                                          const gxRect  &aBounds )
+{
+    gxRectangle *iFrame = new gxRectangle( aBounds );
+    aParent->Add( iFrame );
+
+    gxScrollManager *iScrollManager = new gxScrollManager();
+    mScrollManagers.push_back( iScrollManager );
+
+    gxScroller *iScroller = new gxScroller( iScrollManager );
+    iFrame->Add( iScroller );
+
+    gxZoomManager *iZoomManager = new gxZoomManager();
+    mZoomManagers.push_back( iZoomManager );
+
+    gxScaler *iScaler = new gxScaler( iZoomManager );
+    iScroller->Add( iScaler );
+
+    mElements.push_back( iFrame );
+    mElements.push_back( iScroller );
+    mElements.push_back( iScaler );
+
+    return iScaler;
+}
+
+void BenchScene::AddGrid( gxViewElement *aParent,
+                          int            aCount,
+                          const gxRect  &aArea )
+{
+    if ( aCount <= 0 )
+        return;
+
+    int iColumns = (int)std::ceil( std::sqrt( (double)aCount ) );
+    int iRows    = ( aCount + iColumns - 1 ) / iColumns;
+
+    gxPix iCellWidth  = std::max( aArea.width / iColumns, 2 );
+    gxPix iCellHeight = std::max( aArea.height / iRows, 2 );
+
+    for ( int i = 0; i < aCount; ++i )
+    {
+        gxRectangle *iRect = new gxRectangle(
+            gxRect( aArea.X + ( i % iColumns ) * iCellWidth,
+                    aArea.Y + ( i / iColumns ) * iCellHeight,
+                    iCellWidth * 3 / 4 + 1,
+                    iCellHeight * 3 / 4 + 1 ) );
+
+        aParent->Add( iRect );
+
+        mElements.push_back( iRect );
+        mLeaves.push_back( iRect );
+    }
+}
+
+void BenchScene::CreateFlat()
+{
+    AddGrid( mPrimaryLayer,
+             mParams.mSize,
+             gxRect( 0, 0, SceneWidth, SceneHeight ) );
+}
+
+void BenchScene::CreateDeep()
+{
+    int iDepth  = std::max( mParams.mDepth, 1 );
+    int iChains = std::max( mParams.mSize / iDepth, 1 );
+
+    int iColumns = (int)std::ceil( std::sqrt( (double)iChains ) );
+    gxPix iCell  = SceneWidth / iColumns;
+
+    for ( int i = 0; i < iChains; ++i )
+    {
+        gxViewElement *iParent = mPrimaryLayer;
+        gxRect iBounds( ( i % iColumns ) * iCell,
+                        ( i / iColumns ) * iCell,
+                        iCell * 3 / 4 + iDepth,
+                        iCell * 3 / 4 + iDepth );
+
+        for ( int j = 0; j < iDepth; ++j )
+        {
+            gxRectangle *iRect = new gxRectangle( iBounds );
+
+            // Each level is only slightly offset from its parent, so children
+            // mustn't be clipped away
+            iRect->SetClipChildren( false );
+            iParent->Add( iRect );
+
+            mElements.push_back( iRect );
+            mLeaves.push_back( iRect );
+
+            iParent = iRect;
+            iBounds = gxRect( 1, 1, iBounds.width - 1, iBounds.height - 1 );
+        }
+    }
+}
+
+void BenchScene::CreateBox()
+{
+    // Each container holds eight children
+    const int iChildren = 8;
+    int iContainers = std::max( mParams.mSize / ( iChildren + 1 ), 1 );
+
+    int iColumns = (int)std::ceil( std::sqrt( (double)iContainers ) );
+    gxPix iCell  = SceneWidth / iColumns;
+
+    for ( int i = 0; i < iContainers; ++i )
+    {
+        bool iHorizontal = ( i % 2 ) == 0;
+
+        gxRectangle *iContainer = new gxRectangle(
+            gxRect( ( i % iColumns ) * iCell,
+                    ( i / iColumns ) * iCell,
+                    iCell * 3 / 4 + 1,
+                    iCell * 3 / 4 + 1 ) );
+
+        gxBoxLayout *iLayout = new gxBoxLayout( gxLayoutDistribute::Equal,
+                                                gxLayoutStretch::None,
+                                                gxLayoutAlign::Middle,
+                                                iHorizontal );
+        iContainer->SetLayout( iLayout );
+
+        for ( int j = 0; j < iChildren; ++j )
+        {
+            gxRectangle *iChild = new gxRectangle( gxRect( 0, 0, 5 + j, 5 + j ) );
+            iContainer->Add( iChild );
+
+            if ( j % 3 == 0 )
+                iLayout->SetConstraint( iChild, new gxSizeConstraint( gxSizeConstraint::Flex, 1 + j ) );
+            else if ( j % 3 == 1 )
+                iLayout->SetConstraint( iChild, new gxSizeConstraint( gxSizeConstraint::Percent, 10 ) );
+
+            mElements.push_back( iChild );
+        }
+
+        mPrimaryLayer->Add( iContainer );
+
+        mElements.push_back( iContainer );
+        mContainers.push_back( iContainer );
+        mLeaves.push_back( iContainer );
+    }
+}
+
+void BenchScene::CreateBorder()
+{
+    // Each container holds one child per region
+    const gxLayoutRegion::Type iRegions[] = { gxLayoutRegion::North,
+                                              gxLayoutRegion::South,
+                                              gxLayoutRegion::West,
+                                              gxLayoutRegion::East,
+                                              gxLayoutRegion::Center };
+    const int iChildren = sizeof( iRegions ) / sizeof( iRegions[0] );
+    int iContainers = std::max( mParams.mSize / ( iChildren + 1 ), 1 );
+
+    int iColumns = (int)std::ceil( std::sqrt( (double)iContainers ) );
+    gxPix iCell  = SceneWidth / iColumns;
+
+    for ( int i = 0; i < iContainers; ++i )
+    {
+        gxRectangle *iContainer = new gxRectangle(
+            gxRect( ( i % iColumns ) * iCell,
+                    ( i / iColumns ) * iCell,
+                    iCell * 3 / 4 + 1,
+                    iCell * 3 / 4 + 1 ) );
+
+        gxBorderLayout *iLayout = new gxBorderLayout( ( i % 2 ) == 0 );
+        iContainer->SetLayout( iLayout );
+
+        for ( int j = 0; j < iChildren; ++j )
+        {
+            gxRectangle *iChild = new gxRectangle( gxSize( 5, 5 ) );
+            iContainer->Add( iChild );
+            iLayout->SetConstraint( iChild, new gxRegionConstraint( iRegions[j] ) );
+
+            mElements.push_back( iChild );
+        }
+
+        mPrimaryLayer->Add( iContainer );
+
+        mElements.push_back( iContainer );
+        mContainers.push_back( iContainer );
+        mLeaves.push_back( iContainer );
+    }
+}
+
+void BenchScene::CreateConnections()
+{
+    AddGrid( mPrimaryLayer,
+             mParams.mSize,
+             gxRect( 0, 0, SceneWidth, SceneHeight ) );
+
+    std::vector<gxRectAnchor*> iAnchors;
+    iAnchors.reserve( mLeaves.size() );
+
+    for ( size_t i = 0; i < mLeaves.size(); ++i )
+    {
+        gxRectAnchor *iAnchor = new gxRectAnchor();
+        mLeaves[i]->Add( iAnchor );
+        iAnchors.push_back( iAnchor );
+
+        mElements.push_back( iAnchor );
+    }
+
+    if ( iAnchors.size() < 2 )
+        return;
+
+    for ( int i = 0; i < mParams.mConnections; ++i )
+    {
+        size_t iSource      = Random() % iAnchors.size();
+        size_t iDestination = ( iSource + 1 + Random() % ( iAnchors.size() - 1 ) ) % iAnchors.size();
+
+        gxLineConnection *iConnection = new gxLineConnection();
+        iConnection->SetSourceAnchor( iAnchors[iSource] );
+        iConnection->SetDestinationAnchor( iAnchors[iDestination] );
+        mConnectionLayer->Add( iConnection );
+
+        mElements.push_back( iConnection );
+    }
+}
+
+void BenchScene::CreateStack()
+{
+    // Four stacks side by side, the rectangles being in their innermost level
+    const int iStacks = 4;
+    int iLevels = std::max( mParams.mLevels, 1 );
+    gxPix iSide = SceneWidth / 2;
+
+    for ( int i = 0; i < iStacks; ++i )
+    {
+        gxViewElement *iParent = mPrimaryLayer;
+        gxRect iBounds( ( i % 2 ) * iSide, ( i / 2 ) * iSide, iSide - 10, iSide - 10 );
+
+        for ( int j = 0; j < iLevels; ++j )
+        {
+            iParent = AddStackLevel( iParent, iBounds );
+            iBounds = gxRect( 5, 5, iBounds.width - 10, iBounds.height - 10 );
+        }
+
+        AddGrid( iParent,
+                 mParams.mSize / iStacks,
+                 gxRect( 0, 0, iBounds.width, iBounds.height ) );
+    }
+}
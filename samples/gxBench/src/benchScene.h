@@ -0,0 +1,192 @@
+#ifndef benchScene_h
+#define benchScene_h
+
+#include "View/gxLightweightControl.h"
+#include "View/gxLightweightSystem.h"
+#include "View/Elements/Visual/shapes/gxRectangle.h"
+#include "View/Managers/gxZoomManager.h"
+#include "View/Managers/gxScrollManager.h"
+#include "View/Elements/Structural/Layers/gxLayer.h"
+
+#include <vector>
+
+/**
+ * @brief The kinds of synthetic scenes.
+ */
+class SceneKind
+{
+public:
+    enum Type
+    {
+        Flat,        // A single layer of rectangles
+        Deep,        // Chains of nested rectangles
+        Box,         // Containers laid out by box layouts
+        Border,      // Containers laid out by border layouts
+        Connections, // Anchored rectangles joined by line connections
+        Stack,       // Rectangles inside nested scroller/scaler stacks
+        Count
+    };
+
+    static const char* GetName( Type aKind );
+};
+
+/**
+ * @brief The parameters scenes are generated with.
+ */
+struct SceneParams
+{
+    SceneParams();
+
+    // The number of rectangles (the figures, for connection scenes)
+    int mSize;
+
+    // The nesting depth of deep scenes
+    int mDepth;
+
+    // The number of scroller/scaler levels of stack scenes
+    int mLevels;
+
+    // The number of connections of connection scenes
+    int mConnections;
+};
+
+/**
+ * @brief The document at the top of a scene, exposing validation so it can
+ * be measured apart from painting.
+ */
+class BenchDocument: public gxRectangle
+{
+public:
+    BenchDocument( const gxRect &aBounds ): gxRectangle( aBounds ) {}
+
+    /**
+     * @brief Validates the document and all its descendants.
+     */
+    void ValidateAll() { Validate(); }
+};
+
+/**
+ * @brief A synthetic scene shown on a headless control.
+ *
+ * Like gxDraw, the document holds a scroller and a scaler over a primary and
+ * a connection layer; the scene elements are generated into these.
+ */
+class BenchScene
+{
+public:
+    BenchScene( SceneKind::Type aKind, const SceneParams &aParams );
+    ~BenchScene();
+
+    SceneKind::Type GetKind() const { return mKind; }
+
+    /**
+     * @brief Returns the number of view elements in the scene.
+     */
+    int GetElementCount() const { return (int)mElements.size(); }
+
+    /**
+     * @brief Whether the scene has laid out containers.
+     */
+    bool HasLayouts() const { return !mContainers.empty(); }
+
+    /**
+     * @brief Runs frames until nothing is left to validate or paint.
+     */
+    void Settle();
+
+    /**
+     * @brief Repaints the whole control.
+     */
+    void Paint();
+
+    /**
+     * @brief Invalidates every element of the scene.
+     */
+    void InvalidateAll();
+
+    /**
+     * @brief Validates every invalid element of the scene.
+     */
+    void Validate();
+
+    /**
+     * @brief Moves a leaf rectangle (a different one on each iteration).
+     */
+    void MoveLeaf( int aIteration );
+
+    /**
+     * @brief Resizes a laid out container (a different one on each
+     * iteration).
+     */
+    void ResizeContainer( int aIteration );
+
+    /**
+     * @brief Returns the deepest, topmost element under a point (in control
+     * coordinates), or NULL if none.
+     */
+    gxViewElement* HitTest( const gxPoint &aPoint );
+
+    /**
+     * @brief Returns a pseudo random point within the control.
+     */
+    gxPoint GetRandomPoint();
+
+    gxLightweightControl& GetControl() { return mControl; }
+    gxZoomManager* GetZoomManager() { return mZoomManagers.front(); }
+
+private:
+    SceneKind::Type mKind;
+    SceneParams     mParams;
+
+    gxLightweightControl mControl;
+    gxLightweightSystem *mLightweightSystem;
+    BenchDocument       *mDocument;
+
+    gxLayer *mPrimaryLayer;
+    gxLayer *mConnectionLayer;
+
+    // Owned by the scene, the first ones being the document's
+    std::vector<gxZoomManager*>   mZoomManagers;
+    std::vector<gxScrollManager*> mScrollManagers;
+
+    // All the generated elements, the rectangles that can be moved and the
+    // laid out containers
+    std::vector<gxViewElement*> mElements;
+    std::vector<gxViewElement*> mLeaves;
+    std::vector<gxViewElement*> mContainers;
+
+    // The state of the pseudo random generator
+    unsigned mSeed;
+
+    unsigned Random();
+
+    gxViewElement* HitTest( gxViewElement *aElement,
+                            const gxPoint &aPoint );
+
+    /**
+     * @brief Adds a scroller with a scaler in it to a parent, returning the
+     * scaler.
+     */
+    gxViewElement* AddStackLevel( gxViewElement *aParent,
+                                  const gxRect  &aBounds );
+
+    /**
+     * @brief Adds a grid of rectangles to a parent.
+     *
+     * @param aParent The parent.
+     * @param aCount The number of rectangles.
+     * @param aArea The area (in the parent coordinates) to spread them over.
+     */
+    void AddGrid( gxViewElement *aParent,
+                  int            aCount,
+                  const gxRect  &aArea );
+
+    void CreateFlat();
+    void CreateDeep();
+    void CreateBox();
+    void CreateBorder();
+    void CreateConnections();
+    void CreateStack();
+};
+
+#endif //benchScene_h
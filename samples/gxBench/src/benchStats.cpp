@@ -0,0 +1,124 @@
+#include "benchStats.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    // The benchmark is single threaded, so plain counters will do
+    unsigned long sAllocations = 0;
+    unsigned long sBytes       = 0;
+
+    long long Now()
+    {
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>( steady_clock::now().time_since_epoch() ).count();
+    }
+}
+
+void* operator new( std::size_t aSize )
+{
+    ++sAllocations;
+    sBytes += aSize;
+
+    void *iMemory = std::malloc( aSize ? aSize : 1 );
+    if ( !iMemory )
+        throw std::bad_alloc();
+
+    return iMemory;
+}
+
+void* operator new[]( std::size_t aSize )
+{
+    return operator new( aSize );
+}
+
+void operator delete( void *aMemory ) noexcept
+{
+    std::free( aMemory );
+}
+
+void operator delete[]( void *aMemory ) noexcept
+{
+    std::free( aMemory );
+}
+
+unsigned long GetAllocationCount()
+{
+    return sAllocations;
+}
+
+unsigned long GetAllocatedBytes()
+{
+    return sBytes;
+}
+
+BenchStats::BenchStats()
+  : mSorted           ( true ),
+    mAllocations      ( 0 ),
+    mBytes            ( 0 ),
+    mStartTime        ( 0 ),
+    mStartAllocations ( 0 ),
+    mStartBytes       ( 0 )
+{
+}
+
+void BenchStats::Start()
+{
+    mStartAllocations = sAllocations;
+    mStartBytes       = sBytes;
+    mStartTime        = Now();
+}
+
+void BenchStats::Stop()
+{
+    long long iEnd = Now();
+
+    mAllocations += sAllocations - mStartAllocations;
+    mBytes       += sBytes - mStartBytes;
+
+    // Recording may itself allocate, so it's done after taking the counts
+    mLatencies.push_back( ( iEnd - mStartTime ) / 1000.0 );
+    mSorted = false;
+}
+
+double BenchStats::GetPercentile( double aPercent )
+{
+    if ( mLatencies.empty() )
+        return 0;
+
+    Sort();
+
+    // Nearest rank
+    size_t iRank = (size_t)std::ceil( aPercent / 100 * mLatencies.size() );
+    iRank = std::min( std::max( iRank, (size_t)1 ), mLatencies.size() );
+
+    return mLatencies[iRank - 1];
+}
+
+double BenchStats::GetMax()
+{
+    return GetPercentile( 100 );
+}
+
+double BenchStats::GetAllocationsPerOp() const
+{
+    return mLatencies.empty() ? 0 : (double)mAllocations / mLatencies.size();
+}
+
+double BenchStats::GetBytesPerOp() const
+{
+    return mLatencies.empty() ? 0 : (double)mBytes / mLatencies.size();
+}
+
+void BenchStats::Sort()
+{
+    if ( !mSorted )
+    {
+        std::sort( mLatencies.begin(), mLatencies.end() );
+        mSorted = true;
+    }
+}
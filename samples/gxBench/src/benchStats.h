@@ -0,0 +1,74 @@
+#ifndef benchStats_h
+#define benchStats_h
+
+#include <vector>
+
+/**
+ * @brief Returns the number of heap allocations made so far (counted by the
+ * global operator new).
+ */
+unsigned long GetAllocationCount();
+
+/**
+ * @brief Returns the number of bytes allocated on the heap so far.
+ */
+unsigned long GetAllocatedBytes();
+
+/**
+ * @brief Measures the repetitions of an operation.
+ *
+ * Call Start() before and Stop() after each repetition; the latency and the
+ * allocations made in between are recorded.
+ */
+class BenchStats
+{
+public:
+    BenchStats();
+
+    void Start();
+    void Stop();
+
+    /**
+     * @brief Returns the number of recorded repetitions.
+     */
+    int GetCount() const { return (int)mLatencies.size(); }
+
+    /**
+     * @brief Returns a latency percentile, in microseconds.
+     *
+     * @param aPercent The percentile, from 0 to 100.
+     */
+    double GetPercentile( double aPercent );
+
+    /**
+     * @brief Returns the highest latency, in microseconds.
+     */
+    double GetMax();
+
+    /**
+     * @brief Returns the average number of allocations per repetition.
+     */
+    double GetAllocationsPerOp() const;
+
+    /**
+     * @brief Returns the average number of bytes allocated per repetition.
+     */
+    double GetBytesPerOp() const;
+
+private:
+    // The latencies, in microseconds
+    std::vector<double> mLatencies;
+    bool                mSorted;
+
+    unsigned long mAllocations;
+    unsigned long mBytes;
+
+    // The state when the current repetition started
+    long long     mStartTime;
+    unsigned long mStartAllocations;
+    unsigned long mStartBytes;
+
+    void Sort();
+};
+
+#endif //benchStats_h
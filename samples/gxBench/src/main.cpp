@@ -0,0 +1,232 @@
+#include "benchScene.h"
+#include "benchStats.h"
+
+#include "core/gxTrace.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    void PrintUsage()
+    {
+        std::printf( "usage: gxBench [options] [scene ...]\n"
+                     "\n"
+                     "scenes: flat deep box border connections stack (all by default)\n"
+                     "\n"
+                     "options:\n"
+                     "  -n <count>  rectangles per scene (1000)\n"
+                     "  -d <depth>  nesting depth of deep scenes (32)\n"
+                     "  -l <count>  scroller/scaler levels of stack scenes (4)\n"
+                     "  -c <count>  connections of connection scenes (1000)\n"
+                     "  -i <count>  repetitions of each operation (200)\n"
+                     "  -t <file>   writes a Chrome trace (if built with GX_TRACE)\n" );
+    }
+
+    void PrintHeader()
+    {
+        std::printf( "%-12s %8s  %-20s %10s %10s %10s %10s %10s %12s\n",
+                     "scene", "elements", "operation",
+                     "p50 us", "p90 us", "p99 us", "max us",
+                     "allocs/op", "bytes/op" );
+    }
+
+    void PrintStats( BenchScene &aScene, const char *aOperation, BenchStats &aStats )
+    {
+        std::printf( "%-12s %8d  %-20s %10.1f %10.1f %10.1f %10.1f %10.1f %12.0f\n",
+                     SceneKind::GetName( aScene.GetKind() ),
+                     aScene.GetElementCount(),
+                     aOperation,
+                     aStats.GetPercentile( 50 ),
+                     aStats.GetPercentile( 90 ),
+                     aStats.GetPercentile( 99 ),
+                     aStats.GetMax(),
+                     aStats.GetAllocationsPerOp(),
+                     aStats.GetBytesPerOp() );
+    }
+
+    /**
+     * @brief Measures every operation on a scene.
+     */
+    void RunScene( SceneKind::Type aKind, const SceneParams &aParams, int aIterations )
+    {
+        BenchScene iScene( aKind, aParams );
+
+        // Painting everything, through the headless painter
+        {
+            BenchStats iStats;
+            for ( int i = 0; i < aIterations; ++i )
+            {
+                iStats.Start();
+                iScene.Paint();
+                iStats.Stop();
+            }
+            PrintStats( iScene, "paint", iStats );
+        }
+
+        // Validating everything
+        {
+            BenchStats iStats;
+            for ( int i = 0; i < aIterations; ++i )
+            {
+                iScene.InvalidateAll();
+
+                iStats.Start();
+                iScene.Validate();
+                iStats.Stop();
+
+                iScene.Settle();
+            }
+            PrintStats( iScene, "validate full", iStats );
+        }
+
+        // Validating after a single element moved
+        {
+            BenchStats iStats;
+            for ( int i = 0; i < aIterations; ++i )
+            {
+                iStats.Start();
+                iScene.MoveLeaf( i );
+                iScene.Validate();
+                iStats.Stop();
+
+                iScene.Settle();
+            }
+            PrintStats( iScene, "validate incremental", iStats );
+        }
+
+        // Laying out after a container got resized
+        if ( iScene.HasLayouts() )
+        {
+            BenchStats iStats;
+            for ( int i = 0; i < aIterations; ++i )
+            {
+                iStats.Start();
+                iScene.ResizeContainer( i );
+                iScene.Validate();
+                iStats.Stop();
+
+                iScene.Settle();
+            }
+            PrintStats( iScene, "layout", iStats );
+        }
+
+        // Finding the element under a point
+        {
+            BenchStats iStats;
+            for ( int i = 0; i < aIterations; ++i )
+            {
+                gxPoint iPoint = iScene.GetRandomPoint();
+
+                iStats.Start();
+                iScene.HitTest( iPoint );
+                iStats.Stop();
+            }
+            PrintStats( iScene, "hit-test", iStats );
+        }
+
+        // Zooming in and out, up to the repainted frame
+        {
+            BenchStats iStats;
+            for ( int i = 0; i < aIterations; ++i )
+            {
+                iStats.Start();
+                iScene.GetZoomManager()->MultiplyZoom( ( i % 2 ) ? 0.8f : 1.25f );
+                iScene.Settle();
+                iStats.Stop();
+            }
+            PrintStats( iScene, "zoom", iStats );
+        }
+
+        // Scrolling back and forth, up to the repainted frame
+        {
+            BenchStats iStats;
+            for ( int i = 0; i < aIterations; ++i )
+            {
+                gxPix iPosition = ( i % 2 ) ? 0 : 50;
+
+                iStats.Start();
+                iScene.GetControl().Scroll( true, iPosition );
+                iScene.Settle();
+                iStats.Stop();
+            }
+            PrintStats( iScene, "scroll", iStats );
+        }
+    }
+}
+
+int main( int argc, char **argv )
+{
+    SceneParams iParams;
+    int iIterations = 200;
+    bool iSelected[ SceneKind::Count ] = { false };
+    bool iAny = false;
+    const char *iTracePath = NULL;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        const char *iArg = argv[i];
+
+        if ( !std::strcmp( iArg, "-t" ) && i + 1 < argc )
+        {
+            iTracePath = argv[++i];
+            continue;
+        }
+
+        if ( iArg[0] == '-' && i + 1 < argc )
+        {
+            int iValue = std::atoi( argv[++i] );
+
+            if      ( !std::strcmp( iArg, "-n" ) ) iParams.mSize        = iValue;
+            else if ( !std::strcmp( iArg, "-d" ) ) iParams.mDepth       = iValue;
+            else if ( !std::strcmp( iArg, "-l" ) ) iParams.mLevels      = iValue;
+            else if ( !std::strcmp( iArg, "-c" ) ) iParams.mConnections = iValue;
+            else if ( !std::strcmp( iArg, "-i" ) ) iIterations          = iValue;
+            else
+            {
+                PrintUsage();
+                return 1;
+            }
+            continue;
+        }
+
+        int iKind = 0;
+        while ( iKind < SceneKind::Count &&
+                std::strcmp( iArg, SceneKind::GetName( (SceneKind::Type)iKind ) ) )
+            ++iKind;
+
+        if ( iKind == SceneKind::Count )
+        {
+            PrintUsage();
+            return 1;
+        }
+
+        iSelected[iKind] = true;
+        iAny = true;
+    }
+
+    PrintHeader();
+
+    if ( iTracePath )
+        gxTrace::Start();
+
+    for ( int i = 0; i < SceneKind::Count; ++i )
+    {
+        if ( !iAny || iSelected[i] )
+            RunScene( (SceneKind::Type)i, iParams, iIterations );
+    }
+
+    if ( iTracePath )
+    {
+        gxTrace::Stop();
+
+        if ( !gxTrace::Write( iTracePath ) )
+        {
+            std::printf( "couldn't write %s\n", iTracePath );
+            return 1;
+        }
+    }
+
+    return 0;
+}
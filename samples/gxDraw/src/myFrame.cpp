@@ -235,16 +235,25 @@ void MyFrame::CreateToolbarLayout()
 
 void MyFrame::CreateOrgLayout()
 {
-    mEssay = new gxRectangle( gxRect( 10, 300, 50, 50 ) );
-    mEssay->SetClipChildren( false );
+    mOrgChart = new gxRectangle( gxRect( 10, 250, 200, 150 ) );
+    mOrgChart->SetClipChildren( false );
     
-    mIntro      = new gxRectangle( gxRect( 80, -50, 30, 30 ) );
-    mMainText   = new gxRectangle( gxRect( 100, 0, 30, 30 ) );
-    mConclusion = new gxRectangle( gxRect( 120, 50, 30, 30 ) );
+    // Levels go left to right, siblings top to bottom
+    mTreeLayout = new gxTreeLayout( 10, 30, false );
+    mOrgChart->SetLayout( mTreeLayout );
     
-    mEssay->Add( mIntro, mMainText, mConclusion );
+    mEssay      = new gxRectangle( gxRect( 0, 0, 50, 50 ) );
+    mIntro      = new gxRectangle( gxRect( 0, 0, 30, 30 ) );
+    mMainText   = new gxRectangle( gxRect( 0, 0, 30, 30 ) );
+    mConclusion = new gxRectangle( gxRect( 0, 0, 30, 30 ) );
     
-    mPrimaryLayer->Add( mEssay );
+    mOrgChart->Add( mEssay, mIntro, mMainText, mConclusion );
+    
+    mTreeLayout->SetConstraint( mIntro,      new gxTreeParentConstraint( mEssay ) );
+    mTreeLayout->SetConstraint( mMainText,   new gxTreeParentConstraint( mEssay ) );
+    mTreeLayout->SetConstraint( mConclusion, new gxTreeParentConstraint( mEssay ) );
+    
+    mPrimaryLayer->Add( mOrgChart );
 }
 
 void MyFrame::Initialize()
@@ -18,6 +18,7 @@
 #include "View/Layouts/gxBoxLayout.h"
 #include "View/Layouts/gxBorderLayout.h"
 #include "View/Layouts/gxToolbarLayout.h"
+#include "View/Layouts/gxTreeLayout.h"
 
 #include "core/gxComposite.h"
 
@@ -51,7 +52,8 @@ private:
     gxBorderLayout *mBorderLayout;    
     gxRectangle *mContainer, *mCenter, *mNorth, *mSouth, *mWest, *mEast;
     
-    gxRectangle *mEssay, *mIntro, *mMainText, *mConclusion;
+    gxTreeLayout *mTreeLayout;
+    gxRectangle  *mOrgChart, *mEssay, *mIntro, *mMainText, *mConclusion;
     
     gxToolbarLayout *mToolbarLayout;
     
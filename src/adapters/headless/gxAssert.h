@@ -0,0 +1,17 @@
+#ifndef gxAssert_headless_h
+#define gxAssert_headless_h
+
+// Failed assertions are reported rather than fatal, as with wxWidgets.
+#if defined(__cplusplus) && !defined(NDEBUG)
+    #include <cstdio>
+    #define gxReport( aMsg )        ( void )fprintf( stderr, "%s(%d): %s\n", __FILE__, __LINE__, aMsg )
+    #define gxAssert( aCond, aMsg ) ( ( aCond ) ? ( void )0 : gxReport( aMsg ) )
+    #define gxWarnIf( aCond, aMsg ) ( ( aCond ) ? gxReport( aMsg ) : ( void )0 )
+    #define gxWarn( aMsg )          gxReport( aMsg )
+#else
+    #define gxAssert( aCond, aMsg )
+    #define gxWarnIf( aCond, aMsg )
+    #define gxWarn( aMsg )
+#endif
+  
+#endif // gxAssert_headless_h
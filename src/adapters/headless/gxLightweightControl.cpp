@@ -0,0 +1,115 @@
+#include "core/gxPaintDC.h"
+#include "core/geometry/gxRectBatch.h"
+#include "gxLightweightControl.h"
+
+gxLightweightControl::gxLightweightControl(const gxRect& aBounds)
+  : mLightweightSystem(NULL),
+    mBounds(aBounds),
+    mFrameQueued(false),
+    mThreadFrameQueued(false),
+    mPrimitiveCount(0)
+{
+}
+
+gxLightweightControl::~gxLightweightControl()
+{
+  UnsetLightweightSystem();
+}
+
+void gxLightweightControl::SetLightweightSystem(gxLightweightSystem* aLightweightSystem)
+{
+  mLightweightSystem = aLightweightSystem;
+}
+
+void gxLightweightControl::UnsetLightweightSystem()
+{
+  mLightweightSystem = NULL;
+}
+
+gxRect gxLightweightControl::GetBounds() const
+{
+  return mBounds;
+}
+
+void gxLightweightControl::SetBounds(const gxRect& aBounds)
+{
+  mBounds = aBounds;
+}
+
+gxSize gxLightweightControl::GetTextSize(gxString &aText)
+{
+  return gxPaintDC::MeasureText(aText);
+}
+
+void gxLightweightControl::QueueFrame()
+{
+  mFrameQueued = true;
+}
+
+void gxLightweightControl::QueueFrameFromThread()
+{
+  mThreadFrameQueued = true;
+}
+
+bool gxLightweightControl::RunFrame()
+{
+  // Take both requests, as one frame serves them both.
+  bool threadFrameQueued = mThreadFrameQueued.exchange(false);
+
+  if (!mFrameQueued && !threadFrameQueued)
+    return false;
+
+  mFrameQueued = false;
+
+  if (mLightweightSystem)
+    mLightweightSystem->OnFrame();
+
+  return true;
+}
+
+int gxLightweightControl::RunFrames(int aMaxFrames)
+{
+  int frames = 0;
+
+  while (frames < aMaxFrames && RunFrame())
+    ++frames;
+
+  return frames;
+}
+
+void gxLightweightControl::Scroll(bool isVertical, gxPix aPosition)
+{
+  if (mLightweightSystem)
+    mLightweightSystem->OnScroll(isVertical, aPosition);
+}
+
+void gxLightweightControl::RefreshRect(const gxRect& aRect, bool eraseBackground)
+{
+  gxRect rect(aRect);
+  rect.Intersect(gxRect(0, 0, mBounds.width, mBounds.height));
+
+  if (!rect.IsEmpty())
+    mDamagedRects.push_back(rect);
+}
+
+void gxLightweightControl::Update()
+{
+  if (mDamagedRects.empty())
+    return;
+
+  gxPaintDC dc(gxRect(0, 0, mBounds.width, mBounds.height));
+
+  // What will be the clip region - a union between all damaged regions.
+  gxRect clipRect;
+  gxRectBatch(mDamagedRects).Union(clipRect);
+
+  dc.DestroyClippingRegion();
+  dc.SetClippingRegion(clipRect);
+
+  // Delegate paint duties to the lightweight system.
+  if (mLightweightSystem)
+    mLightweightSystem->Paint(&dc, mDamagedRects);
+
+  mPrimitiveCount += dc.GetPrimitiveCount();
+  mDamagedRects.clear();
+}
@@ -0,0 +1,75 @@
+#ifndef gxLightweightControl_headless_h
+#define gxLightweightControl_headless_h
+
+#include <atomic>
+#include "View/gxLightweightSystem.h"
+#include "core/gxTextCache.h"
+
+/**
+  * @brief A control without a window, with which the lightweight system runs
+  * headless (on servers, or in benchmarks).
+  *
+  * There's no event loop, so the application runs the frames queued by the
+  * lightweight system (see RunFrame()). Painting goes to a headless
+  * gxPaintDC, which draws nothing.
+ */
+class gxLightweightControl
+{
+public: 
+  gxLightweightControl(const gxRect& aBounds = gxRect(0, 0, 800, 600));
+
+  ~gxLightweightControl();
+
+  void SetLightweightSystem(gxLightweightSystem* aLightweightSystem);
+  void UnsetLightweightSystem();
+
+  gxRect GetBounds() const;
+  void SetBounds(const gxRect& aBounds);
+
+  gxSize GetTextSize(gxString &aText);
+
+  // There's a single font, with the fixed text metrics.
+  gxFontId GetFontId() const { return 0; }
+
+  // Marks a frame as queued, for the next RunFrame().
+  void QueueFrame();
+
+  // Queues a frame from another thread.
+  void QueueFrameFromThread();
+
+  // Runs the queued frame, if any. Returns whether there was one.
+  bool RunFrame();
+
+  // Runs frames for as long as they're queued (up to aMaxFrames). Returns
+  // the number of frames run.
+  int RunFrames(int aMaxFrames = 1000);
+
+  // Forwards a scroll (as scroll bars would) to the lightweight system.
+  void Scroll(bool isVertical, gxPix aPosition);
+
+  // There are no scroll bars.
+  void UpdateScrollbars(const gxScroll* aScroll) {}
+
+  void RefreshRect(const gxRect& aRect, bool eraseBackground = true);
+
+  // Paints the damaged regions now.
+  void Update();
+
+  // Returns the number of primitives painted so far.
+  unsigned long GetPrimitiveCount() const { return mPrimitiveCount; }
+
+protected:
+  gxLightweightSystem* mLightweightSystem;
+
+  gxRect mBounds;
+
+  // The regions to paint with the next update.
+  gxRects mDamagedRects;
+
+  bool mFrameQueued;
+  std::atomic<bool> mThreadFrameQueued;
+
+  unsigned long mPrimitiveCount;
+};
+
+#endif // gxLightweightControl_headless_h
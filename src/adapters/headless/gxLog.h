@@ -0,0 +1,18 @@
+#ifndef gxLog_headless_h
+#define gxLog_headless_h
+
+#if defined(__cplusplus) && !defined(NDEBUG)
+    #include <cstdio>
+    #include "core/geometry/gxGeometry.h"
+    inline void gxLogRect(const wchar_t* msg, gxRect rect)
+    {
+        fwprintf(stderr, L"%ls: %i, %i, %i, %i\n", msg, rect.GetX(), rect.GetY(), rect.GetWidth(), rect.GetHeight());
+    }
+
+    #define gxLog( aMsg ) fprintf( stderr, "%s\n", aMsg )
+#else
+    #define gxLogRect( aMsg, aRect )
+    #define gxLog( aMsg )
+#endif
+  
+#endif // gxLog_headless_h
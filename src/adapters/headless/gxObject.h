@@ -0,0 +1,16 @@
+#ifndef gxObject_headless_h
+#define gxObject_headless_h
+
+/**
+ * @brief The root class for all Gefri classes.
+ *
+ * Unlike wxObject, it carries no run-time class information or reference
+ * counted data - only a virtual destructor.
+ */
+class gxObject
+{
+public:
+  virtual ~gxObject() {}
+};
+
+#endif // gxObject_headless_h
@@ -0,0 +1,77 @@
+#ifndef gxPaintDC_headless_h
+#define gxPaintDC_headless_h
+
+#include "core/geometry/gxGeometry.h"
+#include "core/gxString.h"
+#include "core/gxTextCache.h"
+#include "core/gxStrip.h"
+
+/**
+ * @brief A DC that paints nothing, for running the view without a GUI (on
+ * servers, or in benchmarks).
+ *
+ * It keeps the clipping region as a real DC would, counts the primitives
+ * drawn, and measures text with fixed metrics.
+ */
+class gxPaintDC
+{
+public:
+  // The size of a character with the fixed text metrics.
+  static const gxPix CharWidth  = 7;
+  static const gxPix CharHeight = 14;
+
+  gxPaintDC(const gxRect& aBounds)
+    : mBounds(aBounds),
+      mClip(aBounds),
+      mPrimitiveCount(0) {}
+
+  gxRect GetClippingBox() const { return mClip; }
+
+  // As with wx, clipping regions intersect the current one.
+  void SetClippingRegion(const gxRect& rect) { mClip.Intersect(rect); }
+  void DestroyClippingRegion() { mClip = mBounds; }
+
+  void DrawRectangle(gxPix aX, gxPix aY, gxPix width, gxPix height)
+        { ++mPrimitiveCount; }
+  void DrawRectangle(const gxPoint& aPoint, const gxSize& aSize)
+        { ++mPrimitiveCount; }
+  void DrawRectangle(const gxRect& rect)
+        { ++mPrimitiveCount; }
+
+  void DrawLine(gxPix x1, gxPix y1, gxPix x2, gxPix y2)
+        { ++mPrimitiveCount; }
+
+  void DrawText(const gxString& text, gxPix x, gxPix y)
+        { ++mPrimitiveCount; }
+  void DrawRotatedText(const gxString& text, gxPix x, gxPix y, double angle)
+        { ++mPrimitiveCount; }
+  void DrawLabel(const gxString& aText, gxPix aX, gxPix aY, bool isHorizontal)
+        { ++mPrimitiveCount; }
+
+  // There are no pixels to keep, so strips are only counted as blitted.
+  bool BeginStrip(gxStripId id, const gxRect& rect, const gxPoint& shift, const gxRect& exposed)
+        { return true; }
+  void EndStrip()
+        { ++mPrimitiveCount; }
+  static void ReleaseStrip(gxStripId id) {}
+
+  gxSize GetTextSize(const gxString& aText) const { return MeasureText(aText); }
+
+  // There's a single font, with the fixed text metrics.
+  gxFontId GetFontId() const { return 0; }
+
+  static gxSize MeasureText(const gxString& aText)
+  {
+    return gxSize(gxPix(aText.length()) * CharWidth, CharHeight);
+  }
+
+  // Returns the number of primitives drawn, clipped or not.
+  unsigned long GetPrimitiveCount() const { return mPrimitiveCount; }
+
+private:
+  gxRect mBounds;
+  gxRect mClip;
+  unsigned long mPrimitiveCount;
+};
+
+#endif // gxPaintDC_headless_h
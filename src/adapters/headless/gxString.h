@@ -0,0 +1,51 @@
+#ifndef gxString_headless_h
+#define gxString_headless_h
+
+#include <cstdarg>
+#include <cwchar>
+#include <string>
+#include <vector>
+
+// Wide literals, as with wxWidgets.
+#ifndef _T
+  #define _T( aText ) L ## aText
+#endif
+
+/**
+ * @brief A wide string, with the wxString methods Gefri uses.
+ */
+class gxString: public std::wstring
+{
+public:
+  gxString() {}
+  gxString(const wchar_t* aText)
+    : std::wstring(aText) {}
+  gxString(const std::wstring& aText)
+    : std::wstring(aText) {}
+
+  static gxString Format(const wchar_t* aFormat, ...)
+  {
+    std::vector<wchar_t> buffer(64);
+
+    // vswprintf fails if the buffer is too small, so grow it until it isn't.
+    while (buffer.size() <= MaxFormatLength)
+    {
+      va_list args;
+      va_start(args, aFormat);
+      int length = vswprintf(&buffer[0], buffer.size(), aFormat, args);
+      va_end(args);
+
+      if (length >= 0)
+        return gxString(&buffer[0]);
+
+      buffer.resize(buffer.size() * 2);
+    }
+
+    return gxString();
+  }
+
+private:
+  static const size_t MaxFormatLength = 65536;
+};
+
+#endif // gxString_headless_h
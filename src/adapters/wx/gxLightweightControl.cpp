@@ -7,12 +7,18 @@
     #include "wx/wx.h"
 #endif
 
+#include "wx/display.h"
+
 #include "core/gxPaintDC.h"
+#include "core/geometry/gxRectBatch.h"
 #include "gxLightweightControl.h"
 
+// The frame interval used if the display refresh rate is unknown (60Hz).
+static const long DefaultFrameInterval = 16;
+
 IMPLEMENT_DYNAMIC_CLASS(gxLightweightControl, wxControl)
 
-DEFINE_EVENT_TYPE(wxEVT_VALIDATION_REQUEST)
+DEFINE_EVENT_TYPE(wxEVT_FRAME_REQUEST)
 
 BEGIN_EVENT_TABLE(gxLightweightControl, wxControl)
   EVT_PAINT(gxLightweightControl::OnPaint)
@@ -20,12 +26,17 @@ BEGIN_EVENT_TABLE(gxLightweightControl, wxControl)
   EVT_LEFT_DOWN(gxLightweightControl::OnLeftMouseBtnDown)
   EVT_SCROLLWIN(gxLightweightControl::OnScroll)
 
-  EVT_CUSTOM(wxEVT_VALIDATION_REQUEST, wxID_ANY, gxLightweightControl::OnValidationRequest)
+  EVT_TIMER(wxID_ANY, gxLightweightControl::OnFrameTimer)
+
+  EVT_CUSTOM(wxEVT_FRAME_REQUEST, wxID_ANY, gxLightweightControl::OnFrameRequest)
 END_EVENT_TABLE()
 
 void gxLightweightControl::Init()
 {
   mLightweightSystem = NULL;
+  mFrameInterval = 0;
+  mFrameTimer.SetOwner(this);
+  mFontId = gxTextCache::Hash(gxString());
 
   // For wxAutoBufferedPaintDC to work
   SetBackgroundStyle(wxBG_STYLE_CUSTOM);
@@ -37,6 +48,7 @@ void gxLightweightControl::Init()
 
 gxLightweightControl::~gxLightweightControl()
 {
+  mFrameTimer.Stop();
   UnsetLightweightSystem();
 }
 
@@ -63,6 +75,19 @@ gxSize gxLightweightControl::GetTextSize(gxString &aText)
   return gxSize(w, h);
 }
 
+gxFontId gxLightweightControl::GetFontId() const
+{
+  wxFont font = GetFont();
+
+  if (!font.IsSameAs(mHashedFont))
+  {
+    mHashedFont = font;
+    mFontId = gxTextCache::Hash(mHashedFont.GetNativeFontInfoDesc());
+  }
+
+  return mFontId;
+}
+
 void gxLightweightControl::OnPaint(wxPaintEvent& WXUNUSED(event))
 {
   
@@ -78,16 +103,24 @@ void gxLightweightControl::OnPaint(wxPaintEvent& WXUNUSED(event))
   {
     wxRect rect = upd.GetRect();
     gxRect damagedRect(rect.x, rect.y, rect.width, rect.height);
-    // Union the damaged recangle with the clip region
-    clipRect.Union(damagedRect);
     damagedRects.push_back(damagedRect);
     upd ++ ;
   }
+
+  // Union the damaged recangles into the clip region
+  gxRectBatch(damagedRects).Union(clipRect);
   
   // Set an absolute clip area (to the union between all damaged areas).
   dc.DestroyClippingRegion();
   dc.SetClippingRegion(clipRect);
 
+  // Find what opaque view elements cover first, so the background under
+  // them can be left out.
+  if (mLightweightSystem)
+  {
+    mLightweightSystem->Occlude(damagedRects);
+  }
+
   // Temporal: Draw chess board
   dc.SetPen(wxPen(*wxTRANSPARENT_PEN));
   wxSize size = GetSize();
@@ -96,6 +129,10 @@ void gxLightweightControl::OnPaint(wxPaintEvent& WXUNUSED(event))
   {
     for (int y = 0; y <= (int)(size.GetHeight() / boxSize); y++)
     {
+      gxRect box(x * boxSize, y * boxSize, boxSize, boxSize);
+      if (mLightweightSystem && mLightweightSystem->IsOccluded(box))
+        continue;
+
       if ( (x + y) % 2 == 0)
         dc.SetBrush(wxBrush(wxColor(240,240,240)));
       else
@@ -143,16 +180,74 @@ void gxLightweightControl::OnScroll(wxScrollWinEvent& event)
   event.Skip();
 }
 
-void gxLightweightControl::QueueValidation()
+void gxLightweightControl::UpdateScrollbars(const gxScroll* aScroll)
+{
+  SetScrollbar(wxHORIZONTAL, aScroll->mPosition.X, aScroll->mVisible.X, aScroll->mRange.X);
+  SetScrollbar(wxVERTICAL,   aScroll->mPosition.Y, aScroll->mVisible.Y, aScroll->mRange.Y);
+}
+
+void gxLightweightControl::SetFrameInterval(long aInterval)
+{
+  mFrameInterval = aInterval;
+}
+
+long gxLightweightControl::GetFrameInterval()
+{
+  if (mFrameInterval > 0)
+    return mFrameInterval;
+
+  // Pace frames to the refresh rate of the display showing the control.
+  int display = wxDisplay::GetFromWindow(this);
+  if (display != wxNOT_FOUND)
+  {
+    int refresh = wxDisplay(display).GetCurrentMode().refresh;
+    if (refresh > 0)
+      return 1000 / refresh;
+  }
+
+  return DefaultFrameInterval;
+}
+
+void gxLightweightControl::QueueFrame()
 {
-  wxCommandEvent event( wxEVT_VALIDATION_REQUEST, GetId() );
+  long delay = GetFrameInterval() - mFrameWatch.Time();
+
+  // Frames queued soon after the last one wait for the rest of the interval;
+  // others are run once the current event is handled.
+  if (delay > 0)
+  {
+    mFrameTimer.Start(delay, wxTIMER_ONE_SHOT);
+  }
+  else
+  {
+    wxCommandEvent event( wxEVT_FRAME_REQUEST, GetId() );
+    event.SetEventObject( this );
+    GetEventHandler()->AddPendingEvent(event);
+  }
+}
+
+void gxLightweightControl::QueueFrameFromThread()
+{
+  // Adding pending events is thread safe.
+  wxCommandEvent event( wxEVT_FRAME_REQUEST, GetId() );
   event.SetEventObject( this );
   GetEventHandler()->AddPendingEvent(event);
 }
 
-void gxLightweightControl::OnValidationRequest(wxEvent& event)
+void gxLightweightControl::OnFrameRequest(wxEvent& event)
 {
-  if (mLightweightSystem)
-    mLightweightSystem->OnValidationRequest();
+  RunFrame();
 }
 
+void gxLightweightControl::OnFrameTimer(wxTimerEvent& event)
+{
+  RunFrame();
+}
+
+void gxLightweightControl::RunFrame()
+{
+  mFrameWatch.Start();
+
+  if (mLightweightSystem)
+    mLightweightSystem->OnFrame();
+}
@@ -2,11 +2,14 @@
 #define gxLightweightControl_wx_h
 
 #include <wx/control.h>
+#include <wx/timer.h>
+#include <wx/stopwatch.h>
 #include "View/gxLightweightSystem.h"
+#include "core/gxTextCache.h"
 
 static const long LightweightControlStyle = wxNO_BORDER;// | wxVSCROLL;// | wxALWAYS_SHOW_SB; //| wxNO_FULL_REPAINT_ON_RESIZE | wxTRANSPARENT_WINDOW; // , //0x00000020L, //| wxCLIP_SIBLINGS, //| 0x00000020L, //0x00000008L
 
-DECLARE_EVENT_TYPE(wxEVT_VALIDATION_REQUEST, -1)
+DECLARE_EVENT_TYPE(wxEVT_FRAME_REQUEST, -1)
 
 /**
   * @brief A system-depandent control with which the lightweight system
@@ -37,9 +40,25 @@ public:
   gxRect GetBounds() const;
   gxSize GetTextSize(gxString &aText);
 
-  // The lightweight system needs a way to queue validations on the event loop.
-  // This method does that.
-  void QueueValidation();
+  // Identifies the font text is measured with, for the text cache. As with
+  // gxPaintDC, the font is only hashed again once it changes.
+  gxFontId GetFontId() const;
+
+  // The lightweight system needs a way to queue frames on the event loop.
+  // This method does that, paced so frames are no closer than the frame
+  // interval.
+  void QueueFrame();
+
+  // Queues a frame from another thread. Unlike QueueFrame() it isn't paced,
+  // as the frame timer may only be used from the main thread.
+  void QueueFrameFromThread();
+
+  // Shows the scroll of the lightweight system on the scroll bars.
+  void UpdateScrollbars(const gxScroll* aScroll);
+
+  // Sets the minimum time between frames in milliseconds (0, the default,
+  // stands for the refresh interval of the display).
+  void SetFrameInterval(long aInterval);
 
   // Event Handlers
   void OnPaint(wxPaintEvent& event);
@@ -47,8 +66,9 @@ public:
   void OnLeftMouseBtnDown(wxMouseEvent& event); 
   void OnScroll(wxScrollWinEvent& event);
 
-  // A handler called when a validation request has been queued.
-  void OnValidationRequest(wxEvent& event);
+  // A handler called when a frame has been queued.
+  void OnFrameRequest(wxEvent& event);
+  void OnFrameTimer(wxTimerEvent& event);
 
   void RefreshRect(const gxRect& aRect, bool eraseBackground = true);
 
@@ -57,7 +77,24 @@ protected:
   // common part of all ctors
   void Init();
 
+  // Returns the minimum time between frames in milliseconds.
+  long GetFrameInterval();
+
+  // Runs a frame on the lightweight system.
+  void RunFrame();
+
   gxLightweightSystem* mLightweightSystem;
+
+  // Delays frames queued too soon after the last one.
+  wxTimer mFrameTimer;
+  // The time since the last frame.
+  wxStopWatch mFrameWatch;
+  long mFrameInterval;
+
+  // The font last hashed by GetFontId() (kept, so it's compared by
+  // reference), and its id.
+  mutable wxFont   mHashedFont;
+  mutable gxFontId mFontId;
 };
 
 #endif // gxLightweightControl_wx_h
\ No newline at end of file
@@ -0,0 +1,211 @@
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "wx/dcmemory.h"
+#include "wx/image.h"
+
+#include "core/gxPaintDC.h"
+#include "core/gxLabelAtlas.h"
+
+#include <stdlib.h>
+#include <unordered_map>
+
+// The bitmap labels are rendered into, white on black, so each pixel tells
+// how much of it the text covers. Selected into a memory DC, created with the
+// first label (once wx is initialised), and kept for the lifetime of the
+// application.
+static wxBitmap*     sAtlas = NULL;
+static wxMemoryDC*   sAtlasDC = NULL;
+static unsigned long sAtlasGeneration = 0;
+
+// The labels blitted, by place in the atlas and colour: bitmaps of their own,
+// in the colour with the coverage as alpha, so they blend in with no halo.
+// Made from the atlas once per label and colour, and dropped with it.
+typedef std::unordered_map<unsigned long long, wxBitmap> LabelMap;
+static LabelMap sLabels;
+
+// Returns the atlas DC, clearing the atlas (and the labels made from it) if
+// the label atlas started over.
+static wxMemoryDC* GetAtlasDC()
+{
+  gxLabelAtlas& atlas = gxLabelAtlas::Get();
+
+  if (!sAtlasDC)
+  {
+    sAtlas = new wxBitmap(atlas.GetSize(), atlas.GetSize());
+    sAtlasDC = new wxMemoryDC(*sAtlas);
+    sAtlasGeneration = atlas.GetGeneration() - 1;
+  }
+
+  if (sAtlasGeneration != atlas.GetGeneration())
+  {
+    sAtlasDC->SetBackground(*wxBLACK_BRUSH);
+    sAtlasDC->Clear();
+    sAtlasGeneration = atlas.GetGeneration();
+    sLabels.clear();
+  }
+
+  return sAtlasDC;
+}
+
+// Returns the bitmap of the label at rect in the atlas, in a colour.
+static const wxBitmap& GetLabel(const gxRect& rect, const wxColour& colour)
+{
+  unsigned long long key = ((unsigned long long)rect.X << 48) |
+                           ((unsigned long long)rect.Y << 32) |
+                           colour.GetRGB();
+
+  wxBitmap& label = sLabels[key];
+
+  if (label.IsOk())
+    return label;
+
+  // Copied out through a DC, as the atlas stays selected.
+  wxBitmap coverage(rect.width, rect.height);
+  {
+    wxMemoryDC coverageDC(coverage);
+    coverageDC.Blit(0, 0, rect.width, rect.height, sAtlasDC, rect.X, rect.Y);
+  }
+
+  wxImage image(coverage.ConvertToImage());
+  image.SetAlpha();
+
+  unsigned char* rgb   = image.GetData();
+  unsigned char* alpha = image.GetAlpha();
+
+  for (int i = 0; i < rect.width * rect.height; i++, rgb += 3)
+  {
+    // Subpixel anti-aliasing covers the channels apart.
+    alpha[i] = gxMax(rgb[0], gxMax(rgb[1], rgb[2]));
+
+    rgb[0] = colour.Red();
+    rgb[1] = colour.Green();
+    rgb[2] = colour.Blue();
+  }
+
+  label = wxBitmap(image, 32);
+  return label;
+}
+
+void gxPaintDC::DrawLabel(const gxString& aText, gxPix aX, gxPix aY, bool isHorizontal)
+{
+  gxLabelAtlas& atlas = gxLabelAtlas::Get();
+  gxFontId font = GetFontId();
+  gxRect rect;
+
+  if (!atlas.Find(font, aText, isHorizontal, rect))
+  {
+    wxSize size = GetTextExtent(aText);
+    gxSize labelSize = isHorizontal ? gxSize(size.x, size.y) : gxSize(size.y, size.x);
+
+    // Too large for the atlas, so drawn as is.
+    if (!atlas.Insert(font, aText, isHorizontal, labelSize, rect))
+    {
+      if (isHorizontal)
+        DrawText(aText, aX, aY);
+      else
+        DrawRotatedText(aText, aX, aY, 90);
+      return;
+    }
+
+    wxMemoryDC* atlasDC = GetAtlasDC();
+    atlasDC->SetFont(GetFont());
+    atlasDC->SetTextForeground(*wxWHITE);
+    atlasDC->SetBackgroundMode(wxTRANSPARENT);
+
+    if (isHorizontal)
+      atlasDC->DrawText(aText, rect.X, rect.Y);
+    else
+      atlasDC->DrawRotatedText(aText, rect.X, rect.Y + rect.height, 90);
+  }
+
+  // Rotated labels go up from their origin.
+  wxCoord y = isHorizontal ? aY : aY - rect.height;
+
+  // In the colour text is drawn with where the label goes.
+  mTarget->DrawBitmap(GetLabel(rect, mTarget->GetTextForeground()), aX, y, true);
+}
+
+// The bitmaps of the strips, by strip. Like the atlas, used from the UI
+// thread only.
+typedef std::unordered_map<gxStripId, wxBitmap*> StripMap;
+static StripMap sStrips;
+
+gxPaintDC::~gxPaintDC()
+{
+  delete mStripDC;
+}
+
+bool gxPaintDC::BeginStrip(gxStripId id, const gxRect& rect, const gxPoint& shift, const gxRect& exposed)
+{
+  if (mStripDC || rect.width <= 0 || rect.height <= 0)
+    return false;
+
+  wxBitmap*& bitmap = sStrips[id];
+
+  if (!bitmap || bitmap->GetWidth() != rect.width || bitmap->GetHeight() != rect.height)
+  {
+    delete bitmap;
+    bitmap = new wxBitmap(rect.width, rect.height);
+
+    // Nothing to shift, so all of it needs drawing.
+    if (exposed.width != rect.width || exposed.height != rect.height)
+      return false;
+  }
+
+  // What's kept of the strip, taken out before the bitmap is selected.
+  gxPix keptWidth  = rect.width  - abs(shift.X);
+  gxPix keptHeight = rect.height - abs(shift.Y);
+  bool  isShifted  = (shift.X || shift.Y) && keptWidth > 0 && keptHeight > 0;
+  wxBitmap kept;
+
+  if (isShifted)
+    kept = bitmap->GetSubBitmap(wxRect(gxMax(-shift.X, 0), gxMax(-shift.Y, 0), keptWidth, keptHeight));
+
+  mStripDC = new wxMemoryDC(*bitmap);
+
+  if (isShifted)
+    mStripDC->DrawBitmap(kept, gxMax(shift.X, 0), gxMax(shift.Y, 0));
+
+  // Drawn in absolute coordinates, as on the DC, with the same tools.
+  mStripDC->SetDeviceOrigin(-rect.X, -rect.Y);
+  mStripDC->SetClippingRegion(exposed.X, exposed.Y, exposed.width, exposed.height);
+  mStripDC->SetPen(GetPen());
+  mStripDC->SetBrush(GetBrush());
+  mStripDC->SetFont(GetFont());
+  mStripDC->SetTextForeground(GetTextForeground());
+
+  mTarget    = mStripDC;
+  mStripRect = rect;
+  return true;
+}
+
+void gxPaintDC::EndStrip()
+{
+  if (!mStripDC)
+    return;
+
+  mStripDC->DestroyClippingRegion();
+  mStripDC->SetDeviceOrigin(0, 0);
+
+  mTarget = this;
+  Blit(mStripRect.X, mStripRect.Y, mStripRect.width, mStripRect.height, mStripDC, 0, 0);
+
+  delete mStripDC;
+  mStripDC = NULL;
+}
+
+void gxPaintDC::ReleaseStrip(gxStripId id)
+{
+  StripMap::iterator found = sStrips.find(id);
+
+  if (found == sStrips.end())
+    return;
+
+  delete found->second;
+  sStrips.erase(found);
+}
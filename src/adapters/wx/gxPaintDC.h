@@ -3,6 +3,11 @@
 
 #include <wx/dcbuffer.h>
 #include "core/geometry/gxGeometry.h"
+#include "core/gxString.h"
+#include "core/gxTextCache.h"
+#include "core/gxStrip.h"
+
+class wxMemoryDC;
 
 /**
  * @brief A wrapper to a system's DC using wxAutoBufferedPaintDC
@@ -11,7 +16,12 @@ class gxPaintDC: public wxAutoBufferedPaintDC
 {
 public:
   gxPaintDC(wxWindow *win)
-    : wxAutoBufferedPaintDC(win) {}
+    : wxAutoBufferedPaintDC(win),
+      mTarget(this),
+      mStripDC(NULL),
+      mFontId(gxTextCache::Hash(gxString())) {}
+
+  ~gxPaintDC();
   
   gxRect GetClippingBox() const
   {
@@ -26,12 +36,69 @@ public:
     wxAutoBufferedPaintDC::SetClippingRegion(rect.X, rect.Y, rect.width, rect.height);
   }
 
+  // Drawing goes to the strip being painted, if any.
   void DrawRectangle(gxPix aX, gxPix aY, gxPix width, gxPix height)
-        { wxAutoBufferedPaintDC::DrawRectangle(aX, aY, width, height); }
+        { mTarget->DrawRectangle(aX, aY, width, height); }
   void DrawRectangle(const gxPoint& aPoint, const gxSize& aSize)
-        { wxAutoBufferedPaintDC::DrawRectangle(aPoint.X, aPoint.Y, aSize.X, aSize.Y); }
+        { mTarget->DrawRectangle(aPoint.X, aPoint.Y, aSize.X, aSize.Y); }
   void DrawRectangle(const gxRect& rect)
-    { wxAutoBufferedPaintDC::DrawRectangle(rect.X, rect.Y, rect.width, rect.height); }
+    { mTarget->DrawRectangle(rect.X, rect.Y, rect.width, rect.height); }
+
+  void DrawLine(gxPix x1, gxPix y1, gxPix x2, gxPix y2)
+        { mTarget->DrawLine(x1, y1, x2, y2); }
+
+  void DrawText(const gxString& text, gxPix x, gxPix y)
+        { mTarget->DrawText(text, x, y); }
+  void DrawRotatedText(const gxString& text, gxPix x, gxPix y, double angle)
+        { mTarget->DrawRotatedText(text, x, y, angle); }
+
+  // Draws a label (in the text colour) from the label atlas, rendering it
+  // there first if need be. Rotated labels are rotated by 90 degrees about
+  // (aX, aY), as with DrawRotatedText().
+  void DrawLabel(const gxString& aText, gxPix aX, gxPix aY, bool isHorizontal);
+
+  // Starts drawing into the bitmap of a strip, at (absolute) rect, after
+  // shifting what's there by shift. Drawing is clipped to the exposed rect
+  // till EndStrip(). Returns false if the strip's bitmap was just made, but
+  // not all of it is exposed.
+  bool BeginStrip(gxStripId id, const gxRect& rect, const gxPoint& shift, const gxRect& exposed);
+
+  // Blits the strip being drawn into on the DC.
+  void EndStrip();
+
+  // Drops the bitmap of a strip.
+  static void ReleaseStrip(gxStripId id);
+
+  gxSize GetTextSize(const gxString& aText)
+  {
+    wxSize size = GetTextExtent(aText);
+    return gxSize(size.x, size.y);
+  }
+
+  // Identifies the font text is measured with, for the text cache. Hashing
+  // the font's description is slow, so it's only redone once the font
+  // changes.
+  gxFontId GetFontId() const
+  {
+    if (!GetFont().IsSameAs(mHashedFont))
+    {
+      mHashedFont = GetFont();
+      mFontId = gxTextCache::Hash(mHashedFont.GetNativeFontInfoDesc());
+    }
+
+    return mFontId;
+  }
+
+private:
+  // Where drawing goes: this DC, or the strip being drawn into.
+  wxDC*       mTarget;
+  wxMemoryDC* mStripDC;
+  gxRect      mStripRect;
+
+  // The font last hashed by GetFontId() (kept, so it's compared by
+  // reference), and its id. Until a font is set, the null font's.
+  mutable wxFont   mHashedFont;
+  mutable gxFontId mFontId;
 };
 
 #endif // gxPaintDC_wx_h
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "core/geometry/gxAffine.h"
+
+gxAffine& gxAffine::operator*=( gxAffine const &aOther )
+{
+    // The other's translation goes through this linear part first.
+    gxFixedPoint iDelta = TransformVector( aOther.GetTranslation() );
+
+    float iXX = mXX * aOther.mXX + mXY * aOther.mYX;
+    float iXY = mXX * aOther.mXY + mXY * aOther.mYY;
+    float iYX = mYX * aOther.mXX + mYY * aOther.mYX;
+    float iYY = mYX * aOther.mXY + mYY * aOther.mYY;
+
+    mXX = iXX;
+    mXY = iXY;
+    mYX = iYX;
+    mYY = iYY;
+
+    PostTranslate( iDelta );
+    UpdateKind();
+
+    return *this;
+}
+
+void gxAffine::Apply( gxFixedPoint *aPoints,
+                      size_t       aCount ) const
+{
+    // The kind is looked at once, rather than per point.
+    switch ( mKind )
+    {
+    case Translation:
+        for ( size_t i = 0; i < aCount; i++ )
+        {
+            aPoints[i].X += mDX;
+            aPoints[i].Y += mDY;
+        }
+        break;
+    case AxisAligned:
+        for ( size_t i = 0; i < aCount; i++ )
+        {
+            aPoints[i].X = gxScaleCoord( aPoints[i].X, mXX ) + mDX;
+            aPoints[i].Y = gxScaleCoord( aPoints[i].Y, mYY ) + mDY;
+        }
+        break;
+    default:
+        for ( size_t i = 0; i < aCount; i++ )
+            Apply( aPoints[i] );
+        break;
+    }
+}
+
+void gxAffine::Apply( gxFixedRect &aRect ) const
+{
+    if ( mKind == Translation )
+    {
+        aRect.X += mDX;
+        aRect.Y += mDY;
+        return;
+    }
+
+    // The corners, as with gxRect::Scale().
+    gxFixedPoint iCorners[4] =
+    {
+        gxFixedPoint( aRect.X,               aRect.Y ),
+        gxFixedPoint( aRect.X + aRect.width, aRect.Y + aRect.height ),
+        gxFixedPoint( aRect.X + aRect.width, aRect.Y ),
+        gxFixedPoint( aRect.X,               aRect.Y + aRect.height )
+    };
+
+    // Axis-aligned rects only need the two opposite corners.
+    Apply( iCorners, mKind == AxisAligned ? 2 : 4 );
+
+    gxFixedPoint iMin( iCorners[0] );
+    gxFixedPoint iMax( iCorners[0] );
+
+    for ( int i = 1; i < ( mKind == AxisAligned ? 2 : 4 ); i++ )
+    {
+        iMin.X = gxMin( iMin.X, iCorners[i].X );
+        iMin.Y = gxMin( iMin.Y, iCorners[i].Y );
+        iMax.X = gxMax( iMax.X, iCorners[i].X );
+        iMax.Y = gxMax( iMax.Y, iCorners[i].Y );
+    }
+
+    aRect = gxFixedRect( iMin.X, iMin.Y, iMax.X - iMin.X, iMax.Y - iMin.Y );
+}
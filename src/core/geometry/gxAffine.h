@@ -0,0 +1,182 @@
+#ifndef gxAffine_h
+#define gxAffine_h
+
+#include "core/geometry/gxGeometry.h"
+
+#include <cstddef>
+
+/**
+ * @brief A 2D affine transformation of fixed-point geometry: a linear part
+ * (scale, or any 2x2 matrix) followed by a translation.
+ *
+ *     X' = floor( XX * X + XY * Y ) + DX
+ *     Y' = floor( YX * X + YY * Y ) + DY
+ *
+ * (floored to 1/256 pixel, see gxFixed).
+ *
+ * Transformations are composed once (say, as a painter's scale, translate and
+ * scroll are set), so a point or a rect is then transformed with a single
+ * multiply-add per coordinate. Translations composed are transformed by the
+ * linear part as they are composed, and kept in fixed point, so nested
+ * scales lose at most 1/256 pixel each rather than a whole one; the result
+ * is converted to device pixels once, when painted (see gxDcPainter).
+ *
+ * The kind of transformation (a translation only, an axis-aligned scale, or
+ * any other) is kept as it's composed, so the common kinds take the shortest
+ * way.
+ */
+class gxAffine
+{
+public:
+    gxAffine() :
+        mXX( 1 ), mXY( 0 ), mYX( 0 ), mYY( 1 ),
+        mDX( 0 ), mDY( 0 ),
+        mKind( Translation )
+    {
+    }
+
+    /**
+     * @param aXX, aXY, aYX, aYY The linear part.
+     * @param aDX, aDY The translation.
+     */
+    gxAffine( float aXX, float aXY,
+              float aYX, float aYY,
+              gxFixed aDX, gxFixed aDY ) :
+        mXX( aXX ), mXY( aXY ), mYX( aYX ), mYY( aYY ),
+        mDX( aDX ), mDY( aDY )
+    {
+        UpdateKind();
+    }
+
+    /**
+     * @brief Resets to the identity transformation.
+     */
+    void Reset()
+    {
+        *this = gxAffine();
+    }
+
+    /**
+     * @brief Returns whether or not the linear part is the identity, so the
+     * transformation only translates.
+     */
+    bool IsTranslation() const { return mKind == Translation; }
+
+    /**
+     * @brief Returns whether or not rects stay rects, scaled along the axes.
+     */
+    bool IsAxisAligned() const { return mKind != General; }
+
+    bool IsIdentity() const { return IsTranslation() && mDX == 0 && mDY == 0; }
+
+    /**
+     * @brief Returns the scale along the axes (the diagonal of the linear
+     * part).
+     */
+    gxScale GetScale() const { return gxScale( mXX, mYY ); }
+
+    /**
+     * @brief Returns the translation.
+     */
+    gxFixedPoint GetTranslation() const { return gxFixedPoint( mDX, mDY ); }
+
+    /**
+     * @brief Composes a scale, applied before this transformation.
+     */
+    void Scale( gxScale const &aScale )
+    {
+        mXX *= aScale.X;
+        mYX *= aScale.X;
+        mXY *= aScale.Y;
+        mYY *= aScale.Y;
+        UpdateKind();
+    }
+
+    /**
+     * @brief Composes a translation, applied before this transformation (so
+     * it's scaled by it).
+     */
+    void Translate( gxFixedPoint const &aDelta )
+    {
+        PostTranslate( TransformVector( aDelta ) );
+    }
+
+    /**
+     * @brief Composes a translation, applied after this transformation.
+     */
+    void PostTranslate( gxFixedPoint const &aDelta )
+    {
+        mDX += aDelta.X;
+        mDY += aDelta.Y;
+    }
+
+    /**
+     * @brief Composes another transformation, applied before this one.
+     */
+    gxAffine& operator*=( gxAffine const &aOther );
+
+    /**
+     * @brief Transforms a vector (a point, but for the translation).
+     */
+    gxFixedPoint TransformVector( gxFixedPoint const &aVector ) const
+    {
+        switch ( mKind )
+        {
+        case Translation:
+            return aVector;
+        case AxisAligned:
+            return gxFixedPoint( gxScaleCoord( aVector.X, mXX ),
+                                 gxScaleCoord( aVector.Y, mYY ) );
+        default:
+        {
+            // In double, as with gxScaleCoord().
+            double iX = aVector.X.GetRaw();
+            double iY = aVector.Y.GetRaw();
+
+            return gxFixedPoint( gxFixed::FromRaw( (long long)floor( mXX * iX + mXY * iY ) ),
+                                 gxFixed::FromRaw( (long long)floor( mYX * iX + mYY * iY ) ) );
+        }
+        }
+    }
+
+    /**
+     * @brief Transforms a point.
+     */
+    void Apply( gxFixedPoint &aPoint ) const
+    {
+        aPoint = TransformVector( aPoint );
+        aPoint.X += mDX;
+        aPoint.Y += mDY;
+    }
+
+    /**
+     * @brief Transforms an array of points.
+     */
+    void Apply( gxFixedPoint *aPoints,
+                size_t       aCount ) const;
+
+    /**
+     * @brief Transforms a rect. Unless axis-aligned, the rect becomes the
+     * bounds of its transformed corners.
+     */
+    void Apply( gxFixedRect &aRect ) const;
+
+private:
+    enum Kind { Translation, AxisAligned, General };
+
+    float   mXX, mXY, mYX, mYY;
+    gxFixed mDX, mDY;
+    Kind    mKind;
+
+    void UpdateKind()
+    {
+        if ( mXY != 0 || mYX != 0 )
+            mKind = General;
+        else if ( mXX != 1 || mYY != 1 )
+            mKind = AxisAligned;
+        else
+            mKind = Translation;
+    }
+};
+
+#endif //gxAffine_h
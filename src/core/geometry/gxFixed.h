@@ -0,0 +1,148 @@
+#ifndef gxFixed_h
+#define gxFixed_h
+
+#include "core/gxAssert.h"
+#include "core/geometry/gxGeometryDefs.h"
+
+#include <climits>
+
+/**
+ * @brief A fixed-point coordinate: whole pixels with 1/256 pixel steps,
+ * kept in a long long so any gxPix fits (a virtual list of a million rows
+ * is well past the 8M pixels of a 24.8 int).
+ *
+ * Geometry kept in fixed point (see gxFixedPoint, gxFixedSize and
+ * gxFixedRect) can be scaled again and again losing at most 1/256 pixel per
+ * scale, rather than a whole pixel as gxPix, and is added and compared with
+ * integer math. It's converted to device pixels once (see gxToPix()), when
+ * painted.
+ *
+ * Whole pixels convert implicitly, so fixed-point coordinates mix with
+ * gxPix ones; the other way round takes Floor(), Round() or Ceil().
+ */
+class gxFixed
+{
+public:
+    /**
+     * @brief The number of bits of the fraction, and the raw value of one
+     * pixel.
+     */
+    static const int FractionBits = 8;
+    static const int One = 1 << FractionBits;
+
+    gxFixed() : mRaw( 0 ) { }
+
+    gxFixed( gxPix aPix ) : mRaw( (long long)aPix * One ) { }
+
+    /**
+     * @brief Returns the fixed-point value of a raw value (in 1/256 pixel).
+     */
+    static gxFixed FromRaw( long long aRaw )
+    {
+        gxFixed iFixed;
+        iFixed.mRaw = aRaw;
+        return iFixed;
+    }
+
+    /**
+     * @brief Returns the fixed-point value nearest to a float.
+     */
+    static gxFixed FromFloat( float aValue )
+    {
+        return FromRaw( (long long)floor( aValue * double( One ) + 0.5 ) );
+    }
+
+    long long GetRaw() const { return mRaw; }
+
+    /**
+     * @brief Returns the pixel the value is in (rounding down, as gxFloor()
+     * does).
+     */
+    gxPix Floor() const { return ToPix( mRaw >> FractionBits ); }
+
+    gxPix Ceil() const { return ToPix( ( mRaw + One - 1 ) >> FractionBits ); }
+
+    gxPix Round() const { return ToPix( ( mRaw + One / 2 ) >> FractionBits ); }
+
+    float ToFloat() const { return mRaw / float( One ); }
+
+    gxFixed operator-() const { return FromRaw( -mRaw ); }
+
+    gxFixed& operator+=( gxFixed const &aOther ) { mRaw += aOther.mRaw; return *this; }
+    gxFixed& operator-=( gxFixed const &aOther ) { mRaw -= aOther.mRaw; return *this; }
+
+    gxFixed& operator*=( gxFixed const &aOther )
+    {
+        mRaw = ( mRaw * aOther.mRaw ) >> FractionBits;
+        return *this;
+    }
+
+    gxFixed& operator/=( gxFixed const &aOther )
+    {
+        mRaw = ( mRaw * One ) / aOther.mRaw;
+        return *this;
+    }
+
+    // Friends, so whole pixels convert on either side.
+    friend gxFixed operator+( gxFixed aA, gxFixed const &aB ) { return aA += aB; }
+    friend gxFixed operator-( gxFixed aA, gxFixed const &aB ) { return aA -= aB; }
+    friend gxFixed operator*( gxFixed aA, gxFixed const &aB ) { return aA *= aB; }
+    friend gxFixed operator/( gxFixed aA, gxFixed const &aB ) { return aA /= aB; }
+
+    friend bool operator==( gxFixed const &aA, gxFixed const &aB ) { return aA.mRaw == aB.mRaw; }
+    friend bool operator!=( gxFixed const &aA, gxFixed const &aB ) { return aA.mRaw != aB.mRaw; }
+    friend bool operator< ( gxFixed const &aA, gxFixed const &aB ) { return aA.mRaw <  aB.mRaw; }
+    friend bool operator<=( gxFixed const &aA, gxFixed const &aB ) { return aA.mRaw <= aB.mRaw; }
+    friend bool operator> ( gxFixed const &aA, gxFixed const &aB ) { return aA.mRaw >  aB.mRaw; }
+    friend bool operator>=( gxFixed const &aA, gxFixed const &aB ) { return aA.mRaw >= aB.mRaw; }
+
+private:
+    long long mRaw;
+
+    static gxPix ToPix( long long aPix )
+    {
+        gxAssert( aPix >= INT_MIN && aPix <= INT_MAX, "Fixed-point value out of the range of gxPix" );
+        return gxPix( aPix );
+    }
+};
+
+/**
+ * @brief Returns the device pixel a fixed-point coordinate is in.
+ */
+inline gxPix gxToPix( gxFixed aValue )
+{
+    return aValue.Floor();
+}
+
+/**
+ * @brief Scales a coordinate, rounding down to the nearest coordinate (a
+ * whole pixel for gxPix, 1/256 pixel for gxFixed).
+ */
+inline gxPix gxScaleCoord( gxPix aValue,
+                           float aScale )
+{
+    return gxFloor( aValue * aScale );
+}
+
+inline gxFixed gxScaleCoord( gxFixed aValue,
+                             float   aScale )
+{
+    // In double, as raw values go past the 24 bits a float keeps exact.
+    return gxFixed::FromRaw( (long long)floor( aValue.GetRaw() * double( aScale ) ) );
+}
+
+/**
+ * @brief Returns the smallest step of a coordinate (a whole pixel for gxPix,
+ * 1/256 pixel for gxFixed); the argument only picks the type.
+ */
+inline gxPix gxCoordStep( gxPix )
+{
+    return 1;
+}
+
+inline gxFixed gxCoordStep( gxFixed )
+{
+    return gxFixed::FromRaw( 1 );
+}
+
+#endif //gxFixed_h
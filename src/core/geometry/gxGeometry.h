@@ -2,6 +2,7 @@
 #define gxGeometry_h
 
 #include "core/geometry/gxGeometryDefs.h"
+#include "core/geometry/gxFixed.h"
 #include "core/geometry/gxSize.h"
 #include "core/geometry/gxScale.h"
 #include "core/geometry/gxPoint.h"
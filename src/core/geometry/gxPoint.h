@@ -8,92 +8,100 @@
 
 #include "core/geometry/gxGeometry.h"
 
-class gxPoint
+/**
+ * @brief A point, of coordinates of a given type (see gxPoint for gxPix and
+ * gxFixedPoint for gxFixed).
+ */
+template< class tCoord >
+class gxBasicPoint
 {
 public:
-    gxPix X, Y;
+    typedef tCoord                CoordType;
+    typedef gxBasicSize< tCoord > SizeType;
 
-    gxPoint() : X(0), Y(0) { }
-    gxPoint( gxPix aX,
-             gxPix aY )
+    tCoord X, Y;
+
+    gxBasicPoint() : X(0), Y(0) { }
+    gxBasicPoint( tCoord aX,
+                  tCoord aY )
       : X( aX ), Y( aY ) { }
 
     // no copy ctor or assignment operator - the defaults are ok
 
     // comparison
-    bool operator==( const gxPoint& p ) const
+    bool operator==( const gxBasicPoint& p ) const
     {
         return X == p.X && Y == p.Y;
     }
     
-    bool operator!=( const gxPoint& p ) const
+    bool operator!=( const gxBasicPoint& p ) const
     {
         return !( *this == p );
     }
 
     // arithmetic operations (component wise)
-    gxPoint operator+( const gxPoint& p ) const
+    gxBasicPoint operator+( const gxBasicPoint& p ) const
     {
-        return gxPoint( X + p.X, Y + p.Y );
+        return gxBasicPoint( X + p.X, Y + p.Y );
     }
 
-    gxPoint& operator+=( const gxPoint& p )
+    gxBasicPoint& operator+=( const gxBasicPoint& p )
     {
         X += p.X;
         Y += p.Y;
         return *this;
     }
 
-    gxPoint operator+( const gxSize& s ) const
+    gxBasicPoint operator+( const SizeType& s ) const
     {
-        return gxPoint( X + s.GetWidth(), Y + s.GetHeight() );
+        return gxBasicPoint( X + s.GetWidth(), Y + s.GetHeight() );
     }
     
-    gxPoint& operator+=( const gxSize& s )
+    gxBasicPoint& operator+=( const SizeType& s )
     {
         X += s.GetWidth();
         Y += s.GetHeight();
         return *this;
     }
     
-    gxPoint operator-( const gxPoint& p ) const
+    gxBasicPoint operator-( const gxBasicPoint& p ) const
     {
-        return gxPoint( X - p.X, Y - p.Y );
+        return gxBasicPoint( X - p.X, Y - p.Y );
     }
 
-    gxPoint& operator-=( const gxPoint& p )
+    gxBasicPoint& operator-=( const gxBasicPoint& p )
     {
         X -= p.X;
         Y -= p.Y;
         return *this;
     }
 
-    gxPoint operator-( const gxSize& s ) const
+    gxBasicPoint operator-( const SizeType& s ) const
     {
-        return gxPoint( X - s.GetWidth(), Y - s.GetHeight() );
+        return gxBasicPoint( X - s.GetWidth(), Y - s.GetHeight() );
     }
         
-    gxPoint& operator-=( const gxSize& s )
+    gxBasicPoint& operator-=( const SizeType& s )
     {
         X -= s.GetWidth();
         Y -= s.GetHeight();
         return *this;
     }
     
-    gxPoint operator-() const
+    gxBasicPoint operator-() const
     {
-        return gxPoint( -X, -Y );
+        return gxBasicPoint( -X, -Y );
     }
     
-    gxPoint operator*( const gxScale& s ) const
+    gxBasicPoint operator*( const gxScale& s ) const
     {
-        return gxPoint( gxFloor( X * s.X ), gxFloor( Y * s.Y ) );
+        return gxBasicPoint( gxScaleCoord( X, s.X ), gxScaleCoord( Y, s.Y ) );
     }
     
-    gxPoint& operator*=( const gxScale& s )
+    gxBasicPoint& operator*=( const gxScale& s )
     {
-        X = gxFloor( X * s.X);
-        Y = gxFloor( Y * s.Y);
+        X = gxScaleCoord( X, s.X );
+        Y = gxScaleCoord( Y, s.Y );
         return *this;
     }
     
@@ -114,4 +122,20 @@ public:
     }
 };
 
+typedef gxBasicPoint< gxPix >   gxPoint;
+typedef gxBasicPoint< gxFixed > gxFixedPoint;
+
+/**
+ * @brief Returns the device pixel a fixed-point point is in.
+ */
+inline gxPoint gxToPix( const gxFixedPoint& aPoint )
+{
+    return gxPoint( aPoint.X.Floor(), aPoint.Y.Floor() );
+}
+
+inline gxFixedPoint gxToFixed( const gxPoint& aPoint )
+{
+    return gxFixedPoint( aPoint.X, aPoint.Y );
+}
+
 #endif // gxPoint_h
\ No newline at end of file
@@ -4,8 +4,9 @@
 /////////////////////////////////////////////////////////////////////////////
 #include "core/geometry/gxRect.h"
 
-gxRect::gxRect( const gxPoint& aTopLeft,
-                const gxPoint& aBottomRight )
+template< class tCoord >
+gxBasicRect< tCoord >::gxBasicRect( const PointType& aTopLeft,
+                                    const PointType& aBottomRight )
 {
     X = aTopLeft.X;
     Y = aTopLeft.Y;
@@ -17,17 +18,18 @@ gxRect::gxRect( const gxPoint& aTopLeft,
         width = -width;
         X = aBottomRight.X;
     }
-    width++;
+    width += gxCoordStep( width );
 
     if ( height < 0 )
     {
         height = -height;
         Y = aBottomRight.Y;
     }
-    height++;
+    height += gxCoordStep( height );
 }
 
-bool gxRect::operator==( const gxRect& aRect ) const
+template< class tCoord >
+bool gxBasicRect< tCoord >::operator==( const gxBasicRect& aRect ) const
 {
     return (
         ( X      == aRect.X      ) &&
@@ -37,29 +39,31 @@ bool gxRect::operator==( const gxRect& aRect ) const
     );
 }
 
-gxRect gxRect::operator+( const gxRect& aRect ) const
+template< class tCoord >
+gxBasicRect< tCoord > gxBasicRect< tCoord >::operator+( const gxBasicRect& aRect ) const
 {
-    gxPix x1 = gxMin( this->X, aRect.X );
-    gxPix y1 = gxMin( this->Y, aRect.Y );
-    gxPix y2 = gxMax( Y + height, aRect.height + aRect.Y );
-    gxPix x2 = gxMax( X + width, aRect.width + aRect.X );
-    return gxRect( x1, y1, x2-x1, y2-y1 );
+    tCoord x1 = gxMin( this->X, aRect.X );
+    tCoord y1 = gxMin( this->Y, aRect.Y );
+    tCoord y2 = gxMax( Y + height, aRect.height + aRect.Y );
+    tCoord x2 = gxMax( X + width, aRect.width + aRect.X );
+    return gxBasicRect( x1, y1, x2-x1, y2-y1 );
 }
 
-gxRect& gxRect::Union( const gxRect& aRect )
+template< class tCoord >
+gxBasicRect< tCoord >& gxBasicRect< tCoord >::Union( const gxBasicRect& aRect )
 {
     // ignore empty rectangles: union with an empty rectangle shouldn't extend
     // this one to (0, 0)
-    if ( !width || !height )
+    if ( width == 0 || height == 0 )
     {
         *this = aRect;
     }
-    else if ( aRect.width && aRect.height )
+    else if ( aRect.width != 0 && aRect.height != 0 )
     {
-        gxPix x1 = gxMin( X, aRect.X );
-        gxPix y1 = gxMin( Y, aRect.Y );
-        gxPix y2 = gxMax( Y + height, aRect.height + aRect.Y );
-        gxPix x2 = gxMax( X + width, aRect.width + aRect.X );
+        tCoord x1 = gxMin( X, aRect.X );
+        tCoord y1 = gxMin( Y, aRect.Y );
+        tCoord y2 = gxMax( Y + height, aRect.height + aRect.Y );
+        tCoord x2 = gxMax( X + width, aRect.width + aRect.X );
 
         X = x1;
         Y = y1;
@@ -71,8 +75,9 @@ gxRect& gxRect::Union( const gxRect& aRect )
     return *this;
 }
 
-gxRect& gxRect::Inflate( gxPix dx,
-                         gxPix dy )
+template< class tCoord >
+gxBasicRect< tCoord >& gxBasicRect< tCoord >::Inflate( tCoord dx,
+                                                       tCoord dy )
 {
     if ( -2 * dx > width )
     {
@@ -101,8 +106,9 @@ gxRect& gxRect::Inflate( gxPix dx,
     return *this;
 }
 
-bool gxRect::Contains( gxPix cx,
-                       gxPix cy ) const
+template< class tCoord >
+bool gxBasicRect< tCoord >::Contains( tCoord cx,
+                                      tCoord cy ) const
 {
     return (
         ( cx >= X ) &&
@@ -112,15 +118,17 @@ bool gxRect::Contains( gxPix cx,
     );
 }
 
-bool gxRect::Contains( const gxRect& aRect ) const
+template< class tCoord >
+bool gxBasicRect< tCoord >::Contains( const gxBasicRect& aRect ) const
 {
     return Contains( aRect.GetTopLeft() ) && Contains( aRect.GetBottomRight() );
 }
 
-gxRect& gxRect::Intersect( const gxRect& aRect )
+template< class tCoord >
+gxBasicRect< tCoord >& gxBasicRect< tCoord >::Intersect( const gxBasicRect& aRect )
 {
-    gxPix x2 = GetRight(),
-          y2 = GetBottom();
+    tCoord x2 = GetRight(),
+           y2 = GetBottom();
 
     if ( X < aRect.X )
         X = aRect.X;
@@ -134,8 +142,10 @@ gxRect& gxRect::Intersect( const gxRect& aRect )
     if ( y2 > aRect.GetBottom() )
         y2 = aRect.GetBottom();
 
-    width  = x2 - X + 1;
-    height = y2 - Y + 1;
+    // The right and bottom edges count as inside, by one step of the
+    // coordinate.
+    width  = x2 - X + gxCoordStep( x2 );
+    height = y2 - Y + gxCoordStep( y2 );
 
     if ( width <= 0 || height <= 0 )
     {
@@ -146,27 +156,34 @@ gxRect& gxRect::Intersect( const gxRect& aRect )
     return *this;
 }
 
-bool gxRect::Intersects( const gxRect& aRect ) const
+template< class tCoord >
+bool gxBasicRect< tCoord >::Intersects( const gxBasicRect& aRect ) const
 {
-    gxRect iRect = Intersect( aRect );
+    gxBasicRect iRect = Intersect( aRect );
 
     // if there is no intersection, both width and height are 0
     return iRect.width != 0;
 }
 
-void gxRect::Scale( float aScaleX,
-                    float aScaleY )
+template< class tCoord >
+void gxBasicRect< tCoord >::Scale( float aScaleX,
+                                   float aScaleY )
 {
-    gxPix originalX = X;
-    gxPix originalY = Y;
+    tCoord originalX = X;
+    tCoord originalY = Y;
     
-    X = gxFloor( originalX * aScaleX );
-    Y = gxFloor( originalY * aScaleY );
-    width =  gxFloor( ( originalX + width  ) * aScaleX ) - X;
-    height = gxFloor( ( originalY + height ) * aScaleY ) - Y;
+    X = gxScaleCoord( originalX, aScaleX );
+    Y = gxScaleCoord( originalY, aScaleY );
+    width =  gxScaleCoord( originalX + width,  aScaleX ) - X;
+    height = gxScaleCoord( originalY + height, aScaleY ) - Y;
 }
 
-void gxRect::Scale( const gxScale aScale )
+template< class tCoord >
+void gxBasicRect< tCoord >::Scale( const gxScale aScale )
 {
     Scale( aScale.X, aScale.Y );
 }
+
+// The coordinates rects are used with
+template class gxBasicRect< gxPix >;
+template class gxBasicRect< gxFixed >;
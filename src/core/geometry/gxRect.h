@@ -10,94 +10,104 @@
 #include "core/geometry/gxGeometry.h"
 
 // forward decleration (for gxRects)
-class gxRect;
+template< class tCoord > class gxBasicRect;
+typedef gxBasicRect< gxPix > gxRect;
 
 // definition of gxRects - a vector of gxRect
 typedef std::vector< gxRect > gxRects;
 typedef gxRects::iterator gxRectsIterator;
 
-class gxRect
+/**
+ * @brief A rect, of coordinates of a given type (see gxRect for gxPix and
+ * gxFixedRect for gxFixed).
+ */
+template< class tCoord >
+class gxBasicRect
 {
 public:
-    gxRect()
+    typedef tCoord                 CoordType;
+    typedef gxBasicPoint< tCoord > PointType;
+    typedef gxBasicSize< tCoord >  SizeType;
+
+    gxBasicRect()
         : X(0), Y(0), width(0), height(0)
         { }
     
-    gxRect( gxPix aX, gxPix aY, gxPix aW, gxPix aH )
+    gxBasicRect( tCoord aX, tCoord aY, tCoord aW, tCoord aH )
         : X( aX ), Y( aY ), width( aW ), height( aH )
         { }
     
-    gxRect( const gxPoint& aTopLeft,
-            const gxPoint& aBottomRight );
+    gxBasicRect( const PointType& aTopLeft,
+                 const PointType& aBottomRight );
     
-    gxRect( const gxPoint& aPoint,
-            const gxSize& aSize )
+    gxBasicRect( const PointType& aPoint,
+                 const SizeType& aSize )
         : X( aPoint.X ), Y( aPoint.Y ), width( aSize.X ), height( aSize.Y )
         { }
     
-    gxRect( const gxSize& aSize )
+    gxBasicRect( const SizeType& aSize )
         : X( 0 ), Y( 0 ), width( aSize.X ), height( aSize.Y )
         { }
 
     // default copy ctor and assignment operators ok
 
-    gxPix GetX() const
+    tCoord GetX() const
     {
         return X;
     }
     
-    void SetX( gxPix aX )
+    void SetX( tCoord aX )
     {
         X = aX;
     }
 
-    gxPix GetY() const
+    tCoord GetY() const
     {
         return Y;
     }
     
-    void SetY( gxPix aY )
+    void SetY( tCoord aY )
     {
         Y = aY;
     }
 
-    gxPix GetWidth() const
+    tCoord GetWidth() const
     {
         return width;
     }
     
-    void SetWidth( gxPix aW )
+    void SetWidth( tCoord aW )
     {
         width = aW;
     }
 
-    gxPix GetHeight() const
+    tCoord GetHeight() const
     {
         return height;
     }
     
-    void SetHeight( gxPix aH )
+    void SetHeight( tCoord aH )
     {
         height = aH;
     }
 
-    gxPoint GetPosition() const
+    PointType GetPosition() const
     {
-        return gxPoint(X, Y);
+        return PointType(X, Y);
     }
     
-    gxPix GetPosition( const bool onMajorAxis ) const
+    tCoord GetPosition( const bool onMajorAxis ) const
     {
         return onMajorAxis ? GetX() : GetY();
     }
     
-    void SetPosition( const gxPoint &aPoint )
+    void SetPosition( const PointType &aPoint )
     {
         X = aPoint.X;
         Y = aPoint.Y;
     }
     
-    void SetPosition( const gxPix aPosition, bool onMajorAxis )
+    void SetPosition( const tCoord aPosition, bool onMajorAxis )
     {
         if ( onMajorAxis )
             X = aPosition;
@@ -105,23 +115,23 @@ public:
             Y = aPosition;
     }
     
-    gxSize GetSize() const
+    SizeType GetSize() const
     {
-        return gxSize( width, height );
+        return SizeType( width, height );
     }
     
-    gxPix GetSize( bool onMajorAxis ) const
+    tCoord GetSize( bool onMajorAxis ) const
     {
         return onMajorAxis ? GetWidth() : GetHeight();
     }
     
-    void SetSize( const gxSize &aSize )
+    void SetSize( const SizeType &aSize )
     {
         width  = aSize.GetWidth();
         height = aSize.GetHeight();
     }
 
-    void SetSize( const gxPix aSize, bool onMajorAxis )
+    void SetSize( const tCoord aSize, bool onMajorAxis )
     {
         if ( onMajorAxis )
             width  = aSize;
@@ -129,7 +139,7 @@ public:
             height = aSize;
     }
     
-    gxPoint GetCenter() const
+    PointType GetCenter() const
     {
         return GetPosition() + GetSize().Scale( 0.5, 0.5 );
     }
@@ -139,171 +149,171 @@ public:
         return (width <= 0) || (height <= 0);
     }
 
-    gxPix GetLeft()   const { return X; }
-    gxPix GetTop()    const { return Y; }
-    gxPix GetBottom() const { return Y + height; }
-    gxPix GetRight()  const { return X + width; }
+    tCoord GetLeft()   const { return X; }
+    tCoord GetTop()    const { return Y; }
+    tCoord GetBottom() const { return Y + height; }
+    tCoord GetRight()  const { return X + width; }
 
-    void SetLeft( gxPix aLeft ) { X = aLeft; }
-    void SetRight( gxPix aRight ) { width = aRight - X; }
-    void SetTop( gxPix aTop ) { Y = aTop; }
-    void SetBottom( gxPix aBottom ) { height = aBottom - Y; }
+    void SetLeft( tCoord aLeft ) { X = aLeft; }
+    void SetRight( tCoord aRight ) { width = aRight - X; }
+    void SetTop( tCoord aTop ) { Y = aTop; }
+    void SetBottom( tCoord aBottom ) { height = aBottom - Y; }
 
-    gxPoint GetTopLeft() const { return GetPosition(); }
-    void SetTopLeft( const gxPoint &aPoint ) { SetPosition( aPoint ); }
+    PointType GetTopLeft() const { return GetPosition(); }
+    void SetTopLeft( const PointType &aPoint ) { SetPosition( aPoint ); }
 
-    gxPoint GetBottomRight() const
+    PointType GetBottomRight() const
     {
-        return gxPoint( GetRight(), GetBottom() );
+        return PointType( GetRight(), GetBottom() );
     }
     
-    void SetBottomRight( const gxPoint &aPoint )
+    void SetBottomRight( const PointType &aPoint )
     {
         SetRight(  aPoint.X );
         SetBottom( aPoint.Y );
     }
     
-    gxPoint GetTopRight() const
+    PointType GetTopRight() const
     {
-        return gxPoint( GetRight(), GetTop() );
+        return PointType( GetRight(), GetTop() );
     }
     
-    void SetTopRight( const gxPoint &aPoint )
+    void SetTopRight( const PointType &aPoint )
     {
         SetRight( aPoint.X );
         SetTop( aPoint.Y );
     }
 
-    gxPoint GetBottomLeft() const
+    PointType GetBottomLeft() const
     {
-        return gxPoint( GetLeft(), GetBottom() );
+        return PointType( GetLeft(), GetBottom() );
     }
     
-    void SetBottomLeft( const gxPoint &aPoint )
+    void SetBottomLeft( const PointType &aPoint )
     {
         SetLeft( aPoint.X );
         SetBottom( aPoint.Y );
     }
     
     // operations with rect
-    gxRect& Inflate( gxPix dx,
-                     gxPix dy );
+    gxBasicRect& Inflate( tCoord dx,
+                          tCoord dy );
     
-    gxRect& Inflate( const gxSize& d )
+    gxBasicRect& Inflate( const SizeType& d )
     {
         return Inflate(d.X, d.Y);
     }
     
-    gxRect& Inflate( gxPix d )
+    gxBasicRect& Inflate( tCoord d )
     {
         return Inflate(d, d);
     }
     
-    gxRect  Inflate( gxPix dx,
-                     gxPix dy ) const
+    gxBasicRect  Inflate( tCoord dx,
+                          tCoord dy ) const
     {
-        gxRect r = *this;
+        gxBasicRect r = *this;
         r.Inflate( dx, dy );
         return r;
     }
 
-    gxRect& Deflate( gxPix dx,
-                     gxPix dy )
+    gxBasicRect& Deflate( tCoord dx,
+                          tCoord dy )
     {
         return Inflate( -dx, -dy );
     }
     
-    gxRect& Deflate( const gxSize& d )
+    gxBasicRect& Deflate( const SizeType& d )
     {
         return Inflate( -d.X, -d.Y );
     }
     
-    gxRect& Deflate( gxPix d )
+    gxBasicRect& Deflate( tCoord d )
     {
         return Inflate( -d );
     }
     
-    gxRect Deflate( gxPix dx, gxPix dy ) const
+    gxBasicRect Deflate( tCoord dx, tCoord dy ) const
     {
-        gxRect r = *this;
+        gxBasicRect r = *this;
         r.Deflate(dx, dy);
         return r;
     }
 
-    void Translate( gxPix d,
+    void Translate( tCoord d,
                     bool  onMajorAxis )
     {
         onMajorAxis ? X += d : Y += d;
     }
     
     
-    void Translate( gxPix dx,
-                    gxPix dy )
+    void Translate( tCoord dx,
+                    tCoord dy )
     {
         X += dx;
         Y += dy;
     }
     
     // Offsets the rect position
-    void Translate( const gxPoint& aPoint )
+    void Translate( const PointType& aPoint )
     {
         Translate( aPoint.X, aPoint.Y );
     }
     
-    gxRect& operator+=( const gxPoint& aPoint )
+    gxBasicRect& operator+=( const PointType& aPoint )
     {
         this->Translate( aPoint );
         return *this;
     }
 
-    gxRect& operator-=( const gxPoint& aPoint )
+    gxBasicRect& operator-=( const PointType& aPoint )
     {
         this->Translate( -aPoint );
         return *this;
     }
     
-    gxRect& Intersect( const gxRect& aRect );
+    gxBasicRect& Intersect( const gxBasicRect& aRect );
     
-    gxRect Intersect( const gxRect& aRect ) const
+    gxBasicRect Intersect( const gxBasicRect& aRect ) const
     {
-        gxRect r = *this;
+        gxBasicRect r = *this;
         r.Intersect( aRect );
         return r;
     }
 
-    gxRect& Union( const gxRect& aRect );
-    gxRect Union( const gxRect& aRect ) const
+    gxBasicRect& Union( const gxBasicRect& aRect );
+    gxBasicRect Union( const gxBasicRect& aRect ) const
     {
-        gxRect iRect = *this;
+        gxBasicRect iRect = *this;
         iRect.Union( aRect );
         return iRect;
     }
 
     // compare rectangles
-    bool operator==( const gxRect& aRect ) const;
-    bool operator!=( const gxRect& aRect ) const
+    bool operator==( const gxBasicRect& aRect ) const;
+    bool operator!=( const gxBasicRect& aRect ) const
     {
         return !( *this == aRect );
     }
 
     // returns true if the point is (not strcitly) inside the rect
-    bool Contains( gxPix X,
-                   gxPix Y ) const;
+    bool Contains( tCoord X,
+                   tCoord Y ) const;
     
-    bool Contains( const gxPoint& aPoint ) const
+    bool Contains( const PointType& aPoint ) const
     {
         return Contains( aPoint.X, aPoint.Y );
     }
     
     // returns true if the rectangle is (not strcitly) inside the rect
-    bool Contains( const gxRect& aRect ) const;
+    bool Contains( const gxBasicRect& aRect ) const;
 
     // returns true if the rectangles have a non empty intersection
-    bool Intersects( const gxRect& aRect ) const;
+    bool Intersects( const gxBasicRect& aRect ) const;
 
     // these are like Union() but don't ignore empty rectangles
-    gxRect operator+( const gxRect& aRect ) const;
-    gxRect& operator+=( const gxRect& aRect )
+    gxBasicRect operator+( const gxBasicRect& aRect ) const;
+    gxBasicRect& operator+=( const gxBasicRect& aRect )
     {
         *this = *this + aRect;
         return *this;
@@ -311,10 +321,10 @@ public:
 
     // centre this rectangle in the given (usually, but not necessarily,
     // larger) one
-    gxRect CentreIn( const gxRect& aRect,
-                     int   dir = gxBOTH ) const
+    gxBasicRect CentreIn( const gxBasicRect& aRect,
+                          int   dir = gxBOTH ) const
     {
-        return gxRect(
+        return gxBasicRect(
             dir & gxHORIZONTAL ? aRect.X + ( aRect.width  - width  ) / 2 : X,
             dir & gxVERTICAL   ? aRect.Y + ( aRect.height - height ) / 2 : Y,
             width,
@@ -322,7 +332,7 @@ public:
         );
     }
 
-    gxRect CenterIn( const gxRect& aRect, int dir = gxBOTH ) const
+    gxBasicRect CenterIn( const gxBasicRect& aRect, int dir = gxBOTH ) const
     {
         return CentreIn( aRect, dir );
     }
@@ -338,9 +348,35 @@ public:
     void Scale( const gxScale aScale );
 
 public:
-    gxPix X, Y, width, height;
+    tCoord X, Y, width, height;
 };
 
+typedef gxBasicRect< gxFixed > gxFixedRect;
+
+// The methods out of line are instantiated once, in gxRect.cpp.
+extern template class gxBasicRect< gxPix >;
+extern template class gxBasicRect< gxFixed >;
+
+/**
+ * @brief Returns the device pixels a fixed-point rect covers, its edges
+ * rounded down (as gxRect::Scale() does).
+ */
+inline gxRect gxToPix( const gxFixedRect& aRect )
+{
+    gxPix iLeft = aRect.GetLeft().Floor();
+    gxPix iTop  = aRect.GetTop().Floor();
+
+    return gxRect( iLeft,
+                   iTop,
+                   aRect.GetRight().Floor()  - iLeft,
+                   aRect.GetBottom().Floor() - iTop );
+}
+
+inline gxFixedRect gxToFixed( const gxRect& aRect )
+{
+    return gxFixedRect( aRect.X, aRect.Y, aRect.width, aRect.height );
+}
+
 
 // Just a static dummy rect for methods returning a reference to rect that may
 // need something like null return
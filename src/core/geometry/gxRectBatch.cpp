@@ -0,0 +1,457 @@
+#include "core/geometry/gxRectBatch.h"
+
+#include <climits>
+
+#if !defined( GX_NO_SIMD ) && defined( __AVX2__ )
+    #define GX_RECT_BATCH_AVX2
+    #include <immintrin.h>
+#elif !defined( GX_NO_SIMD ) && ( defined( __SSE2__ ) || defined( _M_X64 ) )
+    #define GX_RECT_BATCH_SSE2
+    #include <emmintrin.h>
+    #ifdef __SSE4_1__
+        #include <smmintrin.h>
+    #endif
+#elif !defined( GX_NO_SIMD ) && ( defined( __ARM_NEON ) || defined( __ARM_NEON__ ) )
+    #define GX_RECT_BATCH_NEON
+    #include <arm_neon.h>
+#endif
+
+#if defined( GX_RECT_BATCH_AVX2 ) || defined( GX_RECT_BATCH_SSE2 ) || defined( GX_RECT_BATCH_NEON )
+    #define GX_RECT_BATCH_SIMD
+#endif
+
+// -----------
+// The vector operations the kernels are written with, per instruction set.
+// Masks have all bits of a lane set where true.
+
+#ifdef GX_RECT_BATCH_SIMD
+namespace
+{
+#if defined( GX_RECT_BATCH_AVX2 )
+    typedef __m256i Ints;
+    const size_t Lanes = 8;
+
+    inline Ints Load( const gxPix *aPix ) { return _mm256_loadu_si256( reinterpret_cast< const __m256i* >( aPix ) ); }
+    inline void Store( gxPix *aPix, Ints aV ) { _mm256_storeu_si256( reinterpret_cast< __m256i* >( aPix ), aV ); }
+    inline Ints Splat( gxPix aV ) { return _mm256_set1_epi32( aV ); }
+    inline Ints Offset( Ints aV, Ints aDelta ) { return _mm256_add_epi32( aV, aDelta ); }
+    inline Ints Or( Ints aA, Ints aB ) { return _mm256_or_si256( aA, aB ); }
+    inline Ints Greater( Ints aA, Ints aB ) { return _mm256_cmpgt_epi32( aA, aB ); }
+    inline Ints Equal( Ints aA, Ints aB ) { return _mm256_cmpeq_epi32( aA, aB ); }
+    inline Ints Min( Ints aA, Ints aB ) { return _mm256_min_epi32( aA, aB ); }
+    inline Ints Max( Ints aA, Ints aB ) { return _mm256_max_epi32( aA, aB ); }
+    inline Ints Select( Ints aMask, Ints aA, Ints aB ) { return _mm256_blendv_epi8( aB, aA, aMask ); }
+    inline int  Bits( Ints aMask ) { return _mm256_movemask_ps( _mm256_castsi256_ps( aMask ) ); }
+
+    inline Ints ScaleFloor( Ints aV, float aScale )
+    {
+        __m256 iV = _mm256_mul_ps( _mm256_cvtepi32_ps( aV ), _mm256_set1_ps( aScale ) );
+        return _mm256_cvttps_epi32( _mm256_floor_ps( iV ) );
+    }
+#elif defined( GX_RECT_BATCH_SSE2 )
+    typedef __m128i Ints;
+    const size_t Lanes = 4;
+
+    inline Ints Load( const gxPix *aPix ) { return _mm_loadu_si128( reinterpret_cast< const __m128i* >( aPix ) ); }
+    inline void Store( gxPix *aPix, Ints aV ) { _mm_storeu_si128( reinterpret_cast< __m128i* >( aPix ), aV ); }
+    inline Ints Splat( gxPix aV ) { return _mm_set1_epi32( aV ); }
+    inline Ints Offset( Ints aV, Ints aDelta ) { return _mm_add_epi32( aV, aDelta ); }
+    inline Ints Or( Ints aA, Ints aB ) { return _mm_or_si128( aA, aB ); }
+    inline Ints Greater( Ints aA, Ints aB ) { return _mm_cmpgt_epi32( aA, aB ); }
+    inline Ints Equal( Ints aA, Ints aB ) { return _mm_cmpeq_epi32( aA, aB ); }
+    inline int  Bits( Ints aMask ) { return _mm_movemask_ps( _mm_castsi128_ps( aMask ) ); }
+
+  #ifdef __SSE4_1__
+    inline Ints Select( Ints aMask, Ints aA, Ints aB ) { return _mm_blendv_epi8( aB, aA, aMask ); }
+    inline Ints Min( Ints aA, Ints aB ) { return _mm_min_epi32( aA, aB ); }
+    inline Ints Max( Ints aA, Ints aB ) { return _mm_max_epi32( aA, aB ); }
+
+    inline Ints ScaleFloor( Ints aV, float aScale )
+    {
+        __m128 iV = _mm_mul_ps( _mm_cvtepi32_ps( aV ), _mm_set1_ps( aScale ) );
+        return _mm_cvttps_epi32( _mm_floor_ps( iV ) );
+    }
+  #else
+    inline Ints Select( Ints aMask, Ints aA, Ints aB ) { return _mm_or_si128( _mm_and_si128( aMask, aA ), _mm_andnot_si128( aMask, aB ) ); }
+    inline Ints Min( Ints aA, Ints aB ) { return Select( Greater( aA, aB ), aB, aA ); }
+    inline Ints Max( Ints aA, Ints aB ) { return Select( Greater( aA, aB ), aA, aB ); }
+
+    inline Ints ScaleFloor( Ints aV, float aScale )
+    {
+        // Truncate, then take one off where that rounded up (the mask is -1).
+        __m128  iV = _mm_mul_ps( _mm_cvtepi32_ps( aV ), _mm_set1_ps( aScale ) );
+        __m128i iT = _mm_cvttps_epi32( iV );
+        return _mm_add_epi32( iT, _mm_castps_si128( _mm_cmpgt_ps( _mm_cvtepi32_ps( iT ), iV ) ) );
+    }
+  #endif
+#elif defined( GX_RECT_BATCH_NEON )
+    typedef int32x4_t Ints;
+    const size_t Lanes = 4;
+
+    inline Ints Load( const gxPix *aPix ) { return vld1q_s32( aPix ); }
+    inline void Store( gxPix *aPix, Ints aV ) { vst1q_s32( aPix, aV ); }
+    inline Ints Splat( gxPix aV ) { return vdupq_n_s32( aV ); }
+    inline Ints Offset( Ints aV, Ints aDelta ) { return vaddq_s32( aV, aDelta ); }
+    inline Ints Or( Ints aA, Ints aB ) { return vorrq_s32( aA, aB ); }
+    inline Ints Greater( Ints aA, Ints aB ) { return vreinterpretq_s32_u32( vcgtq_s32( aA, aB ) ); }
+    inline Ints Equal( Ints aA, Ints aB ) { return vreinterpretq_s32_u32( vceqq_s32( aA, aB ) ); }
+    inline Ints Min( Ints aA, Ints aB ) { return vminq_s32( aA, aB ); }
+    inline Ints Max( Ints aA, Ints aB ) { return vmaxq_s32( aA, aB ); }
+    inline Ints Select( Ints aMask, Ints aA, Ints aB ) { return vbslq_s32( vreinterpretq_u32_s32( aMask ), aA, aB ); }
+
+    inline int Bits( Ints aMask )
+    {
+        int32_t iLanes[4];
+        vst1q_s32( iLanes, aMask );
+        return ( iLanes[0] & 1 ) | ( iLanes[1] & 2 ) | ( iLanes[2] & 4 ) | ( iLanes[3] & 8 );
+    }
+
+    inline Ints ScaleFloor( Ints aV, float aScale )
+    {
+        // Truncate, then take one off where that rounded up (the mask is -1).
+        float32x4_t iV = vmulq_n_f32( vcvtq_f32_s32( aV ), aScale );
+        int32x4_t   iT = vcvtq_s32_f32( iV );
+        return vaddq_s32( iT, vreinterpretq_s32_u32( vcgtq_f32( vcvtq_f32_s32( iT ), iV ) ) );
+    }
+#endif
+
+    const int AllLanes = ( 1 << Lanes ) - 1;
+
+    // Returns the bits of the lanes not intersecting a rect (as with
+    // gxRect::Intersects(), the edges count as inside).
+    inline int Misses( Ints aLeft,  Ints aTop,  Ints aRight,  Ints aBottom,
+                       Ints aRectLeft, Ints aRectTop, Ints aRectRight, Ints aRectBottom )
+    {
+        return Bits( Or( Greater( Max( aLeft, aRectLeft ), Min( aRight,  aRectRight ) ),
+                         Greater( Max( aTop,  aRectTop ),  Min( aBottom, aRectBottom ) ) ) );
+    }
+
+    // Returns the bits of the lanes not covering a rect (edges included).
+    inline int Uncovers( Ints aLeft,  Ints aTop,  Ints aRight,  Ints aBottom,
+                         Ints aRectLeft, Ints aRectTop, Ints aRectRight, Ints aRectBottom )
+    {
+        return Bits( Or( Or( Greater( aLeft, aRectLeft ), Greater( aTop, aRectTop ) ),
+                         Or( Greater( aRectRight, aRight ), Greater( aRectBottom, aBottom ) ) ) );
+    }
+
+    inline gxPix ReduceMin( Ints aV )
+    {
+        gxPix iLanes[ Lanes ];
+        Store( iLanes, aV );
+
+        gxPix iMin = iLanes[0];
+        for ( size_t i = 1; i < Lanes; i++ )
+            iMin = gxMin( iMin, iLanes[i] );
+
+        return iMin;
+    }
+
+    inline gxPix ReduceMax( Ints aV )
+    {
+        gxPix iLanes[ Lanes ];
+        Store( iLanes, aV );
+
+        gxPix iMax = iLanes[0];
+        for ( size_t i = 1; i < Lanes; i++ )
+            iMax = gxMax( iMax, iLanes[i] );
+
+        return iMax;
+    }
+}
+#endif // GX_RECT_BATCH_SIMD
+
+// -----------
+
+// Returns whether or not a rect intersects another one, by their edges (as
+// with gxRect::Intersects()).
+static inline bool Intersects( gxPix aLeft,     gxPix aTop,     gxPix aRight,     gxPix aBottom,
+                               gxPix aRectLeft, gxPix aRectTop, gxPix aRectRight, gxPix aRectBottom )
+{
+    return gxMax( aLeft, aRectLeft ) <= gxMin( aRight,  aRectRight ) &&
+           gxMax( aTop,  aRectTop )  <= gxMin( aBottom, aRectBottom );
+}
+
+// Scales the edges from a given one on, as gxRect::Scale() does.
+static void ScaleEdges( std::vector< gxPix > &aEdges,
+                        size_t               aFrom,
+                        float                aScale )
+{
+    for ( size_t i = aFrom; i < aEdges.size(); i++ )
+        aEdges[i] = gxFloor( aEdges[i] * aScale );
+}
+
+void gxRectBatch::Assign( gxRects const &aRects )
+{
+    Clear();
+
+    mLeft.reserve( aRects.size() );
+    mTop.reserve( aRects.size() );
+    mRight.reserve( aRects.size() );
+    mBottom.reserve( aRects.size() );
+
+    for ( size_t i = 0; i < aRects.size(); i++ )
+        Add( aRects[i] );
+}
+
+void gxRectBatch::Add( gxRect const &aRect )
+{
+    mLeft.push_back( aRect.GetLeft() );
+    mTop.push_back( aRect.GetTop() );
+    mRight.push_back( aRect.GetRight() );
+    mBottom.push_back( aRect.GetBottom() );
+}
+
+void gxRectBatch::Clear()
+{
+    mLeft.clear();
+    mTop.clear();
+    mRight.clear();
+    mBottom.clear();
+}
+
+size_t gxRectBatch::Intersects( gxRect const   &aRect,
+                                unsigned char *aResults ) const
+{
+    const gxPix iLeft   = aRect.GetLeft();
+    const gxPix iTop    = aRect.GetTop();
+    const gxPix iRight  = aRect.GetRight();
+    const gxPix iBottom = aRect.GetBottom();
+
+    size_t iCount = 0;
+    size_t i = 0;
+
+#ifdef GX_RECT_BATCH_SIMD
+    const Ints iRectLeft   = Splat( iLeft );
+    const Ints iRectTop    = Splat( iTop );
+    const Ints iRectRight  = Splat( iRight );
+    const Ints iRectBottom = Splat( iBottom );
+
+    for ( ; i + Lanes <= GetCount(); i += Lanes )
+    {
+        int iHits = ~Misses( Load( &mLeft[i] ), Load( &mTop[i] ), Load( &mRight[i] ), Load( &mBottom[i] ),
+                             iRectLeft, iRectTop, iRectRight, iRectBottom ) & AllLanes;
+
+        for ( size_t j = 0; j < Lanes; j++ )
+        {
+            aResults[ i + j ] = ( unsigned char )( ( iHits >> j ) & 1 );
+            iCount += aResults[ i + j ];
+        }
+    }
+#endif
+
+    for ( ; i < GetCount(); i++ )
+    {
+        aResults[i] = ::Intersects( mLeft[i], mTop[i], mRight[i], mBottom[i],
+                                    iLeft, iTop, iRight, iBottom ) ? 1 : 0;
+        iCount += aResults[i];
+    }
+
+    return iCount;
+}
+
+bool gxRectBatch::IntersectsAny( gxRect const &aRect ) const
+{
+    const gxPix iLeft   = aRect.GetLeft();
+    const gxPix iTop    = aRect.GetTop();
+    const gxPix iRight  = aRect.GetRight();
+    const gxPix iBottom = aRect.GetBottom();
+
+    size_t i = 0;
+
+#ifdef GX_RECT_BATCH_SIMD
+    const Ints iRectLeft   = Splat( iLeft );
+    const Ints iRectTop    = Splat( iTop );
+    const Ints iRectRight  = Splat( iRight );
+    const Ints iRectBottom = Splat( iBottom );
+
+    for ( ; i + Lanes <= GetCount(); i += Lanes )
+    {
+        if ( Misses( Load( &mLeft[i] ), Load( &mTop[i] ), Load( &mRight[i] ), Load( &mBottom[i] ),
+                     iRectLeft, iRectTop, iRectRight, iRectBottom ) != AllLanes )
+            return true;
+    }
+#endif
+
+    for ( ; i < GetCount(); i++ )
+    {
+        if ( ::Intersects( mLeft[i], mTop[i], mRight[i], mBottom[i],
+                           iLeft, iTop, iRight, iBottom ) )
+            return true;
+    }
+
+    return false;
+}
+
+bool gxRectBatch::CoversAny( gxRect const &aRect ) const
+{
+    const gxPix iLeft   = aRect.GetLeft();
+    const gxPix iTop    = aRect.GetTop();
+    const gxPix iRight  = aRect.GetRight();
+    const gxPix iBottom = aRect.GetBottom();
+
+    size_t i = 0;
+
+#ifdef GX_RECT_BATCH_SIMD
+    const Ints iRectLeft   = Splat( iLeft );
+    const Ints iRectTop    = Splat( iTop );
+    const Ints iRectRight  = Splat( iRight );
+    const Ints iRectBottom = Splat( iBottom );
+
+    for ( ; i + Lanes <= GetCount(); i += Lanes )
+    {
+        if ( Uncovers( Load( &mLeft[i] ), Load( &mTop[i] ), Load( &mRight[i] ), Load( &mBottom[i] ),
+                       iRectLeft, iRectTop, iRectRight, iRectBottom ) != AllLanes )
+            return true;
+    }
+#endif
+
+    for ( ; i < GetCount(); i++ )
+    {
+        if ( mLeft[i]  <= iLeft  && mTop[i]    <= iTop &&
+             mRight[i] >= iRight && mBottom[i] >= iBottom )
+            return true;
+    }
+
+    return false;
+}
+
+void gxRectBatch::Union( gxRect &aBounds ) const
+{
+    if ( IsEmpty() )
+        return;
+
+    // The bounds of the rects that aren't empty (those with no width or no
+    // height, which gxRect::Union() ignores).
+    gxPix iLeft   = INT_MAX;
+    gxPix iTop    = INT_MAX;
+    gxPix iRight  = INT_MIN;
+    gxPix iBottom = INT_MIN;
+    bool  isAny   = false;
+
+    size_t i = 0;
+
+#ifdef GX_RECT_BATCH_SIMD
+    const Ints iMaxPix = Splat( INT_MAX );
+    const Ints iMinPix = Splat( INT_MIN );
+
+    Ints iLefts   = iMaxPix;
+    Ints iTops    = iMaxPix;
+    Ints iRights  = iMinPix;
+    Ints iBottoms = iMinPix;
+    int  iAnyBits = 0;
+
+    for ( ; i + Lanes <= GetCount(); i += Lanes )
+    {
+        Ints iL = Load( &mLeft[i] );
+        Ints iT = Load( &mTop[i] );
+        Ints iR = Load( &mRight[i] );
+        Ints iB = Load( &mBottom[i] );
+
+        Ints iEmpty = Or( Equal( iR, iL ), Equal( iB, iT ) );
+
+        iLefts   = Min( iLefts,   Select( iEmpty, iMaxPix, iL ) );
+        iTops    = Min( iTops,    Select( iEmpty, iMaxPix, iT ) );
+        iRights  = Max( iRights,  Select( iEmpty, iMinPix, iR ) );
+        iBottoms = Max( iBottoms, Select( iEmpty, iMinPix, iB ) );
+        iAnyBits |= ~Bits( iEmpty ) & AllLanes;
+    }
+
+    iLeft   = ReduceMin( iLefts );
+    iTop    = ReduceMin( iTops );
+    iRight  = ReduceMax( iRights );
+    iBottom = ReduceMax( iBottoms );
+    isAny   = iAnyBits != 0;
+#endif
+
+    for ( ; i < GetCount(); i++ )
+    {
+        if ( mRight[i] == mLeft[i] || mBottom[i] == mTop[i] )
+            continue;
+
+        iLeft   = gxMin( iLeft,   mLeft[i] );
+        iTop    = gxMin( iTop,    mTop[i] );
+        iRight  = gxMax( iRight,  mRight[i] );
+        iBottom = gxMax( iBottom, mBottom[i] );
+        isAny   = true;
+    }
+
+    // All empty: one by one, each would have replaced the (empty) bounds.
+    if ( !isAny )
+    {
+        if ( !aBounds.width || !aBounds.height )
+            aBounds = Get( GetCount() - 1 );
+
+        return;
+    }
+
+    if ( aBounds.width && aBounds.height )
+    {
+        iLeft   = gxMin( iLeft,   aBounds.GetLeft() );
+        iTop    = gxMin( iTop,    aBounds.GetTop() );
+        iRight  = gxMax( iRight,  aBounds.GetRight() );
+        iBottom = gxMax( iBottom, aBounds.GetBottom() );
+    }
+
+    aBounds = gxRect( iLeft, iTop, iRight - iLeft, iBottom - iTop );
+}
+
+void gxRectBatch::Scale( gxScale const &aScale )
+{
+    size_t i = 0;
+
+#ifdef GX_RECT_BATCH_SIMD
+    for ( ; i + Lanes <= GetCount(); i += Lanes )
+    {
+        Store( &mLeft[i],   ScaleFloor( Load( &mLeft[i] ),   aScale.X ) );
+        Store( &mTop[i],    ScaleFloor( Load( &mTop[i] ),    aScale.Y ) );
+        Store( &mRight[i],  ScaleFloor( Load( &mRight[i] ),  aScale.X ) );
+        Store( &mBottom[i], ScaleFloor( Load( &mBottom[i] ), aScale.Y ) );
+    }
+#endif
+
+    ScaleEdges( mLeft,   i, aScale.X );
+    ScaleEdges( mTop,    i, aScale.Y );
+    ScaleEdges( mRight,  i, aScale.X );
+    ScaleEdges( mBottom, i, aScale.Y );
+}
+
+void gxRectBatch::Translate( gxPoint const &aDelta )
+{
+    size_t i = 0;
+
+#ifdef GX_RECT_BATCH_SIMD
+    const Ints iDeltaX = Splat( aDelta.X );
+    const Ints iDeltaY = Splat( aDelta.Y );
+
+    for ( ; i + Lanes <= GetCount(); i += Lanes )
+    {
+        Store( &mLeft[i],   Offset( Load( &mLeft[i] ),   iDeltaX ) );
+        Store( &mTop[i],    Offset( Load( &mTop[i] ),    iDeltaY ) );
+        Store( &mRight[i],  Offset( Load( &mRight[i] ),  iDeltaX ) );
+        Store( &mBottom[i], Offset( Load( &mBottom[i] ), iDeltaY ) );
+    }
+#endif
+
+    for ( ; i < GetCount(); i++ )
+    {
+        mLeft[i]   += aDelta.X;
+        mTop[i]    += aDelta.Y;
+        mRight[i]  += aDelta.X;
+        mBottom[i] += aDelta.Y;
+    }
+}
+
+const char* gxRectBatch::GetKernelName()
+{
+#if defined( GX_RECT_BATCH_AVX2 )
+    return "AVX2";
+#elif defined( GX_RECT_BATCH_SSE2 ) && defined( __SSE4_1__ )
+    return "SSE4.1";
+#elif defined( GX_RECT_BATCH_SSE2 )
+    return "SSE2";
+#elif defined( GX_RECT_BATCH_NEON )
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,106 @@
+#ifndef gxRectBatch_h
+#define gxRectBatch_h
+
+#include "core/geometry/gxGeometry.h"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief A batch of rects, kept as arrays of their edges (a structure of
+ * arrays), for testing and transforming many rects at once.
+ *
+ * Culling, damage tests and bounds aggregation test one rect against many,
+ * or reduce many to one. Kept by edge, those are done several rects at a
+ * time with SIMD kernels - AVX2, SSE2 (SSE4.1 if available) or NEON,
+ * whichever the compiler targets - with scalar code for the rest of the
+ * rects and for other targets. Defining GX_NO_SIMD leaves only the scalar
+ * code.
+ *
+ * All kernels give the same results as the matching {@link gxRect} methods
+ * applied one rect at a time.
+ */
+class gxRectBatch
+{
+public:
+    gxRectBatch() {}
+
+    explicit gxRectBatch( gxRects const &aRects )
+    {
+        Assign( aRects );
+    }
+
+    /**
+     * @brief Replaces the rects of the batch.
+     */
+    void Assign( gxRects const &aRects );
+
+    void Add( gxRect const &aRect );
+
+    void Clear();
+
+    size_t GetCount() const { return mLeft.size(); }
+
+    bool IsEmpty() const { return mLeft.empty(); }
+
+    gxRect Get( size_t aIndex ) const
+    {
+        return gxRect( mLeft[ aIndex ],
+                       mTop[ aIndex ],
+                       mRight[ aIndex ]  - mLeft[ aIndex ],
+                       mBottom[ aIndex ] - mTop[ aIndex ] );
+    }
+
+    /**
+     * @brief Tests which rects intersect a rect (as with
+     * gxRect::Intersects()).
+     * @param aRect The rect to test against.
+     * @param aResults Receives 1 for each rect intersecting, 0 for the others
+     *        (GetCount() of them).
+     * @return The number of rects intersecting.
+     */
+    size_t Intersects( gxRect const   &aRect,
+                       unsigned char *aResults ) const;
+
+    /**
+     * @brief Returns whether or not any of the rects intersects a rect.
+     */
+    bool IntersectsAny( gxRect const &aRect ) const;
+
+    /**
+     * @brief Returns whether or not any of the rects covers a rect entirely
+     * (edges included).
+     */
+    bool CoversAny( gxRect const &aRect ) const;
+
+    /**
+     * @brief Unions the rects into a rect, as would calling gxRect::Union()
+     * with each in turn (for rects of no negative size).
+     * @param aBounds The rect to union into.
+     */
+    void Union( gxRect &aBounds ) const;
+
+    /**
+     * @brief Scales all rects (as with gxRect::Scale()).
+     */
+    void Scale( gxScale const &aScale );
+
+    /**
+     * @brief Moves all rects by a delta.
+     */
+    void Translate( gxPoint const &aDelta );
+
+    /**
+     * @brief Returns the name of the SIMD kernels compiled in ("AVX2",
+     * "SSE2", "SSE4.1", "NEON" or "scalar").
+     */
+    static const char* GetKernelName();
+
+private:
+    std::vector< gxPix > mLeft;
+    std::vector< gxPix > mTop;
+    std::vector< gxPix > mRight;
+    std::vector< gxPix > mBottom;
+};
+
+#endif //gxRectBatch_h
@@ -8,61 +8,68 @@
 
 #include "core/geometry/gxGeometry.h"
 
-class gxSize
+/**
+ * @brief A size, of coordinates of a given type (see gxSize for gxPix and
+ * gxFixedSize for gxFixed).
+ */
+template< class tCoord >
+class gxBasicSize
 {
 public:
+  typedef tCoord CoordType;
+
   // members are public for compatibility, don't use them directly.
-  gxPix X, Y;
+  tCoord X, Y;
 
   // constructors
-  gxSize() : X(0), Y(0) { }
-  gxSize(gxPix aX, gxPix aY) : X(aX), Y(aY) { }
+  gxBasicSize() : X(0), Y(0) { }
+  gxBasicSize(tCoord aX, tCoord aY) : X(aX), Y(aY) { }
 
   // no copy ctor or assignment operator - the defaults are ok
 
-  bool operator==(const gxSize& aSize) const { return X == aSize.X && Y == aSize.Y; }
-  bool operator!=(const gxSize& aSize) const { return X != aSize.X || Y != aSize.Y; }
+  bool operator==(const gxBasicSize& aSize) const { return X == aSize.X && Y == aSize.Y; }
+  bool operator!=(const gxBasicSize& aSize) const { return X != aSize.X || Y != aSize.Y; }
 
-  gxSize operator+(const gxSize& aSize) const { return gxSize(X + aSize.X, Y + aSize.Y); }
-  gxSize operator-(const gxSize& aSize) const { return gxSize(X - aSize.X, Y - aSize.Y); }
-  gxSize operator/(gxPix i) const { return gxSize(X / i, Y / i); }
-  gxSize operator*(gxPix i) const { return gxSize(X * i, Y * i); }
+  gxBasicSize operator+(const gxBasicSize& aSize) const { return gxBasicSize(X + aSize.X, Y + aSize.Y); }
+  gxBasicSize operator-(const gxBasicSize& aSize) const { return gxBasicSize(X - aSize.X, Y - aSize.Y); }
+  gxBasicSize operator/(tCoord i) const { return gxBasicSize(X / i, Y / i); }
+  gxBasicSize operator*(tCoord i) const { return gxBasicSize(X * i, Y * i); }
 
-  gxSize& operator+=(const gxSize& aSize) { X += aSize.X; Y += aSize.Y; return *this; }
-  gxSize& operator-=(const gxSize& aSize) { X -= aSize.X; Y -= aSize.Y; return *this; }
-  gxSize& operator/=(const gxPix i) { X /= i; Y /= i; return *this; }
-  gxSize& operator*=(const gxPix i) { X *= i; Y *= i; return *this; }
+  gxBasicSize& operator+=(const gxBasicSize& aSize) { X += aSize.X; Y += aSize.Y; return *this; }
+  gxBasicSize& operator-=(const gxBasicSize& aSize) { X -= aSize.X; Y -= aSize.Y; return *this; }
+  gxBasicSize& operator/=(const tCoord i) { X /= i; Y /= i; return *this; }
+  gxBasicSize& operator*=(const tCoord i) { X *= i; Y *= i; return *this; }
 
-  void IncTo(const gxSize& aSize)
+  void IncTo(const gxBasicSize& aSize)
     { if ( aSize.X > X ) X = aSize.X; if ( aSize.Y > Y ) Y = aSize.Y; }
-  void DecTo(const gxSize& aSize)
+  void DecTo(const gxBasicSize& aSize)
     { if ( aSize.X < X ) X = aSize.X; if ( aSize.Y < Y ) Y = aSize.Y; }
 
-  void IncBy(gxPix dx, gxPix dy) { X += dx; Y += dy; }
-  void IncBy(const gxSize& aSize) { IncBy(aSize.X, aSize.Y); }
-  void IncBy(gxPix d) { IncBy(d, d); }
+  void IncBy(tCoord dx, tCoord dy) { X += dx; Y += dy; }
+  void IncBy(const gxBasicSize& aSize) { IncBy(aSize.X, aSize.Y); }
+  void IncBy(tCoord d) { IncBy(d, d); }
 
-  void DecBy(gxPix dx, gxPix dy) { IncBy(-dx, -dy); }
-  void DecBy(const gxSize& aSize) { DecBy(aSize.X, aSize.Y); }
-  void DecBy(gxPix d) { DecBy(d, d); }
+  void DecBy(tCoord dx, tCoord dy) { IncBy(-dx, -dy); }
+  void DecBy(const gxBasicSize& aSize) { DecBy(aSize.X, aSize.Y); }
+  void DecBy(tCoord d) { DecBy(d, d); }
 
 
-  gxSize& Scale(float aScaleX, float aScaleY)
-    { X = gxFloor(X * aScaleX); Y = gxFloor(Y * aScaleY); return *this; }
+  gxBasicSize& Scale(float aScaleX, float aScaleY)
+    { X = gxScaleCoord(X, aScaleX); Y = gxScaleCoord(Y, aScaleY); return *this; }
 
   // accessors
-  void Set(gxPix aX, gxPix aY) { X = aX; Y = aY; }
-  void SetWidth(gxPix aW) { X = aW; }
-  void SetHeight(gxPix aH) { Y = aH; }
+  void Set(tCoord aX, tCoord aY) { X = aX; Y = aY; }
+  void SetWidth(tCoord aW) { X = aW; }
+  void SetHeight(tCoord aH) { Y = aH; }
 
-  gxPix GetWidth() const { return X; }
-  gxPix GetHeight() const { return Y; }
+  tCoord GetWidth() const { return X; }
+  tCoord GetHeight() const { return Y; }
 
   bool IsFullySpecified() const { return X != gxDefaultCoord && Y != gxDefaultCoord; }
 
   // combine this size with the other one replacing the default (i.e. equal
   // to gxDefaultCoord) components of this object with those of the other
-  void SetDefaults(const gxSize& size)
+  void SetDefaults(const gxBasicSize& size)
   {
     if ( X == gxDefaultCoord )
       X = size.X;
@@ -71,8 +78,18 @@ public:
   }
 
   // compatibility
-  gxPix GetX() const { return X; }
-  gxPix GetY() const { return Y; }
+  tCoord GetX() const { return X; }
+  tCoord GetY() const { return Y; }
 };
 
+typedef gxBasicSize< gxPix >   gxSize;
+typedef gxBasicSize< gxFixed > gxFixedSize;
+
+// Returns the whole pixels of a fixed-point size (rounded down).
+inline gxSize gxToPix(const gxFixedSize& aSize)
+  { return gxSize(aSize.X.Floor(), aSize.Y.Floor()); }
+
+inline gxFixedSize gxToFixed(const gxSize& aSize)
+  { return gxFixedSize(aSize.X, aSize.Y); }
+
 #endif // gxSize_h
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "core/geometry/gxSpatialGrid.h"
+
+#include <algorithm>
+
+gxSpatialGrid::gxSpatialGrid( gxPix aCellSize ) :
+    mCellSize( gxMax( aCellSize, 1 ) )
+{
+}
+
+int gxSpatialGrid::GetCell( gxPix aCoordinate ) const
+{
+    // Round down for negative coordinates too
+    return aCoordinate >= 0 ? aCoordinate / mCellSize
+                            : -( ( -aCoordinate + mCellSize - 1 ) / mCellSize );
+}
+
+void gxSpatialGrid::Insert( int           aId,
+                            const gxRect& aRect )
+{
+    int iLeft   = GetCell( aRect.GetLeft() );
+    int iRight  = GetCell( aRect.GetRight() );
+    int iTop    = GetCell( aRect.GetTop() );
+    int iBottom = GetCell( aRect.GetBottom() );
+
+    for ( int iColumn = iLeft; iColumn <= iRight; ++iColumn )
+    {
+        for ( int iRow = iTop; iRow <= iBottom; ++iRow )
+        {
+            mCells[ GetKey( iColumn, iRow ) ].push_back( aId );
+        }
+    }
+}
+
+void gxSpatialGrid::Remove( int           aId,
+                            const gxRect& aRect )
+{
+    int iLeft   = GetCell( aRect.GetLeft() );
+    int iRight  = GetCell( aRect.GetRight() );
+    int iTop    = GetCell( aRect.GetTop() );
+    int iBottom = GetCell( aRect.GetBottom() );
+
+    for ( int iColumn = iLeft; iColumn <= iRight; ++iColumn )
+    {
+        for ( int iRow = iTop; iRow <= iBottom; ++iRow )
+        {
+            CellMap::iterator iCell = mCells.find( GetKey( iColumn, iRow ) );
+
+            if ( iCell == mCells.end() )
+                continue;
+
+            std::vector< int >& iIds = iCell->second;
+
+            std::vector< int >::iterator iFound = std::find( iIds.begin(), iIds.end(), aId );
+
+            if ( iFound != iIds.end() )
+            {
+                *iFound = iIds.back();
+                iIds.pop_back();
+            }
+
+            if ( iIds.empty() )
+                mCells.erase( iCell );
+        }
+    }
+}
+
+void gxSpatialGrid::Query( const gxRect&       aArea,
+                           std::vector< int >& aIds ) const
+{
+    aIds.clear();
+
+    int iLeft   = GetCell( aArea.GetLeft() );
+    int iRight  = GetCell( aArea.GetRight() );
+    int iTop    = GetCell( aArea.GetTop() );
+    int iBottom = GetCell( aArea.GetBottom() );
+
+    for ( int iColumn = iLeft; iColumn <= iRight; ++iColumn )
+    {
+        for ( int iRow = iTop; iRow <= iBottom; ++iRow )
+        {
+            CellMap::const_iterator iCell = mCells.find( GetKey( iColumn, iRow ) );
+
+            if ( iCell != mCells.end() )
+                aIds.insert( aIds.end(), iCell->second.begin(), iCell->second.end() );
+        }
+    }
+
+    // Rects spanning several cells were added once per cell
+    std::sort( aIds.begin(), aIds.end() );
+    aIds.erase( std::unique( aIds.begin(), aIds.end() ), aIds.end() );
+}
+
+void gxSpatialGrid::Clear()
+{
+    mCells.clear();
+}
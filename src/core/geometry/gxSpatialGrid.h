@@ -0,0 +1,81 @@
+#ifndef gxSpatialGrid_h
+#define gxSpatialGrid_h
+
+#include "core/geometry/gxRect.h"
+
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief A spatial index of rects, bucketing them in the cells of a uniform
+ * grid.
+ *
+ * Each rect is recorded, by an id given by the caller, in all the cells it
+ * overlaps. Querying an area only visits the cells overlapping it, so the
+ * cost depends on the area and the local density rather than on the total
+ * number of rects. Cells are hashed, so the grid is unbounded and only cells
+ * with rects take memory.
+ */
+class gxSpatialGrid
+{
+public:
+    /**
+     * @param aCellSize The width and height of a grid cell.
+     */
+    gxSpatialGrid( gxPix aCellSize = 128 );
+
+    /**
+     * @brief Adds a rect to the index.
+     *
+     * @param aId The id of the rect.
+     * @param aRect The rect.
+     */
+    void Insert( int           aId,
+                 const gxRect& aRect );
+
+    /**
+     * @brief Removes a rect from the index.
+     *
+     * @param aId The id of the rect.
+     * @param aRect The rect, as it was inserted.
+     */
+    void Remove( int           aId,
+                 const gxRect& aRect );
+
+    /**
+     * @brief Returns the ids of the rects that may intersect an area.
+     *
+     * These are the rects sharing a cell with the area, so callers test for
+     * actual intersection.
+     *
+     * @param aArea The area.
+     * @param aIds Receives the ids, sorted and each one once.
+     */
+    void Query( const gxRect&       aArea,
+                std::vector< int >& aIds ) const;
+
+    /**
+     * @brief Removes all rects.
+     */
+    void Clear();
+
+private:
+    typedef long long CellKey;
+    typedef std::unordered_map< CellKey, std::vector< int > > CellMap;
+
+    gxPix   mCellSize;
+    CellMap mCells;
+
+    /**
+     * @brief Returns the cell containing a coordinate, on either axis.
+     */
+    int GetCell( gxPix aCoordinate ) const;
+
+    static CellKey GetKey( int aColumn,
+                           int aRow )
+    {
+        return ( CellKey( aColumn ) << 32 ) | CellKey( unsigned( aRow ) );
+    }
+};
+
+#endif //gxSpatialGrid_h
@@ -1,6 +1,10 @@
 #ifndef gxAssert_h
 #define gxAssert_h
 
-#include "adapters/wx/gxAssert.h"
+#ifdef GX_HEADLESS
+    #include "adapters/headless/gxAssert.h"
+#else
+    #include "adapters/wx/gxAssert.h"
+#endif
 
 #endif // gxAssert_h
\ No newline at end of file
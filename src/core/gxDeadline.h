@@ -0,0 +1,33 @@
+#ifndef gxDeadline_h
+#define gxDeadline_h
+
+#include <chrono>
+
+/**
+ * @brief A point in time by which some work should stop, so long work can be
+ * done in slices (say, one per frame) without blocking the event loop.
+ *
+ * Work checks HasPassed() between its steps, and leaves the remaining steps
+ * for the next slice once it returns true.
+ */
+class gxDeadline
+{
+public:
+    /**
+     * @param aMilliseconds The time from now till the deadline.
+     */
+    gxDeadline( long aMilliseconds )
+      : mEnd( Clock::now() + std::chrono::milliseconds( aMilliseconds ) ) {}
+
+    /**
+     * @brief Returns whether or not the deadline has passed.
+     */
+    bool HasPassed() const { return Clock::now() >= mEnd; }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point mEnd;
+};
+
+#endif //gxDeadline_h
@@ -0,0 +1,91 @@
+#include "core/gxLabelAtlas.h"
+
+// The space left between labels, so glyphs overhanging their text extent
+// don't run into the next label.
+static const gxPix LabelSpacing = 1;
+
+gxLabelAtlas::gxLabelAtlas( gxPix aSize ) :
+    mSize( aSize ),
+    mGeneration( 0 ),
+    mShelfTop( 0 ),
+    mShelfHeight( 0 ),
+    mShelfEnd( 0 )
+{
+}
+
+gxLabelAtlas& gxLabelAtlas::Get()
+{
+    static gxLabelAtlas sAtlas;
+    return sAtlas;
+}
+
+size_t gxLabelAtlas::GetKey( gxFontId        aFont,
+                             const gxString& aText,
+                             bool            isHorizontal )
+{
+    return gxTextCache::Hash( aText, aFont * 2 + ( isHorizontal ? 1 : 0 ) );
+}
+
+bool gxLabelAtlas::Find( gxFontId        aFont,
+                         const gxString& aText,
+                         bool            isHorizontal,
+                         gxRect&         aRect ) const
+{
+    EntryMap::const_iterator iFound = mEntries.find( GetKey( aFont, aText, isHorizontal ) );
+
+    // Keys are hashes, so the entry found may be of another label.
+    if ( iFound == mEntries.end() ||
+         iFound->second.mFont       != aFont ||
+         iFound->second.mHorizontal != isHorizontal ||
+         iFound->second.mText       != aText )
+        return false;
+
+    aRect = iFound->second.mRect;
+    return true;
+}
+
+bool gxLabelAtlas::Insert( gxFontId        aFont,
+                           const gxString& aText,
+                           bool            isHorizontal,
+                           const gxSize&   aSize,
+                           gxRect&         aRect )
+{
+    if ( aSize.X > mSize || aSize.Y > mSize || aSize.X <= 0 || aSize.Y <= 0 )
+        return false;
+
+    // Doesn't fit on this shelf, so start another one below.
+    if ( mShelfEnd + aSize.X > mSize )
+    {
+        mShelfTop   += mShelfHeight + LabelSpacing;
+        mShelfHeight = 0;
+        mShelfEnd    = 0;
+    }
+
+    // Doesn't fit below either, so start over.
+    if ( mShelfTop + aSize.Y > mSize )
+        Clear();
+
+    aRect = gxRect( mShelfEnd, mShelfTop, aSize.X, aSize.Y );
+
+    mShelfEnd   += aSize.X + LabelSpacing;
+    mShelfHeight = gxMax( mShelfHeight, aSize.Y );
+
+    // A colliding label is overwritten (its space is lost till starting
+    // over).
+    Entry& iEntry = mEntries[ GetKey( aFont, aText, isHorizontal ) ];
+    iEntry.mFont       = aFont;
+    iEntry.mText       = aText;
+    iEntry.mHorizontal = isHorizontal;
+    iEntry.mRect       = aRect;
+
+    return true;
+}
+
+void gxLabelAtlas::Clear()
+{
+    mEntries.clear();
+    mShelfTop    = 0;
+    mShelfHeight = 0;
+    mShelfEnd    = 0;
+    ++mGeneration;
+}
@@ -0,0 +1,114 @@
+#ifndef gxLabelAtlas_h
+#define gxLabelAtlas_h
+
+#include "core/geometry/gxGeometry.h"
+#include "core/gxString.h"
+#include "core/gxTextCache.h"
+
+#include <unordered_map>
+
+/**
+ * @brief Where rendered labels are kept in an atlas - a single bitmap they
+ * are blitted from - so each is rendered once rather than on every paint.
+ *
+ * Labels (say, those of rulers) are kept by font, orientation and text. This
+ * class only lays them out in the atlas; the adapters render and blit them
+ * (see gxPaintDC::DrawLabel()). Labels are placed on shelves, left to right
+ * and top to bottom; once a label no longer fits, the atlas starts over
+ * empty (see GetGeneration()), as labels in use are soon placed again.
+ *
+ * Like the {@link gxTextCache text cache}, it's shared and used from the UI
+ * thread only.
+ */
+class gxLabelAtlas
+{
+public:
+    /**
+     * @brief The width and height of the atlas by default.
+     */
+    static const gxPix DefaultSize = 512;
+
+    /**
+     * @param aSize The width and height of the atlas.
+     */
+    gxLabelAtlas( gxPix aSize = DefaultSize );
+
+    /**
+     * @brief Returns the atlas shared by all DCs.
+     */
+    static gxLabelAtlas& Get();
+
+    /**
+     * @brief Returns the width and height of the atlas.
+     */
+    gxPix GetSize() const { return mSize; }
+
+    /**
+     * @brief Returns the number of times the atlas started over, so adapters
+     * know to clear their bitmap.
+     */
+    unsigned long GetGeneration() const { return mGeneration; }
+
+    /**
+     * @brief Looks up where a label is in the atlas.
+     *
+     * @param aFont The font the label is rendered with.
+     * @param aText The label.
+     * @param isHorizontal Whether the label is horizontal, or rotated by 90
+     *        degrees.
+     * @param aRect Receives where the label is, if found.
+     * @return Whether or not the label is in the atlas.
+     */
+    bool Find( gxFontId        aFont,
+               const gxString& aText,
+               bool            isHorizontal,
+               gxRect&         aRect ) const;
+
+    /**
+     * @brief Makes room for a label in the atlas, starting over if full.
+     *
+     * @param aFont The font the label is rendered with.
+     * @param aText The label.
+     * @param isHorizontal Whether the label is horizontal, or rotated.
+     * @param aSize The size of the rendered label.
+     * @param aRect Receives where to render the label.
+     * @return False if the label is too large for the atlas.
+     */
+    bool Insert( gxFontId        aFont,
+                 const gxString& aText,
+                 bool            isHorizontal,
+                 const gxSize&   aSize,
+                 gxRect&         aRect );
+
+    /**
+     * @brief Drops all labels, starting over.
+     */
+    void Clear();
+
+private:
+    struct Entry
+    {
+        gxFontId mFont;
+        gxString mText;
+        bool     mHorizontal;
+        gxRect   mRect;
+    };
+
+    typedef std::unordered_map< size_t, Entry > EntryMap;
+
+    gxPix         mSize;
+    EntryMap      mEntries;
+    unsigned long mGeneration;
+
+    /// The shelf labels are being placed on: its top, its height (that of
+    /// its tallest label) and where its free space starts.
+    gxPix         mShelfTop;
+    gxPix         mShelfHeight;
+    gxPix         mShelfEnd;
+
+    static size_t GetKey( gxFontId        aFont,
+                          const gxString& aText,
+                          bool            isHorizontal );
+};
+
+#endif //gxLabelAtlas_h
@@ -1,6 +1,10 @@
 #ifndef gxLog_h
 #define gxLog_h
 
-#include "adapters/wx/gxLog.h"
+#ifdef GX_HEADLESS
+    #include "adapters/headless/gxLog.h"
+#else
+    #include "adapters/wx/gxLog.h"
+#endif
 
 #endif // gxLog_h
\ No newline at end of file
@@ -0,0 +1,81 @@
+#ifndef gxMpscQueue_h
+#define gxMpscQueue_h
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief A lock-free queue that many threads (producers) push nodes onto,
+ * and one thread (the consumer) takes all nodes off at once.
+ *
+ * The queue is intrusive: nodes link through their mNext member, so pushing
+ * doesn't allocate. Producers push onto the head of a list with a
+ * compare-and-swap; the consumer takes the whole list with a single exchange
+ * and reverses it, so nodes come out in the order they were pushed (per
+ * producer).
+ */
+template < class tNode >
+class gxMpscQueue
+{
+public:
+    gxMpscQueue()
+      : mHead( NULL ) { }
+
+    /**
+     * @brief Pushes a node; safe to call from any thread.
+     *
+     * @param aNode The node.
+     * @return True if the queue was empty, so the consumer may need waking.
+     */
+    bool Push( tNode* aNode )
+    {
+        tNode* iHead = mHead.load( std::memory_order_relaxed );
+
+        do
+        {
+            aNode->mNext = iHead;
+        } while ( !mHead.compare_exchange_weak( iHead,
+                                                aNode,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed ) );
+
+        return iHead == NULL;
+    }
+
+    /**
+     * @brief Returns whether or not the queue is empty; safe to call from any
+     * thread (though producers may push right after).
+     */
+    bool IsEmpty() const
+    {
+        return mHead.load( std::memory_order_acquire ) == NULL;
+    }
+
+    /**
+     * @brief Takes all nodes off the queue; only called by the consumer.
+     *
+     * @return The first node pushed (NULL if none), the others following
+     *         through mNext.
+     */
+    tNode* PopAll()
+    {
+        tNode* iNode  = mHead.exchange( NULL, std::memory_order_acquire );
+        tNode* iFirst = NULL;
+
+        // The list is latest first, so reverse it.
+        while ( iNode )
+        {
+            tNode* iNext = iNode->mNext;
+            iNode->mNext = iFirst;
+            iFirst = iNode;
+            iNode  = iNext;
+        }
+
+        return iFirst;
+    }
+
+private:
+    std::atomic< tNode* > mHead;
+};
+
+#endif //gxMpscQueue_h
@@ -1,6 +1,10 @@
 #ifndef gxObject_h
 #define gxObject_h
 
-#include "adapters/wx/gxObject.h"
+#ifdef GX_HEADLESS
+    #include "adapters/headless/gxObject.h"
+#else
+    #include "adapters/wx/gxObject.h"
+#endif
 
 #endif // gxObject_h
\ No newline at end of file
@@ -1,6 +1,10 @@
 #ifndef gxPaintDC_h
 #define gxPaintDC_h
 
-#include "adapters/wx/gxPaintDC.h"
+#ifdef GX_HEADLESS
+    #include "adapters/headless/gxPaintDC.h"
+#else
+    #include "adapters/wx/gxPaintDC.h"
+#endif
 
 #endif // gxPaintDC_h
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef gxParallel_h
+#define gxParallel_h
+
+#include "core/gxThreadPool.h"
+
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * @brief The chunks of a gxParallelFor() job.
+ */
+template < class tObject >
+struct gxParallelChunks
+{
+    tObject* mObject;
+    void     ( tObject::*mMethod )( size_t, size_t );
+    size_t   mCount;
+    size_t   mChunk;
+
+    static void Run( void*  aData,
+                     size_t aIndex )
+    {
+        gxParallelChunks* iChunks = static_cast< gxParallelChunks* >( aData );
+        size_t iFirst = aIndex * iChunks->mChunk;
+
+        ( iChunks->mObject->*iChunks->mMethod )( iFirst, std::min( iFirst + iChunks->mChunk, iChunks->mCount ) );
+    }
+};
+
+/**
+ * @brief Splits a range of work items into chunks, calling a method of an
+ * object on each chunk concurrently.
+ *
+ * Chunks are run by the {@link gxThreadPool::Get() shared thread pool}, the
+ * calling thread included. Nothing is run concurrently unless there are
+ * enough items to give each thread at least aMinPerThread of them.
+ *
+ * @param aObject The object whose method is called.
+ * @param aMethod The method, taking the first and one-past-last items of the
+ *        chunk.
+ * @param aCount The number of items.
+ * @param aMinPerThread The minimal number of items worth a thread.
+ * @param aThreads The maximal number of threads; 0 for those of the pool.
+ */
+template < class tObject >
+void gxParallelFor( tObject*  aObject,
+                    void      ( tObject::*aMethod )( size_t, size_t ),
+                    size_t    aCount,
+                    size_t    aMinPerThread,
+                    unsigned  aThreads = 0 )
+{
+    gxThreadPool& iPool = gxThreadPool::Get();
+
+    size_t iThreads = aThreads ? aThreads : iPool.GetThreadCount();
+    iThreads = std::min( iThreads, aCount / ( aMinPerThread ? aMinPerThread : 1 ) );
+
+    if ( iThreads <= 1 )
+    {
+        ( aObject->*aMethod )( 0, aCount );
+        return;
+    }
+
+    gxParallelChunks< tObject > iChunks;
+    iChunks.mObject = aObject;
+    iChunks.mMethod = aMethod;
+    iChunks.mCount  = aCount;
+    iChunks.mChunk  = ( aCount + iThreads - 1 ) / iThreads;
+
+    iPool.Run( &gxParallelChunks< tObject >::Run,
+               &iChunks,
+               ( aCount + iChunks.mChunk - 1 ) / iChunks.mChunk );
+}
+
+#endif //gxParallel_h
@@ -1,6 +1,10 @@
 #ifndef gxString_h
 #define gxString_h
 
-#include "adapters/wx/gxString.h"
+#ifdef GX_HEADLESS
+    #include "adapters/headless/gxString.h"
+#else
+    #include "adapters/wx/gxString.h"
+#endif
 
 #endif // gxString_h
\ No newline at end of file
@@ -0,0 +1,18 @@
+#include "core/gxStrip.h"
+#include "core/gxPaintDC.h"
+
+// The id of the last strip created. Strips are created on the UI thread
+// only.
+static gxStripId sLastStripId = 0;
+
+gxStrip::gxStrip() :
+    mId( ++sLastStripId ),
+    mValid( false ),
+    mOffset( 0 )
+{
+}
+
+gxStrip::~gxStrip()
+{
+    gxPaintDC::ReleaseStrip( mId );
+}
@@ -0,0 +1,64 @@
+#ifndef gxStrip_h
+#define gxStrip_h
+
+#include "core/geometry/gxGeometry.h"
+
+#include <cstddef>
+
+/**
+ * @brief Identifies a strip, for adapters to keep its pixels by.
+ */
+typedef size_t gxStripId;
+
+/**
+ * @brief A strip of cached pixels a view element paints into, so scrolling
+ * it only paints what scrolls into view.
+ *
+ * Strips are painted through {@link gxPainter::BeginStrip()}: what was
+ * cached is shifted along the strip by how much it scrolled, and only the
+ * span exposed by the shift needs painting (all of it the first time, after
+ * the strip is resized, or after Invalidate()). The pixels themselves are
+ * kept by the adapters (see gxPaintDC::BeginStrip()); this class keeps where
+ * they are.
+ */
+class gxStrip
+{
+public:
+    gxStrip();
+
+    /**
+     * @brief Drops the pixels kept by the adapters.
+     */
+    ~gxStrip();
+
+    gxStripId GetId() const { return mId; }
+
+    /**
+     * @brief Returns whether or not the pixels cached can be shifted, rather
+     * than painted again.
+     */
+    bool IsValid() const { return mValid; }
+
+    /**
+     * @brief Has the whole strip painted again, say once the scale changed.
+     */
+    void Invalidate() { mValid = false; }
+
+private:
+    friend class gxPainter;
+
+    gxStripId mId;
+    bool      mValid;
+
+    /// The size of the strip (on-screen).
+    gxSize    mSize;
+
+    /// Where the strip starts along its axis, from the painting origin.
+    gxPix     mOffset;
+
+    // Strips aren't copied, as the pixels kept are theirs.
+    gxStrip( const gxStrip& );
+    gxStrip& operator=( const gxStrip& );
+};
+
+#endif //gxStrip_h
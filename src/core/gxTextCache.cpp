@@ -0,0 +1,117 @@
+#include "core/gxTextCache.h"
+
+gxTextCache::gxTextCache( size_t aCapacity ) :
+    mCapacity( gxMax( aCapacity, size_t( 1 ) ) ),
+    mEstimating( false ),
+    mHits( 0 ),
+    mMisses( 0 )
+{
+}
+
+gxTextCache& gxTextCache::Get()
+{
+    static gxTextCache sCache;
+    return sCache;
+}
+
+size_t gxTextCache::Hash( const gxString& aText,
+                          size_t          aSeed )
+{
+    size_t iHash = aSeed;
+
+    for ( size_t i = 0; i < aText.length(); ++i )
+    {
+        wchar_t iChar = aText[i];
+        iHash = ( iHash ^ size_t( iChar ) ) * 16777619u;
+    }
+
+    return iHash;
+}
+
+size_t gxTextCache::GetKey( gxFontId        aFont,
+                            const gxString& aText )
+{
+    return Hash( aText, ( HashSeed ^ aFont ) * 16777619u );
+}
+
+bool gxTextCache::Find( gxFontId        aFont,
+                        const gxString& aText,
+                        gxSize&         aSize )
+{
+    EntryMap::iterator iFound = mIndex.find( GetKey( aFont, aText ) );
+
+    // Keys are hashes, so the entry found may be of another text.
+    if ( iFound == mIndex.end() ||
+         iFound->second->mFont != aFont ||
+         iFound->second->mText != aText )
+    {
+        ++mMisses;
+        return false;
+    }
+
+    // Most recently used now.
+    mEntries.splice( mEntries.begin(), mEntries, iFound->second );
+
+    aSize = iFound->second->mSize;
+    ++mHits;
+    return true;
+}
+
+void gxTextCache::Insert( gxFontId        aFont,
+                          const gxString& aText,
+                          const gxSize&   aSize )
+{
+    size_t iKey = GetKey( aFont, aText );
+    EntryMap::iterator iFound = mIndex.find( iKey );
+
+    // The key's entry (another text's, on a collision) is overwritten.
+    if ( iFound != mIndex.end() )
+    {
+        mEntries.splice( mEntries.begin(), mEntries, iFound->second );
+    } else if ( mEntries.size() >= mCapacity ) {
+        // Reuse the least recently used entry.
+        mIndex.erase( mEntries.back().mKey );
+        mEntries.splice( mEntries.begin(), mEntries, --mEntries.end() );
+        mIndex[ iKey ] = mEntries.begin();
+    } else {
+        mEntries.push_front( Entry() );
+        mIndex[ iKey ] = mEntries.begin();
+    }
+
+    Entry& iEntry = mEntries.front();
+    iEntry.mKey  = iKey;
+    iEntry.mFont = aFont;
+    iEntry.mText = aText;
+    iEntry.mSize = aSize;
+}
+
+void gxTextCache::SetEstimating( bool aEstimating )
+{
+    if ( mEstimating == aEstimating )
+        return;
+
+    mEstimating = aEstimating;
+
+    // Measured and estimated sizes shouldn't be mixed.
+    Clear();
+}
+
+void gxTextCache::SetCapacity( size_t aCapacity )
+{
+    mCapacity = gxMax( aCapacity, size_t( 1 ) );
+
+    while ( mEntries.size() > mCapacity )
+    {
+        mIndex.erase( mEntries.back().mKey );
+        mEntries.pop_back();
+    }
+}
+
+void gxTextCache::Clear()
+{
+    mEntries.clear();
+    mIndex.clear();
+    mGlyphs.clear();
+    mHits   = 0;
+    mMisses = 0;
+}
@@ -0,0 +1,213 @@
+#ifndef gxTextCache_h
+#define gxTextCache_h
+
+#include "core/geometry/gxGeometry.h"
+#include "core/gxString.h"
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief Identifies a font, for text measured with it (see {@link
+ * gxTextCache::Hash()}).
+ */
+typedef size_t gxFontId;
+
+/**
+ * @brief A cache of text sizes, so text isn't measured again and again by
+ * the platform (measuring is one of the slowest calls there are).
+ *
+ * Sizes are kept by font and string hash, for the most recently measured
+ * strings: once full, the least recently used string makes way for a new
+ * one. The cache is shared by all painters and lightweight systems (see
+ * Get()), and like them is used from the UI thread only.
+ *
+ * Optionally, the sizes of strings not in the cache are estimated from the
+ * advances of their glyphs, each of which is measured once per font. This
+ * leaves out kerning, but saves measuring every new string - say, the labels
+ * of a scrolled ruler.
+ */
+class gxTextCache
+{
+public:
+    /**
+     * @brief The number of strings kept by default.
+     */
+    static const size_t DefaultCapacity = 4096;
+
+    /**
+     * @param aCapacity The number of strings kept.
+     */
+    gxTextCache( size_t aCapacity = DefaultCapacity );
+
+    /**
+     * @brief Returns the cache shared by painters and lightweight systems.
+     */
+    static gxTextCache& Get();
+
+    /**
+     * @brief Returns the size of a text, measuring it only if not in the
+     * cache.
+     *
+     * @param aFont The font the text is measured with.
+     * @param aText The text.
+     * @param aMeasurer What measures text (a DC, or a control) with a
+     *        GetTextSize( gxString& ) method.
+     */
+    template< class tMeasurer >
+    gxSize GetTextSize( gxFontId   aFont,
+                        gxString&  aText,
+                        tMeasurer& aMeasurer )
+    {
+        gxSize iSize;
+
+        if ( Find( aFont, aText, iSize ) )
+            return iSize;
+
+        if ( mEstimating && !aText.empty() )
+            iSize = Estimate( aFont, aText, aMeasurer );
+        else
+            iSize = aMeasurer.GetTextSize( aText );
+
+        Insert( aFont, aText, iSize );
+        return iSize;
+    }
+
+    /**
+     * @brief Looks up the size of a text, making it the most recently used.
+     *
+     * @param aFont The font the text is measured with.
+     * @param aText The text.
+     * @param aSize Receives the size, if found.
+     * @return Whether or not the text was found.
+     */
+    bool Find( gxFontId        aFont,
+               const gxString& aText,
+               gxSize&         aSize );
+
+    /**
+     * @brief Adds the size of a text, as the most recently used.
+     */
+    void Insert( gxFontId        aFont,
+                 const gxString& aText,
+                 const gxSize&   aSize );
+
+    /**
+     * @brief Sets whether or not the sizes of strings not in the cache are
+     * estimated from glyph advances (they aren't by default).
+     */
+    void SetEstimating( bool aEstimating );
+
+    bool IsEstimating() const { return mEstimating; }
+
+    /**
+     * @brief Sets the number of strings kept, dropping the least recently
+     * used ones if need be.
+     */
+    void SetCapacity( size_t aCapacity );
+
+    size_t GetCapacity() const { return mCapacity; }
+
+    /**
+     * @brief Returns the number of strings kept.
+     */
+    size_t GetCount() const { return mEntries.size(); }
+
+    /**
+     * @brief Returns the number of lookups that found the text, and of those
+     * that didn't.
+     */
+    unsigned long GetHits() const { return mHits; }
+    unsigned long GetMisses() const { return mMisses; }
+
+    /**
+     * @brief Drops all sizes (say, once fonts have been installed).
+     */
+    void Clear();
+
+    /**
+     * @brief Returns the hash of a string (FNV-1a over its characters).
+     *
+     * Adapters use it to identify fonts by their description.
+     * @param aText The string.
+     * @param aSeed The hash to carry on from, if any.
+     */
+    static size_t Hash( const gxString& aText,
+                        size_t          aSeed = HashSeed );
+
+private:
+    static const size_t HashSeed = size_t( 2166136261u );
+
+    struct Entry
+    {
+        size_t   mKey;
+        gxFontId mFont;
+        gxString mText;
+        gxSize   mSize;
+    };
+
+    typedef std::list< Entry >                                     EntryList;
+    typedef std::unordered_map< size_t, EntryList::iterator >      EntryMap;
+    typedef std::pair< gxFontId, wchar_t >                         GlyphKey;
+
+    struct GlyphHash
+    {
+        size_t operator()( const GlyphKey& aKey ) const
+        {
+            return aKey.first * 31 + size_t( aKey.second );
+        }
+    };
+
+    typedef std::unordered_map< GlyphKey, gxSize, GlyphHash >      GlyphMap;
+
+    // The most recently used first
+    EntryList     mEntries;
+    EntryMap      mIndex;
+    size_t        mCapacity;
+
+    bool          mEstimating;
+    GlyphMap      mGlyphs;
+
+    unsigned long mHits;
+    unsigned long mMisses;
+
+    /**
+     * @brief Returns the key of a text, by its font and hash.
+     */
+    static size_t GetKey( gxFontId        aFont,
+                          const gxString& aText );
+
+    /**
+     * @brief Returns the size of a text as the sum of the advances of its
+     * glyphs, measuring those not known yet.
+     */
+    template< class tMeasurer >
+    gxSize Estimate( gxFontId        aFont,
+                     const gxString& aText,
+                     tMeasurer&      aMeasurer )
+    {
+        gxSize iSize( 0, 0 );
+
+        for ( size_t i = 0; i < aText.length(); ++i )
+        {
+            wchar_t iChar = aText[i];
+            GlyphKey iKey( aFont, iChar );
+            GlyphMap::iterator iGlyph = mGlyphs.find( iKey );
+
+            if ( iGlyph == mGlyphs.end() )
+            {
+                gxString iGlyphText( aText.substr( i, 1 ) );
+                iGlyph = mGlyphs.insert( std::make_pair( iKey, aMeasurer.GetTextSize( iGlyphText ) ) ).first;
+            }
+
+            iSize.X += iGlyph->second.X;
+            iSize.Y  = gxMax( iSize.Y, iGlyph->second.Y );
+        }
+
+        return iSize;
+    }
+};
+
+#endif //gxTextCache_h
@@ -0,0 +1,151 @@
+#include "core/gxThreadPool.h"
+
+// Whether or not the thread is running tasks of a job (as its caller, or as
+// a worker), so a job run from one of them is run by the thread alone,
+// without trying the run mutex it may already hold.
+static thread_local bool sRunningJob = false;
+
+gxThreadPool::gxThreadPool( unsigned aThreads ) :
+    mThreads( aThreads ? aThreads : std::thread::hardware_concurrency() ),
+    mTask( NULL ),
+    mData( NULL ),
+    mCount( 0 ),
+    mJob( 0 ),
+    mStopping( false ),
+    mFinished( 0 ),
+    mBusy( 0 ),
+    mNext( 0 )
+{
+    if ( mThreads == 0 )
+        mThreads = 1;
+}
+
+gxThreadPool::~gxThreadPool()
+{
+    {
+        std::lock_guard< std::mutex > iLock( mMutex );
+        mStopping = true;
+    }
+
+    mWake.notify_all();
+
+    for ( size_t i = 0; i < mWorkers.size(); ++i )
+        mWorkers[i].join();
+}
+
+gxThreadPool& gxThreadPool::Get()
+{
+    static gxThreadPool sPool;
+    return sPool;
+}
+
+void gxThreadPool::Run( Task   aTask,
+                        void*  aData,
+                        size_t aCount )
+{
+    // Running a job from one of its tasks, or no workers to share with
+    if ( sRunningJob || mThreads <= 1 || aCount <= 1 )
+    {
+        for ( size_t i = 0; i < aCount; ++i )
+            aTask( aData, i );
+        return;
+    }
+
+    std::unique_lock< std::mutex > iRunLock( mRunMutex, std::try_to_lock );
+
+    // Another thread is running a job already
+    if ( !iRunLock.owns_lock() )
+    {
+        for ( size_t i = 0; i < aCount; ++i )
+            aTask( aData, i );
+        return;
+    }
+
+    if ( mWorkers.empty() )
+    {
+        for ( unsigned i = 1; i < mThreads; ++i )
+            mWorkers.push_back( std::thread( &gxThreadPool::WorkerLoop, this ) );
+    }
+
+    {
+        std::unique_lock< std::mutex > iLock( mMutex );
+
+        // A worker late for the last job may still be at it (finding no
+        // tasks left), and must be done before the tasks are reset.
+        while ( mBusy > 0 )
+            mDone.wait( iLock );
+
+        mTask     = aTask;
+        mData     = aData;
+        mCount    = aCount;
+        mFinished = 0;
+        mNext     = 0;
+        ++mJob;
+    }
+
+    mWake.notify_all();
+
+    sRunningJob = true;
+    size_t iDone = Work( aTask, aData, aCount );
+    sRunningJob = false;
+
+    // Waits for the workers that took part too, so none is left with this
+    // job once the next one starts.
+    std::unique_lock< std::mutex > iLock( mMutex );
+    mFinished += iDone;
+
+    while ( mFinished < aCount || mBusy > 0 )
+        mDone.wait( iLock );
+}
+
+size_t gxThreadPool::Work( Task   aTask,
+                           void*  aData,
+                           size_t aCount )
+{
+    size_t iDone = 0;
+
+    for ( size_t i = mNext++; i < aCount; i = mNext++ )
+    {
+        aTask( aData, i );
+        ++iDone;
+    }
+
+    return iDone;
+}
+
+void gxThreadPool::WorkerLoop()
+{
+    unsigned long iJob = 0;
+
+    // Workers only ever run tasks.
+    sRunningJob = true;
+
+    std::unique_lock< std::mutex > iLock( mMutex );
+
+    for ( ;; )
+    {
+        while ( !mStopping && mJob == iJob )
+            mWake.wait( iLock );
+
+        if ( mStopping )
+            return;
+
+        iJob = mJob;
+
+        Task   iTask  = mTask;
+        void*  iData  = mData;
+        size_t iCount = mCount;
+
+        ++mBusy;
+        iLock.unlock();
+
+        size_t iDone = Work( iTask, iData, iCount );
+
+        iLock.lock();
+        mFinished += iDone;
+        --mBusy;
+
+        if ( mBusy == 0 )
+            mDone.notify_all();
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef gxThreadPool_h
+#define gxThreadPool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A pool of worker threads, kept waiting between jobs so running a
+ * job doesn't pay for creating and joining threads (layouts run one on every
+ * simulation step, dozens of times a second).
+ *
+ * A job is a number of tasks, each run by a worker or by the calling thread,
+ * which takes part too and returns once all tasks are done. Workers are
+ * started with the first job. One job runs at a time: a job run while
+ * another one is running (from another thread, or from one of its own tasks)
+ * is run by its calling thread alone.
+ */
+class gxThreadPool
+{
+public:
+    /**
+     * @brief A task: called with the data of its job and the task index.
+     */
+    typedef void ( *Task )( void* aData, size_t aIndex );
+
+    /**
+     * @param aThreads The number of threads running a job, the calling one
+     *        included; 0 for the number of cores.
+     */
+    gxThreadPool( unsigned aThreads = 0 );
+
+    /**
+     * @brief Stops and joins the workers.
+     */
+    ~gxThreadPool();
+
+    /**
+     * @brief Returns the pool shared by layouts.
+     */
+    static gxThreadPool& Get();
+
+    /**
+     * @brief Returns the number of threads running a job, the calling one
+     * included.
+     */
+    unsigned GetThreadCount() const { return mThreads; }
+
+    /**
+     * @brief Runs a job, returning once all its tasks are done.
+     *
+     * @param aTask The task.
+     * @param aData The data passed to each task.
+     * @param aCount The number of tasks.
+     */
+    void Run( Task   aTask,
+              void*  aData,
+              size_t aCount );
+
+private:
+    unsigned                    mThreads;
+    std::vector< std::thread >  mWorkers;
+
+    // Held by the thread running a job
+    std::mutex                  mRunMutex;
+
+    // Guards the job and the counts below
+    std::mutex                  mMutex;
+    std::condition_variable     mWake;
+    std::condition_variable     mDone;
+
+    Task                        mTask;
+    void*                       mData;
+    size_t                      mCount;
+    unsigned long               mJob;
+    bool                        mStopping;
+
+    // The tasks done, and the workers still at the job
+    size_t                      mFinished;
+    unsigned                    mBusy;
+
+    // The next task to be taken
+    std::atomic< size_t >       mNext;
+
+    gxThreadPool( const gxThreadPool& );
+    gxThreadPool& operator=( const gxThreadPool& );
+
+    /**
+     * @brief Takes and runs tasks of the current job till none are left.
+     * @return The number of tasks run.
+     */
+    size_t Work( Task   aTask,
+                 void*  aData,
+                 size_t aCount );
+
+    void WorkerLoop();
+};
+
+#endif //gxThreadPool_h
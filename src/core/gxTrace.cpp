@@ -0,0 +1,178 @@
+#include "core/gxTrace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <string>
+
+#ifdef __GNUG__
+    #include <cstdlib>
+    #include <cxxabi.h>
+#endif
+
+std::atomic< bool >            gxTrace::sRecording( false );
+std::atomic< gxTrace::Ring* >  gxTrace::sRings( NULL );
+std::atomic< unsigned >        gxTrace::sThreads( 0 );
+
+// Returns the time in nanoseconds.
+static long long Now()
+{
+    using namespace std::chrono;
+    return duration_cast< nanoseconds >( steady_clock::now().time_since_epoch() ).count();
+}
+
+// Returns the readable name of a type_info name (they are mangled with gcc
+// and clang).
+static std::string Demangle( const char* aName )
+{
+#ifdef __GNUG__
+    int iStatus = 0;
+    char* iDemangled = abi::__cxa_demangle( aName, NULL, NULL, &iStatus );
+
+    if ( iStatus == 0 && iDemangled )
+    {
+        std::string iName( iDemangled );
+        std::free( iDemangled );
+        return iName;
+    }
+#endif
+    return aName;
+}
+
+void gxTrace::Start()
+{
+    sRecording.store( true, std::memory_order_relaxed );
+}
+
+void gxTrace::Stop()
+{
+    sRecording.store( false, std::memory_order_relaxed );
+}
+
+void gxTrace::Clear()
+{
+    for ( Ring* iRing = sRings.load( std::memory_order_acquire ); iRing; iRing = iRing->mNext )
+    {
+        iRing->mCount.store( 0, std::memory_order_relaxed );
+    }
+}
+
+void gxTrace::Begin( const char* aCategory,
+                     const char* aType,
+                     const void* aId )
+{
+    Record( true, aCategory, aType, aId );
+}
+
+void gxTrace::End( const char* aCategory,
+                   const char* aType,
+                   const void* aId )
+{
+    Record( false, aCategory, aType, aId );
+}
+
+gxTrace::Ring* gxTrace::GetRing()
+{
+    static thread_local Ring* sRing = NULL;
+
+    if ( !sRing )
+    {
+        sRing = new Ring();
+        sRing->mCount.store( 0, std::memory_order_relaxed );
+        sRing->mThread = ++sThreads;
+
+        // Rings are never removed, so pushing is all there is to it.
+        Ring* iHead = sRings.load( std::memory_order_relaxed );
+
+        do
+        {
+            sRing->mNext = iHead;
+        } while ( !sRings.compare_exchange_weak( iHead,
+                                                 sRing,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed ) );
+    }
+
+    return sRing;
+}
+
+void gxTrace::Record( bool        aBegin,
+                      const char* aCategory,
+                      const char* aType,
+                      const void* aId )
+{
+    Ring* iRing = GetRing();
+
+    // Only this thread writes to its ring, so the count is merely published.
+    size_t iCount = iRing->mCount.load( std::memory_order_relaxed );
+    Event& iEvent = iRing->mEvents[ iCount % RingCapacity ];
+
+    iEvent.mTime     = Now();
+    iEvent.mCategory = aCategory;
+    iEvent.mType     = aType;
+    iEvent.mId       = aId;
+    iEvent.mBegin    = aBegin;
+
+    iRing->mCount.store( iCount + 1, std::memory_order_release );
+}
+
+bool gxTrace::Write( const char* aPath )
+{
+    FILE* iFile = fopen( aPath, "w" );
+
+    if ( !iFile )
+        return false;
+
+    // Demangling is slow, so each type is demangled once.
+    std::map< const char*, std::string > iNames;
+
+    fprintf( iFile, "{\"traceEvents\":[" );
+
+    bool iFirst = true;
+
+    for ( Ring* iRing = sRings.load( std::memory_order_acquire ); iRing; iRing = iRing->mNext )
+    {
+        size_t iCount = iRing->mCount.load( std::memory_order_acquire );
+        size_t iStart = iCount > RingCapacity ? iCount - RingCapacity : 0;
+
+        // The beginning of the first spans may have been overwritten; their
+        // ends are left out.
+        int iDepth = 0;
+
+        for ( size_t i = iStart; i < iCount; ++i )
+        {
+            const Event& iEvent = iRing->mEvents[ i % RingCapacity ];
+
+            if ( iEvent.mBegin )
+            {
+                ++iDepth;
+            } else if ( iDepth > 0 ) {
+                --iDepth;
+            } else {
+                continue;
+            }
+
+            std::map< const char*, std::string >::iterator iName = iNames.find( iEvent.mType );
+
+            if ( iName == iNames.end() )
+                iName = iNames.insert( std::make_pair( iEvent.mType, Demangle( iEvent.mType ) ) ).first;
+
+            fprintf( iFile,
+                     "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,"
+                     "\"pid\":1,\"tid\":%u,\"args\":{\"id\":\"%p\"}}",
+                     iFirst ? "" : ",",
+                     iName->second.c_str(),
+                     iEvent.mCategory,
+                     iEvent.mBegin ? 'B' : 'E',
+                     iEvent.mTime / 1000.0,
+                     iRing->mThread,
+                     iEvent.mId );
+
+            iFirst = false;
+        }
+    }
+
+    fprintf( iFile, "\n]}\n" );
+
+    return fclose( iFile ) == 0;
+}
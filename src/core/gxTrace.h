@@ -0,0 +1,161 @@
+#ifndef gxTrace_h
+#define gxTrace_h
+
+#include <atomic>
+#include <cstddef>
+#include <typeinfo>
+
+/**
+ * @brief Records when view elements validate, lay out and paint, and when
+ * events fire, so a slow frame can be looked into on a timeline (Chrome's
+ * about:tracing, or Perfetto).
+ *
+ * Code being traced marks its spans with gxTraceScope(). Each thread records
+ * the begin and end events of its spans into its own ring buffer, so
+ * recording takes no locks; once a ring is full, its oldest events are
+ * overwritten. Rings are created once per thread and kept on a lock-free
+ * list.
+ *
+ * Tracing is compiled in only with GX_TRACE defined; otherwise
+ * gxTraceScope() expands to nothing.
+ */
+class gxTrace
+{
+public:
+    /**
+     * @brief The number of events each thread keeps.
+     */
+    static const size_t RingCapacity = 16384;
+
+    /**
+     * @brief Starts recording.
+     */
+    static void Start();
+
+    /**
+     * @brief Stops recording.
+     */
+    static void Stop();
+
+    /**
+     * @brief Returns whether or not events are being recorded.
+     */
+    static bool IsRecording()
+    {
+        return sRecording.load( std::memory_order_relaxed );
+    }
+
+    /**
+     * @brief Drops all recorded events.
+     *
+     * Call this while not recording.
+     */
+    static void Clear();
+
+    /**
+     * @brief Writes the recorded events to a file, as Chrome trace JSON.
+     *
+     * Call this while not recording.
+     *
+     * @param aPath The file path.
+     * @return False if the file couldn't be written.
+     */
+    static bool Write( const char* aPath );
+
+    /**
+     * @brief Records the beginning of a span on the calling thread.
+     *
+     * @param aCategory What is done, say "paint".
+     * @param aType The type doing it (its type_info name).
+     * @param aId The object doing it.
+     */
+    static void Begin( const char* aCategory,
+                       const char* aType,
+                       const void* aId );
+
+    /**
+     * @brief Records the end of the span begun last on the calling thread.
+     */
+    static void End( const char* aCategory,
+                     const char* aType,
+                     const void* aId );
+
+private:
+    struct Event
+    {
+        long long   mTime;
+        const char* mCategory;
+        const char* mType;
+        const void* mId;
+        bool        mBegin;
+    };
+
+    struct Ring
+    {
+        Event                 mEvents[ RingCapacity ];
+        std::atomic< size_t > mCount;
+        unsigned              mThread;
+        Ring*                 mNext;
+    };
+
+    static std::atomic< bool >     sRecording;
+    static std::atomic< Ring* >    sRings;
+    static std::atomic< unsigned > sThreads;
+
+    /**
+     * @brief Returns the ring of the calling thread, creating it first if
+     * need be.
+     */
+    static Ring* GetRing();
+
+    static void Record( bool        aBegin,
+                        const char* aCategory,
+                        const char* aType,
+                        const void* aId );
+};
+
+/**
+ * @brief Records a span from its construction till its destruction (if
+ * recording when constructed).
+ */
+class gxTraceSpan
+{
+public:
+    gxTraceSpan( const char* aCategory,
+                 const char* aType,
+                 const void* aId )
+      : mCategory( gxTrace::IsRecording() ? aCategory : NULL ),
+        mType    ( aType ),
+        mId      ( aId )
+    {
+        if ( mCategory )
+            gxTrace::Begin( mCategory, mType, mId );
+    }
+
+    ~gxTraceSpan()
+    {
+        if ( mCategory )
+            gxTrace::End( mCategory, mType, mId );
+    }
+
+private:
+    const char* mCategory;
+    const char* mType;
+    const void* mId;
+};
+
+/**
+ * @brief Traces the rest of the enclosing scope.
+ *
+ * @param aCategory What is done, say "paint".
+ * @param aType The type doing it, as given by typeid().
+ * @param aId The object doing it.
+ */
+#ifdef GX_TRACE
+    #define gxTraceScope( aCategory, aType, aId ) \
+        gxTraceSpan iTraceSpan( aCategory, ( aType ).name(), aId )
+#else
+    #define gxTraceScope( aCategory, aType, aId )
+#endif
+
+#endif //gxTrace_h
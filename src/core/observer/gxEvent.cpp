@@ -3,57 +3,110 @@
 
 gxEvent::~gxEvent()
 {
-    mCallbacks.clear();
+    mEntries.clear();
 }
 
-void gxEvent::Subscribe( gxCallback &aCallback )
+gxSubscription gxEvent::Subscribe( gxCallback &aCallback )
 {
-    // Only subscribe to a callback if it isn't already subscribed.
-    if ( !AlreadySubscribed( aCallback ) )
-        mCallbacks.push_back( aCallback );
+    // We do not allow the same object to have two handlers for the same
+    // event.
+    gxObjectSlots::iterator iObject = mObjectSlots.find( aCallback.GetObj() );
+    
+    if ( iObject != mObjectSlots.end() )
+        return gxSubscription( iObject->second, mSlots[ iObject->second ].mGeneration );
+    
+    unsigned iSlot;
+    
+    if ( mFreeSlots.empty() )
+    {
+        Slot iNew = { 0, 1 };
+        iSlot = unsigned( mSlots.size() );
+        mSlots.push_back( iNew );
+    } else {
+        iSlot = mFreeSlots.back();
+        mFreeSlots.pop_back();
+    }
+    
+    Entry iEntry = { aCallback, iSlot };
+    mSlots[ iSlot ].mEntry = unsigned( mEntries.size() );
+    mEntries.push_back( iEntry );
+    
+    mObjectSlots[ aCallback.GetObj() ] = iSlot;
+    
+    return gxSubscription( iSlot, mSlots[ iSlot ].mGeneration );
 }
 
 void gxEvent::Unsubscribe( void *aObj )
 {
-    gxCallbacks::iterator iCallback;
+    gxObjectSlots::iterator iObject = mObjectSlots.find( aObj );
+    
+    if ( iObject != mObjectSlots.end() )
+        Remove( iObject->second );
+}
+
+void gxEvent::Unsubscribe( gxSubscription aSubscription )
+{
+    // Stale handles have an older generation than their slot.
+    if ( !aSubscription.IsSet() ||
+         aSubscription.mSlot >= mSlots.size() ||
+         aSubscription.mGeneration != mSlots[ aSubscription.mSlot ].mGeneration )
+        return;
     
-    // For each  callback
-    for( iCallback = mCallbacks.begin(); iCallback != mCallbacks.end(); ++iCallback )
+    Remove( aSubscription.mSlot );
+}
+
+void gxEvent::Remove( unsigned aSlot )
+{
+    Slot&    iSlot  = mSlots[ aSlot ];
+    unsigned iEntry = iSlot.mEntry;
+    
+    mObjectSlots.erase( mEntries[ iEntry ].mCallback.GetObj() );
+    
+    if ( mFiring )
     {
-        // If it's the same object
-        if ( aObj == (*iCallback).GetObj() )
+        // Entries can't move while firing, so only empty the callback.
+        mEntries[ iEntry ].mCallback = gxCallback();
+        mDead = true;
+    } else {
+        // Move the last entry in place of the removed one.
+        if ( iEntry != mEntries.size() - 1 )
         {
-            // Remove the callback from the list
-            mCallbacks.erase( iCallback );
-            break;
+            mEntries[ iEntry ] = mEntries.back();
+            mSlots[ mEntries[ iEntry ].mSlot ].mEntry = iEntry;
         }
+        
+        mEntries.pop_back();
     }
+    
+    // Stale any handles of the slot (0 stands for no subscription).
+    if ( ++iSlot.mGeneration == 0 )
+        iSlot.mGeneration = 1;
+    
+    mFreeSlots.push_back( aSlot );
 }
 
-void gxEvent::Fire()
+void gxEvent::Compact()
 {
-    gxCallbacks::iterator iCallback;
+    size_t iKept = 0;
     
-    // For each callback
-    for( iCallback = mCallbacks.begin(); iCallback != mCallbacks.end(); ++iCallback )
+    for ( size_t i = 0; i < mEntries.size(); ++i )
     {
-        Fire( *iCallback );
+        if ( mEntries[ i ].mCallback.empty() )
+            continue;
+        
+        mEntries[ iKept ] = mEntries[ i ];
+        mSlots[ mEntries[ iKept ].mSlot ].mEntry = unsigned( iKept );
+        ++iKept;
     }
+    
+    mEntries.resize( iKept );
+    mDead = false;
 }
 
 bool gxEvent::AlreadySubscribed( gxCallback &aCallback )
 {
-    gxCallbacks::iterator iCallback;
-    
-    // For each callback
-    for( iCallback = mCallbacks.begin(); iCallback != mCallbacks.end(); ++iCallback )
-    {
-        // We do not allow the same object to have two handlers for the same
-        // event. So instead of comparing the Callbacks we compare their
-        // objects.
-        if ( aCallback.GetObj() == (*iCallback).GetObj() )
-            return true;
-    }
-    
-    return false;
+    // We do not allow the same object to have two handlers for the same
+    // event. So instead of comparing the Callbacks we compare their
+    // objects.
+    return mObjectSlots.find( aCallback.GetObj() ) != mObjectSlots.end();
 }
@@ -2,8 +2,86 @@
 #define gxEvent_h
 
 #include "FastDelegate.h"
+#include <cstddef>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
+/**
+ * @brief The type event arguments are passed on with: by (const) reference,
+ * so arguments are only copied if a callback takes them by value.
+ */
+template < typename t >
+struct gxParam
+{
+    typedef const t& type;
+};
+
+/**
+ * @brief Picks the fastdelegate type of callbacks taking the given parameters.
+ *
+ * Fastdelegates have a class per number of parameters, up to eight.
+ */
+template < typename... tArgs >
+struct gxDelegateOf;
+
+template <>
+struct gxDelegateOf<>
+{
+    typedef fastdelegate::FastDelegate0<> type;
+};
+
+template < typename t1 >
+struct gxDelegateOf< t1 >
+{
+    typedef fastdelegate::FastDelegate1< t1 > type;
+};
+
+template < typename t1, typename t2 >
+struct gxDelegateOf< t1, t2 >
+{
+    typedef fastdelegate::FastDelegate2< t1, t2 > type;
+};
+
+template < typename t1, typename t2, typename t3 >
+struct gxDelegateOf< t1, t2, t3 >
+{
+    typedef fastdelegate::FastDelegate3< t1, t2, t3 > type;
+};
+
+template < typename t1, typename t2, typename t3, typename t4 >
+struct gxDelegateOf< t1, t2, t3, t4 >
+{
+    typedef fastdelegate::FastDelegate4< t1, t2, t3, t4 > type;
+};
+
+template < typename t1, typename t2, typename t3, typename t4, typename t5 >
+struct gxDelegateOf< t1, t2, t3, t4, t5 >
+{
+    typedef fastdelegate::FastDelegate5< t1, t2, t3, t4, t5 > type;
+};
+
+template < typename t1, typename t2, typename t3, typename t4, typename t5,
+           typename t6 >
+struct gxDelegateOf< t1, t2, t3, t4, t5, t6 >
+{
+    typedef fastdelegate::FastDelegate6< t1, t2, t3, t4, t5, t6 > type;
+};
+
+template < typename t1, typename t2, typename t3, typename t4, typename t5,
+           typename t6, typename t7 >
+struct gxDelegateOf< t1, t2, t3, t4, t5, t6, t7 >
+{
+    typedef fastdelegate::FastDelegate7< t1, t2, t3, t4, t5, t6, t7 > type;
+};
+
+template < typename t1, typename t2, typename t3, typename t4, typename t5,
+           typename t6, typename t7, typename t8 >
+struct gxDelegateOf< t1, t2, t3, t4, t5, t6, t7, t8 >
+{
+    typedef fastdelegate::FastDelegate8< t1, t2, t3, t4, t5, t6, t7, t8 > type;
+};
+
 /**
  * @brief A class wrapping callbacks - the combination of object pointers and
  * member function pointers.
@@ -50,53 +128,171 @@ public:
      * @return A pointer to the callback object.
      */
     fastdelegate::detail::GenericClass *GetObj() { return m_pthis; }
+    
+    /**
+     * @brief Calls the callback.
+     *
+     * The callback must be one of a delegate taking tArgs (which are given
+     * explicitly).
+     */
+    template < typename... tArgs >
+    void Call( typename gxParam< tArgs >::type... aArgs ) const
+    {
+#if defined(FASTDELEGATE_USESTATICFUNCTIONHACK)
+        // The memento holds the very object and member function pointers the
+        // delegate calls, so call them directly rather than setting up a
+        // delegate.
+        typedef void ( fastdelegate::detail::GenericClass::*gxMethod )( tArgs... );
+        
+        ( m_pthis->*reinterpret_cast< gxMethod >( m_pFunction ) )( aArgs... );
+#else
+        typename gxDelegateOf< tArgs... >::type iDelegate;
+        iDelegate.SetMemento( *this );
+        iDelegate( aArgs... );
+#endif
+    }
 };
 
 
+/**
+ * @brief The arguments of an {@link gxEvent event} fired on a thread other than
+ * its {@link gxSubject subject's}, kept until the event is delivered on the
+ * subject's thread.
+ */
+class gxEventArgs
+{
+public:
+    virtual ~gxEventArgs() { }
+    
+    /**
+     * @brief Sets the arguments as the event's, before it is fired.
+     */
+    virtual void Apply() = 0;
+};
+
+/**
+ * @brief A handle to a subscription to an {@link gxEvent event}, returned when
+ * subscribing, with which to unsubscribe.
+ *
+ * Handles of subscriptions that have ended are stale, and unsubscribing with
+ * them does nothing (even if their slot has been taken by a later
+ * subscription).
+ */
+class gxSubscription
+{
+public:
+    /**
+     * @brief The default constructor represents no subscription.
+     */
+    gxSubscription()
+      : mSlot      ( 0 ),
+        mGeneration( 0 ) { }
+    
+    /**
+     * @brief Returns whether or not the handle stands for a subscription
+     * (which may have ended since).
+     */
+    bool IsSet() const { return mGeneration != 0; }
+private:
+    friend class gxEvent;
+    
+    gxSubscription( unsigned aSlot,
+                    unsigned aGeneration )
+      : mSlot      ( aSlot       ),
+        mGeneration( aGeneration ) { }
+    
+    unsigned mSlot;
+    unsigned mGeneration;
+};
+
 /**
  * @brief Base class for {@link gxSubject subject} events. Events are 
  * defined within subjects using the #gxDefineEvent() or #gxDefineBoundEvent() 
- * macros.
+ * macros, as {@link gxTypedEvent typed events}.
  *
  * An event allows observers to subscribe to it by providing a {@link gxCallback
  * callback}. It maintain a list of ovserver
  * callbacks, and facilitates firing to all observers.
  *
+ * Callbacks are kept contiguous, in the order fired, with a slot map (slots
+ * pointing at callbacks, and a free list of slots) translating subscription
+ * handles, so subscribing and unsubscribing take constant time however many
+ * observers there are. Observers may unsubscribe (themselves or others) while
+ * the event fires; they won't be called afterwards.
  */
 class gxEvent
 {
 public:
+    gxEvent()
+      : mFiring( 0     ),
+        mDead  ( false ),
+        mQueued( false ) { }
     
     virtual ~gxEvent();
     
     /**
      * @brief Adds a callback to the subscribers list of this object.
      *
+     * An object can only subscribe once to an event; if it already is, its
+     * existing subscription is returned.
+     *
      * @param aCallback The callback to be added.
+     * @return The subscription handle.
      */
-    void Subscribe( gxCallback &aCallback );
+    gxSubscription Subscribe( gxCallback &aCallback );
 
     /**
      * @brief Removes an object from this event subscribers list.
      *
-     * @param aCallback The callback to be added.
+     * @param aObj The object whose callback is to be removed.
      */
     void Unsubscribe( void *aObj );
 
     /**
-     * @brief Itterates through all callbacks and fire them.
+     * @brief Ends a subscription.
+     *
+     * @param aSubscription The subscription handle (ignored if stale).
      */
-    virtual void Fire();
-    
+    void Unsubscribe( gxSubscription aSubscription );
+
     /**
-     * @brief Fires a specific callback.
+     * @brief Fires all callbacks with the arguments stored with the event
+     * (when it was queued or posted).
      *
-     * This is an abstract method that will be implemented by the specialised
+     * This is an abstract method that will be implemented by the typed
      * derived class.
-     * @param aCallback The callback to fire.
      */
-    virtual void Fire( gxCallback &aCallback ) = 0;
+    virtual void FireStored() = 0;
 protected:
+    /**
+     * @brief Starts firing, during which callbacks stay where they are.
+     *
+     * Callbacks subscribed while firing are first called the next time.
+     *
+     * @return The number of callbacks to fire.
+     */
+    size_t BeginFire()
+    {
+        ++mFiring;
+        return mEntries.size();
+    }
+    
+    /**
+     * @brief Returns a callback to fire (empty if unsubscribed while firing).
+     */
+    const gxCallback& GetCallback( size_t aIndex ) const
+    {
+        return mEntries[ aIndex ].mCallback;
+    }
+    
+    /**
+     * @brief Ends firing.
+     */
+    void EndFire()
+    {
+        if ( --mFiring == 0 && mDead )
+            Compact();
+    }
     
     /**
      * @brief Checks if a callback is already in the subscription list.
@@ -106,175 +302,178 @@ protected:
      */
     bool AlreadySubscribed( gxCallback &aCallback );
 private:
-    typedef std::vector< gxCallback > gxCallbacks;
+    struct Entry
+    {
+        gxCallback mCallback;
+        unsigned   mSlot;
+    };
+    
+    struct Slot
+    {
+        // The index of the entry (or, for free slots, of the next free one)
+        unsigned mEntry;
+        unsigned mGeneration;
+    };
+    
+    typedef std::vector< Entry >                  gxEntries;
+    typedef std::vector< Slot >                   gxSlots;
+    typedef std::vector< unsigned >               gxFreeSlots;
+    typedef std::unordered_map< void*, unsigned > gxObjectSlots;
+    
+    /**
+     * @brief The callbacks subscribed to this event (empty callbacks are ones
+     * unsubscribed while firing, removed once done).
+     */
+    gxEntries mEntries;
+    
+    gxSlots     mSlots;
+    gxFreeSlots mFreeSlots;
+    
+    // The slot of each subscribed object
+    gxObjectSlots mObjectSlots;
+    
+    // The depth of (nested) firing, during which entries aren't moved
+    unsigned mFiring;
+    
+    // Whether or not entries were unsubscribed while firing
+    bool mDead;
+    
     /**
-     * @brief The list of callback subscribed to this event.
+     * @brief Removes the entry of a slot, and frees the slot.
      */
-    gxCallbacks mCallbacks;
+    void Remove( unsigned aSlot );
+    
+    /**
+     * @brief Removes the entries unsubscribed while firing.
+     */
+    void Compact();
+    
+    // Subjects queue events
+    friend class gxSubject;
+    
+    /**
+     * @brief Whether or not the event is in the queue of its subject (so it
+     * is only queued once).
+     */
+    bool mQueued;
 };
 
 
 /**
- * @brief A specialized event class for events with no parameters.
+ * @brief Index lists, for unpacking stored event arguments.
  */
-class gxEvent0 : public gxEvent
-{
-public:
-    typedef fastdelegate::FastDelegate0<> gxDelegate;
+template < size_t... tIndices >
+struct gxIndices { };
 
-    /**
-     * @brief Calls the actual callback.
-     *
-     * The base class gxEvent will call this for each callback, or the subject
-     * will call this directly upon subscription of bound events.
-     */
-    virtual void Fire( gxCallback &aCallback )
-    {
-        mDelegate.SetMemento( aCallback );
-        mDelegate();
-    }
-private:
-    gxDelegate mDelegate;
+template < size_t tCount, size_t... tIndices >
+struct gxMakeIndices : gxMakeIndices< tCount - 1, tCount - 1, tIndices... > { };
+
+template < size_t... tIndices >
+struct gxMakeIndices< 0, tIndices... >
+{
+    typedef gxIndices< tIndices... > type;
 };
 
 /**
- * @brief A specialized event class for events with 1 parameter.
+ * @brief An event whose callbacks take the parameters tArgs.
+ *
+ * Firing passes the arguments by reference straight to the callbacks, which
+ * are called in place (without a virtual call, or setting up a delegate, per
+ * callback). Arguments are only copied into the event when it is queued or
+ * posted, to be {@link gxEvent::FireStored() fired later}.
+ *
+ * **Note:** Parameters should not be references, as they are stored by
+ * value when queuing.
  */
-template < typename t1 >
-class gxEvent1 : public gxEvent
+template < typename... tArgs >
+class gxTypedEvent : public gxEvent
 {
 public:
-    typedef fastdelegate::FastDelegate1< t1 > gxDelegate;
+    typedef typename gxDelegateOf< tArgs... >::type gxDelegate;
     
     /**
-     * @brief Caches the arguments about to be fired (or queued) with this
-     * event.
+     * @brief Calls all callbacks with the given arguments.
      */
-    void SetParams( t1 a1 )
+    void Fire( typename gxParam< tArgs >::type... aArgs )
     {
-        m1 = a1;
+        size_t iCount = BeginFire();
+        
+        for ( size_t i = 0; i < iCount; ++i )
+        {
+            // Callbacks may be added to while firing, so copy each.
+            gxCallback iCallback = GetCallback( i );
+            
+            // Unsubscribed while firing
+            if ( iCallback.empty() )
+                continue;
+            
+            iCallback.Call< tArgs... >( aArgs... );
+        }
+        
+        EndFire();
     }
     
     /**
-     * @brief Calls the actual callback with the cached arguments.
+     * @brief Calls a specific callback with the given arguments.
      *
-     * The base class gxEvent will call this for each callback, or the subject
-     * will call this directly upon subscription of bound events.
+     * The subject will call this directly upon subscription of bound events.
      */
-    virtual void Fire( gxCallback &aCallback )
+    void FireTo( const gxCallback &aCallback,
+                 typename gxParam< tArgs >::type... aArgs )
     {
-        mDelegate.SetMemento( aCallback );
-        mDelegate( m1 );
+        aCallback.Call< tArgs... >( aArgs... );
     }
-private:
-    gxDelegate mDelegate;
-    
-    t1 m1;
-};
-
-/**
- * @brief A specialized event class for events with 2 parameters.
- */
-template < typename t1, typename t2 >
-class gxEvent2 : public gxEvent
-{
-public:
-    typedef fastdelegate::FastDelegate2< t1, t2 > gxDelegate;
     
     /**
-     * @brief Caches the arguments about to be fired (or queued) with this
-     * event.
+     * @brief Stores the arguments about to be queued with this event.
      */
-    void SetParams( t1 a1, t2 a2 )
+    void SetParams( typename gxParam< tArgs >::type... aArgs )
     {
-        m1 = a1; m2 = a2;
+        mParams = gxParams( aArgs... );
     }
     
     /**
-     * @brief Calls the actual callback with the cached arguments.
-     *
-     * The base class gxEvent will call this for each callback, or the subject
-     * will call this directly upon subscription of bound events.
-     */    
-    virtual void Fire( gxCallback &aCallback )
-    {
-        mDelegate.SetMemento( aCallback );
-        mDelegate( m1, m2 );
-    }
-private:
-    gxDelegate mDelegate;
-    
-    t1 m1; t2 m2;
-};
-
-/**
- * @brief A specialized event class for events with 3 parameters.
- */
-template < typename t1, typename t2, typename t3 >
-class gxEvent3 : public gxEvent
-{
-public:
-    typedef fastdelegate::FastDelegate3< t1, t2, t3 > gxDelegate;
-    
-    /**
-     * @brief Caches the arguments about to be fired (or queued) with this
-     * event.
+     * @brief Copies arguments, for firing the event later on (see
+     * gxEventArgs).
      */
-    void SetParams( t1 a1, t2 a2, t3 a3 )
+    gxEventArgs* CopyParams( typename gxParam< tArgs >::type... aArgs )
     {
-        m1 = a1; m2 = a2; m3 = a3;
+        return new Args( *this, aArgs... );
     }
     
-    /**
-     * @brief Calls the actual callback with the cached arguments.
-     *
-     * The base class gxEvent will call this for each callback, or the subject
-     * will call this directly upon subscription of bound events.
-     */
-    virtual void Fire( gxCallback &aCallback )
+    virtual void FireStored()
     {
-        mDelegate.SetMemento( aCallback );
-        mDelegate( m1, m2, m3 );
+        // Callbacks may queue the event again while it fires, so fire a copy.
+        gxParams iParams( mParams );
+        
+        FireStored( iParams, typename gxMakeIndices< sizeof...( tArgs ) >::type() );
     }
 private:
-    gxDelegate mDelegate;
+    typedef std::tuple< tArgs... > gxParams;
     
-    t1 m1; t2 m2; t3 m3;
-};
-
-/**
- * @brief A specialized event class for events with 4 parameters.
- */
-template < typename t1, typename t2, typename t3, typename t4 >
-class gxEvent4 : public gxEvent
-{
-public:
-    typedef fastdelegate::FastDelegate4< t1, t2, t3, t4 > gxDelegate;
-
-    /**
-     * @brief Caches the arguments about to be fired (or queued) with this
-     * event.
-     */
-    void SetParams( t1 a1, t2 a2, t3 a3, t4 a4 )
+    class Args : public gxEventArgs
     {
-        m1 = a1; m2 = a2; m3 = a3; m4 = a4;
-    }
+    public:
+        Args( gxTypedEvent& aEvent,
+              typename gxParam< tArgs >::type... aArgs )
+          : mEvent ( aEvent ),
+            mParams( aArgs... ) { }
+        
+        virtual void Apply() { mEvent.mParams = mParams; }
+    private:
+        gxTypedEvent& mEvent;
+        
+        gxParams mParams;
+    };
     
-    /**
-     * @brief Calls the actual callback with the cached arguments.
-     *
-     * The base class gxEvent will call this for each callback, or the subject
-     * will call this directly upon subscription of bound events.
-     */
-    virtual void Fire( gxCallback &aCallback )
+    template < size_t... tIndices >
+    void FireStored( const gxParams&         aParams,
+                     gxIndices< tIndices... > )
     {
-        mDelegate.SetMemento( aCallback );
-        mDelegate( m1, m2, m3, m4 );
+        Fire( std::get< tIndices >( aParams )... );
     }
-private:
-    gxDelegate mDelegate;
     
-    t1 m1; t2 m2; t3 m3; t4 m4;
+    gxParams mParams;
 };
 
 #endif // gxEvent_h
@@ -31,6 +31,9 @@
   * **Note:** In order for this macro to work, the observer class must use the
   * gxDeclareObserver() macro.
   *
+  * The subscription handle is returned, should the observer rather
+  * unsubscribe with it.
+  *
   * Example usage:
   *
   *     aObserver->gxSubscribe( evSizeChanged, OnSizeChanged )
@@ -1,15 +1,40 @@
 #include "gxSubject.h"
 
+gxSubject::gxSubjects     gxSubject::mPendingSubjects;
+gxSubject::gxFlushRequest gxSubject::mFlushRequest;
+gxSubject::gxSubjects*    gxSubject::mFlushingSubjects = NULL;
+
+gxMpscQueue< gxSubject::gxPostedEvent > gxSubject::mPostedEvents;
+gxSubject::gxFlushRequest               gxSubject::mPostRequest;
+std::mutex                              gxSubject::mPostRequestMutex;
+gxSubject::gxSubjectSerials             gxSubject::mAffineSubjects;
+unsigned long                           gxSubject::mLastSerial = 0;
+
 gxSubject::~gxSubject()
 {
+    // Subjects being flushed are taken out as they flush, so if found there
+    // this is where this one is pending.
+    if ( mFlushPending )
+    {
+        if ( mFlushingSubjects &&
+             mPendingIndex < mFlushingSubjects->size() &&
+             (*mFlushingSubjects)[ mPendingIndex ] == this )
+            (*mFlushingSubjects)[ mPendingIndex ] = NULL;
+        else
+            mPendingSubjects[ mPendingIndex ] = NULL;
+    }
+    
+    if ( mThreadAffine )
+        mAffineSubjects.erase( this );
+    
     mEventsQueue.clear();
 }
 
-void gxSubject::Subscribe( gxEvent &aEvent, gxCallback aCallback )
+gxSubscription gxSubject::Subscribe( gxEvent &aEvent, gxCallback aCallback )
 {
     // We delegate the subscription to the event itself, as each event keeps
     // a its own callbacks references.
-    aEvent.Subscribe( aCallback );
+    return aEvent.Subscribe( aCallback );
 }
 
 void gxSubject::Unsubscribe( gxEvent &aEvent, void *aObj )
@@ -19,16 +44,9 @@ void gxSubject::Unsubscribe( gxEvent &aEvent, void *aObj )
     aEvent.Unsubscribe( aObj );
 }
 
-void gxSubject::Fire( gxEvent &aEvent, gxCallback aCallback )
-{    
-    if ( mFiringMode == on )
-    {
-        // If a specific callback was requested then only fire that one,
-        // otherwise Fire() will fire all callbacks.
-        aCallback.empty() ? aEvent.Fire() : aEvent.Fire( aCallback );
-    } else if ( mFiringMode == queue ) {
-        QueueEvent( aEvent );
-    } // Otherwise FiringMode is off
+void gxSubject::Unsubscribe( gxEvent &aEvent, gxSubscription aSubscription )
+{
+    aEvent.Unsubscribe( aSubscription );
 }
 
 void gxSubject::SuspendEvents( bool aQueueSuspended )
@@ -38,35 +56,212 @@ void gxSubject::SuspendEvents( bool aQueueSuspended )
 
 void gxSubject::ResumeEvents()
 {
+    mFiringMode = on;
+    
+    FlushEvents();
+}
+
+void gxSubject::CoalesceEvents()
+{
+    mFiringMode = coalesce;
+}
+
+void gxSubject::FlushEvents()
+{
+    // Take the queue first, as observers may fire events (and queue them
+    // again) while handling these.
+    gxEventsQueue iQueue;
+    iQueue.swap( mEventsQueue );
+    
     gxEventsQueue::iterator iEvent;
     
-    // For each event
-    for( iEvent = mEventsQueue.begin(); iEvent != mEventsQueue.end(); ++iEvent )
+    for ( iEvent = iQueue.begin(); iEvent != iQueue.end(); ++iEvent )
     {
-        (**iEvent).Fire();
+        (**iEvent).mQueued = false;
     }
     
-    mFiringMode = on;
+    // For each event
+    for ( iEvent = iQueue.begin(); iEvent != iQueue.end(); ++iEvent )
+    {
+        (**iEvent).FireStored();
+    }
 }
 
-bool gxSubject::EventAlreadyInQueue( gxEvent &aEvent )
+void gxSubject::SetFlushRequest( gxFlushRequest aFlushRequest )
 {
-    gxEventsQueue::iterator iEvent;
+    mFlushRequest = aFlushRequest;
+}
+
+void gxSubject::FlushCoalescedEvents()
+{
+    // Flushing from an observer, while flushing, is left to the flush going
+    // on.
+    if ( mFlushingSubjects )
+        return;
     
-    // For each event
-    for( iEvent = mEventsQueue.begin(); iEvent != mEventsQueue.end(); ++iEvent )
+    // Take the pending subjects first, as observers may have subjects queue
+    // events again while these fire; those are left for the next flush.
+    gxSubjects iSubjects;
+    iSubjects.swap( mPendingSubjects );
+    
+    mFlushingSubjects = &iSubjects;
+    
+    for ( size_t i = 0; i < iSubjects.size(); ++i )
     {
-        // Check if the event is already in the queue
-        if ( (*iEvent) == &aEvent )
-        {
-            return true;
-        }
+        // Subjects are taken one at a time, as observers may delete the
+        // others (which leave NULL behind).
+        gxSubject *iSubject = iSubjects[ i ];
+        
+        if ( !iSubject )
+            continue;
+        
+        iSubjects[ i ] = NULL;
+        
+        iSubject->mFlushPending = false;
+        iSubject->FlushEvents();
     }
-    return false;
+    
+    mFlushingSubjects = NULL;
 }
 
 void gxSubject::QueueEvent( gxEvent &aEvent )
 {
-    if ( !EventAlreadyInQueue( aEvent ) )
-        mEventsQueue.push_back( &aEvent );
-}
\ No newline at end of file
+    // The event keeps its most recent arguments, so it only needs queuing
+    // once.
+    if ( aEvent.mQueued )
+        return;
+    
+    aEvent.mQueued = true;
+    mEventsQueue.push_back( &aEvent );
+    
+    if ( mFiringMode == coalesce && !mFlushPending )
+    {
+        mFlushPending = true;
+        mPendingIndex = mPendingSubjects.size();
+        mPendingSubjects.push_back( this );
+        
+        mFlushRequest();
+    }
+}
+
+void gxSubject::FireStored( gxEvent &aEvent )
+{
+    if ( IsFiringNow( false ) )
+    {
+        gxTraceScope( "fire", typeid( aEvent ), this );
+        aEvent.FireStored();
+    } else if ( mFiringMode != off ) {
+        // The arguments are already stored.
+        QueueEvent( aEvent );
+    } // Otherwise FiringMode is off
+}
+
+void gxSubject::SetThreadAffine()
+{
+    mThread = std::this_thread::get_id();
+    
+    // Events already posted stay deliverable.
+    if ( !mThreadAffine )
+    {
+        mThreadAffine = true;
+        mSerial       = ++mLastSerial;
+        
+        mAffineSubjects[ this ] = mSerial;
+    }
+}
+
+void gxSubject::SetPostRequest( gxFlushRequest aPostRequest )
+{
+    // Waits for the handler to return if a posting thread is calling it.
+    std::lock_guard< std::mutex > iLock( mPostRequestMutex );
+    
+    mPostRequest = aPostRequest;
+    
+    // Events posted with no handler asked for no delivery, and later ones
+    // won't either (the queue isn't empty).
+    if ( mPostRequest && !mPostedEvents.IsEmpty() )
+        mPostRequest();
+}
+
+gxSubject::gxFlushRequest gxSubject::GetPostRequest()
+{
+    std::lock_guard< std::mutex > iLock( mPostRequestMutex );
+    
+    return mPostRequest;
+}
+
+void gxSubject::Post( gxEvent &aEvent, gxEventArgs *aArgs )
+{
+    gxPostedEvent *iPosted = new gxPostedEvent;
+    iPosted->mSubject = this;
+    iPosted->mSerial  = mSerial;
+    iPosted->mEvent   = &aEvent;
+    iPosted->mArgs    = aArgs;
+    
+    // Only the first event posted since the last delivery needs to ask for
+    // one. The handler is called with the lock held, so it can't be unset
+    // (and its object deleted) while running.
+    if ( mPostedEvents.Push( iPosted ) )
+    {
+        std::lock_guard< std::mutex > iLock( mPostRequestMutex );
+        
+        if ( mPostRequest )
+            mPostRequest();
+    }
+}
+
+void gxSubject::DeliverPostedEvents()
+{
+    // Only the most recent arguments of each event are delivered, in the
+    // order the events were first posted.
+    typedef std::unordered_map< gxEvent*, size_t > gxIndices;
+    
+    std::vector< gxPostedEvent* > iLatest;
+    gxIndices                     iIndices;
+    
+    gxPostedEvent *iPosted = mPostedEvents.PopAll();
+    
+    while ( iPosted )
+    {
+        gxPostedEvent *iNext = iPosted->mNext;
+        
+        std::pair< gxIndices::iterator, bool > iIndex =
+            iIndices.insert( std::make_pair( iPosted->mEvent, iLatest.size() ) );
+        
+        if ( iIndex.second )
+        {
+            iLatest.push_back( iPosted );
+        } else {
+            gxPostedEvent *&iSuperseded = iLatest[ iIndex.first->second ];
+            
+            delete iSuperseded->mArgs;
+            delete iSuperseded;
+            
+            iSuperseded = iPosted;
+        }
+        
+        iPosted = iNext;
+    }
+    
+    for ( size_t i = 0; i < iLatest.size(); ++i )
+    {
+        gxPostedEvent *iEvent = iLatest[ i ];
+        
+        // Observers may delete subjects, so check each time. The serial
+        // tells a subject apart from one allocated where a deleted one was.
+        gxSubjectSerials::const_iterator iSubject =
+            mAffineSubjects.find( iEvent->mSubject );
+        
+        if ( iSubject != mAffineSubjects.end() &&
+             iSubject->second == iEvent->mSerial )
+        {
+            if ( iEvent->mArgs )
+                iEvent->mArgs->Apply();
+            
+            iEvent->mSubject->FireStored( *iEvent->mEvent );
+        }
+        
+        delete iEvent->mArgs;
+        delete iEvent;
+    }
+}
@@ -4,15 +4,25 @@
 /** @file gxSubject.h */
 
 #include "gxEvent.h"
+#include "core/gxMpscQueue.h"
+#include "core/gxTrace.h"
+
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 /**
  * @brief The base class for all subjects (aka observabales).
  *
  * Subjects fire events, to which observers subscribe.
- * This class also allows the suspension of events (with a queuing option).
+ * This class also allows the suspension of events (with a queuing option),
+ * the coalescing of events so they fire at most once per frame, and the
+ * delivery of events fired on other threads on the subject's own thread.
  *
  * Subclasses define their own events using the #gxDefineEvent() or 
- * #gxDefineBoundEvent() macros. For example:
+ * #gxDefineBoundEvent() macros, which generate {@link gxTypedEvent typed
+ * events} and methods to subscribe to and fire them. For example:
  * 
  *     class Figure : virtual public gxSubject
  *     {
@@ -30,7 +40,11 @@ private:
 
 public:
     gxSubject():
-        mFiringMode( on ) { }
+        mFiringMode( on ),
+        mFlushPending( false ),
+        mPendingIndex( 0 ),
+        mThreadAffine( false ),
+        mSerial( 0 ) { }
     
     virtual ~gxSubject();
 
@@ -38,8 +52,9 @@ public:
      * @brief Allows observers to subscribe to a particular event.
      * @param aEvent The {@link gxEvent event} to which observers subscribe.
      * @param aCallback The observer's callback handeling this event.
+     * @return The subscription handle, with which to unsubscribe.
      */
-    void Subscribe( gxEvent &aEvent, gxCallback aCallback );
+    gxSubscription Subscribe( gxEvent &aEvent, gxCallback aCallback );
 
     /**
      * @brief Allows observers unsubscribe from a particular event.
@@ -48,6 +63,13 @@ public:
      */
     void Unsubscribe( gxEvent &aEvent, void *aObj );
 
+    /**
+     * @brief Ends a subscription to a particular event.
+     * @param aEvent The {@link gxEvent event} subscribed to.
+     * @param aSubscription The handle returned upon subscription.
+     */
+    void Unsubscribe( gxEvent &aEvent, gxSubscription aSubscription );
+
     /**
      * @brief Suspends the firing of events.
      *
@@ -68,21 +90,142 @@ public:
      */
     void ResumeEvents();
     
+    /**
+     * @brief Coalesces events, so each fires at most once per frame.
+     *
+     * Events fired by the subject are queued (each once) and fired with their
+     * most recent arguments by FlushCoalescedEvents(), which the lightweight
+     * system calls once per frame. Subjects firing often (like zoom and scroll
+     * managers upon mouse wheel events) then only have their observers
+     * respond once per frame. Bound events still fire straight away to
+     * observers upon subscription.
+     *
+     * Until a flush request is {@link gxSubject::SetFlushRequest() set},
+     * events fire straight away, as nothing would flush them. ResumeEvents()
+     * turns coalescing off.
+     */
+    void CoalesceEvents();
+    
+    /**
+     * @brief Fires the queued events (each once, with their most recent
+     * arguments) without changing the firing mode.
+     */
+    void FlushEvents();
+    
+    typedef fastdelegate::FastDelegate0<> gxFlushRequest;
+    
+    /**
+     * @brief Sets the handler called when a coalescing subject queues an event
+     * (and wasn't already waiting for a flush), which should see
+     * FlushCoalescedEvents() called (say, by queueing a frame).
+     *
+     * @param aFlushRequest The handler, or an empty delegate for none.
+     */
+    static void SetFlushRequest( gxFlushRequest aFlushRequest );
+    
+    /**
+     * @brief Returns the handler set by SetFlushRequest().
+     */
+    static gxFlushRequest GetFlushRequest() { return mFlushRequest; }
+    
+    /**
+     * @brief Flushes the events of all coalescing subjects.
+     */
+    static void FlushCoalescedEvents();
+    
+    /**
+     * @brief Makes the subject thread-affine to the calling thread (normally,
+     * the UI thread).
+     *
+     * Events fired on other threads (like background threads feeding the
+     * model) then don't call observers there. Instead, their arguments are
+     * copied and posted on a lock-free queue, and DeliverPostedEvents(), which
+     * the lightweight system calls at the start of each frame, fires them on
+     * this thread. Observers thus need no locking of their own.
+     *
+     * **Note:** Arguments are copied as they are, so pointers (like those of
+     * bound events) should point to data safe to read on the subject's thread.
+     * Thread-affine subjects must be deleted on their thread.
+     */
+    void SetThreadAffine();
+    
+    /**
+     * @brief Sets the handler called when events are posted and none were
+     * pending, which should see DeliverPostedEvents() called on the thread of
+     * the subjects (say, by queueing a frame).
+     *
+     * **Note:** The handler is called on the posting thread. Once this
+     * returns, the previous handler is neither running nor called again, so
+     * its object may be deleted.
+     *
+     * If events were posted while there was no handler, the new handler is
+     * called straight away.
+     *
+     * @param aPostRequest The handler, or an empty delegate for none.
+     */
+    static void SetPostRequest( gxFlushRequest aPostRequest );
+    
+    /**
+     * @brief Returns the handler set by SetPostRequest().
+     */
+    static gxFlushRequest GetPostRequest();
+    
+    /**
+     * @brief Fires the events posted from other threads; only called on the
+     * thread the subjects are affine to.
+     *
+     * Events are delivered in batches: all posted since the last delivery, in
+     * the order first posted, each once with its most recent arguments.
+     */
+    static void DeliverPostedEvents();
+    
 protected:
     /**
      * @brief Fires an event, accounting for any event supspension or queuing.
      *
+     * The arguments are passed on by reference, and only copied into the
+     * event if it is queued (or posted from another thread).
+     *
      * **Note:** The actual Fire method used with subjects is the one generated
-     * by the #gxDefineEvent() or #gxDefineBoundEvent() macros, which will have
-     * the correct vari-length parameters for the event being called. The macros
-     * will also ensure that the passed parameters are chached in the event 
-     * prior to firing it.
+     * by the #gxDefineEvent() or #gxDefineBoundEvent() macros, which forwards
+     * here.
      *
      * @param aEvent The {@link gxEvent event} to be fired.
-     * @param [aCallback] The {@link gxCallback callback} to be fired. Defaults
-     * to an empty callback, in which case all callbacks will be called.
+     * @param aArgs The event arguments.
      */
-    void Fire( gxEvent &aEvent, gxCallback aCallback = gxCallback() );
+    template < typename... tArgs >
+    void Fire( gxTypedEvent< tArgs... > &aEvent,
+               typename gxParam< tArgs >::type... aArgs )
+    {
+        if ( IsForeignThread() )
+        {
+            Post( aEvent, aEvent.CopyParams( aArgs... ) );
+        } else if ( IsFiringNow( false ) ) {
+            gxTraceScope( "fire", typeid( aEvent ), this );
+            aEvent.Fire( aArgs... );
+        } else if ( mFiringMode != off ) {
+            aEvent.SetParams( aArgs... );
+            QueueEvent( aEvent );
+        } // Otherwise FiringMode is off
+    }
+
+    /**
+     * @brief Returns whether or not the subject is thread-affine, and events
+     * are fired on another thread.
+     */
+    bool IsForeignThread() const
+    {
+        return mThreadAffine && std::this_thread::get_id() != mThread;
+    }
+
+    /**
+     * @brief Posts an event fired on another thread, for delivery on the
+     * subject's thread.
+     *
+     * @param aEvent The event.
+     * @param aArgs The event arguments (deleted once delivered).
+     */
+    void Post( gxEvent &aEvent, gxEventArgs *aArgs );
 
     /**
      * @brief Fires an event to a specific callback, accounting for any event 
@@ -93,29 +236,93 @@ protected:
      *
      * @param aEvent The {@link gxEvent event} to be fired.
      * @param aCallback The {@link gxCallback callback} to be fired.     
+     * @param aArgs The event arguments.
      */
-//    void Fire( gxEvent &aEvent, gxCallback aCallback );
+    template < typename... tArgs >
+    void FireTo( gxTypedEvent< tArgs... > &aEvent,
+                 const gxCallback         &aCallback,
+                 typename gxParam< tArgs >::type... aArgs )
+    {
+        if ( IsFiringNow( true ) )
+        {
+            gxTraceScope( "fire", typeid( aEvent ), this );
+            aEvent.FireTo( aCallback, aArgs... );
+        } else if ( mFiringMode != off ) {
+            aEvent.SetParams( aArgs... );
+            QueueEvent( aEvent );
+        } // Otherwise FiringMode is off
+    }
 
 private:
-    /** The event Firing mode can be one of 3: */
+    /** The event Firing mode can be one of 4: */
     enum gxFiringMode {
-        on,   /**< Events will fire straigt away. */
-        off,  /**< No events will be fired. */
-        queue /**< Events will be queued and fired once ResumeEvents() is 
-               * called. */
+        on,      /**< Events will fire straigt away. */
+        off,     /**< No events will be fired. */
+        queue,   /**< Events will be queued and fired once ResumeEvents() is 
+                  * called. */
+        coalesce /**< Events will be queued and fired once
+                  * FlushCoalescedEvents() is called. */
     } mFiringMode;
     
     typedef std::vector< gxEvent* > gxEventsQueue;
     // The events queue
     gxEventsQueue mEventsQueue;
     
+    typedef std::vector< gxSubject* > gxSubjects;
+    // The coalescing subjects with queued events, and the handler told once
+    // there are some. Subjects deleted while pending leave NULL behind.
+    static gxSubjects     mPendingSubjects;
+    static gxFlushRequest mFlushRequest;
+    
+    // The pending subjects being flushed (taken out of mPendingSubjects), if
+    // any
+    static gxSubjects*    mFlushingSubjects;
+    
+    // Whether or not this subject is one of the pending subjects (or of those
+    // being flushed), and where
+    bool   mFlushPending;
+    size_t mPendingIndex;
+    
+    // An event posted from another thread
+    struct gxPostedEvent
+    {
+        gxSubject      *mSubject;
+        unsigned long   mSerial;
+        gxEvent        *mEvent;
+        gxEventArgs    *mArgs;
+        gxPostedEvent  *mNext;
+    };
+    
+    typedef std::unordered_map< gxSubject*, unsigned long > gxSubjectSerials;
+    // The events posted, the handler told once there are some (guarded, as
+    // it's called on posting threads), and the serials of the live
+    // thread-affine subjects (so events of deleted ones aren't delivered,
+    // even to a subject since allocated at the same address)
+    static gxMpscQueue< gxPostedEvent > mPostedEvents;
+    static gxFlushRequest               mPostRequest;
+    static std::mutex                   mPostRequestMutex;
+    static gxSubjectSerials             mAffineSubjects;
+    static unsigned long                mLastSerial;
+    
+    // Whether or not this subject is thread-affine, to which thread, and its
+    // serial
+    bool            mThreadAffine;
+    std::thread::id mThread;
+    unsigned long   mSerial;
+
     /**
-     * @brief Checks if an {@link gxEvent event} already in the queue.
+     * @brief Returns whether or not events fire straight away (otherwise they
+     * are queued, or dropped if firing is off).
      *
-     * @param aEvent The {@link gxEvent event} to check.
-     * @return true if the event is already in the queue.
-     */    
-    bool EventAlreadyInQueue( gxEvent &aEvent );
+     * @param aSpecific Whether the event fires to a specific callback.
+     */
+    bool IsFiringNow( bool aSpecific ) const
+    {
+        // Coalescing only applies to firing to all callbacks, and only once
+        // something flushes coalesced events.
+        return mFiringMode == on ||
+               ( mFiringMode == coalesce && ( aSpecific || !mFlushRequest ) );
+    }
 
     /**
      * @brief Puts an {@link gxEvent event} in the queue.
@@ -123,6 +330,14 @@ private:
      * @param aEvent The {@link gxEvent event} to be queued.
      */
     void QueueEvent( gxEvent &aEvent );
+
+    /**
+     * @brief Fires an event with its stored arguments (those posted from
+     * another thread), accounting for any event supspension or queuing.
+     *
+     * @param aEvent The {@link gxEvent event} to be fired.
+     */
+    void FireStored( gxEvent &aEvent );
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -137,9 +352,9 @@ private:
  *  The #gxSubscribe() macro is the one calling the generated method.
  */
 #define gxImpSubscribe( mEvent ) \
-    void mEvent##Subscribe( mEvent##Type::gxDelegate aDelegate ) \
+    gxSubscription mEvent##Subscribe( mEvent##Type::gxDelegate aDelegate ) \
     { \
-        Subscribe( mEvent, aDelegate.GetMemento() ); \
+        return Subscribe( mEvent, aDelegate.GetMemento() ); \
     }
 
 /** The implementation of an event unsubsceiption.
@@ -153,6 +368,10 @@ private:
     { \
         Unsubscribe( mEvent, aObj ); \
     } \
+    void mEvent##Unsubscribe( gxSubscription aSubscription ) \
+    { \
+        Unsubscribe( mEvent, aSubscription ); \
+    } \
 
 /** Common non-bound event macro.
  * It generates the event member variable, and the subscription related methods.
@@ -162,16 +381,6 @@ private:
     gxImpSubscribe( mEvent ) \
     gxImpUnsubscribe( mEvent )
 
-/** A macro generating a common vari-argument fire methods.
- * First, we set the parameters of the relevant event. This will be useful if
- * events are queued rather than fired straight away. Then we fire the event.
- */
-#define gxImpFire( mEvent, ... ) \
-    { \
-        mEvent.SetParams(  __VA_ARGS__  ); \
-        gxSubject::Fire( mEvent ); \
-    }
-
 ////////////////////////////////////////////////////////////////////////////////
 //               Non-bound Events: Variable parameter event generator         //
 //----------------------------------------------------------------------------//
@@ -180,54 +389,15 @@ private:
 // Note that the event type is a class rather than typedef, so it is unique.  //
 ////////////////////////////////////////////////////////////////////////////////
 
-/** Generates code for events with no parameters. */
-#define gxDefineEvent0( mEvent ) \
-    class mEvent##Type : public gxEvent0 {}; \
-    gxImpEventCommon( mEvent ) \
-    void Fire( mEvent##Type &aEvent ) \
-    { \
-        gxSubject::Fire( mEvent ); \
-    }
-
-/** Generates code for events with 1 parameter. */
-#define gxDefineEvent1( mEvent, t1 ) \
-    class mEvent##Type : public gxEvent1< t1 > {}; \
-    gxImpEventCommon( mEvent ) \
-    void Fire( mEvent##Type &aEvent, t1 a1 ) \
-        gxImpFire( aEvent, a1 ) \
-
-/** Generates code for events with 2 parameters. */
-#define gxDefineEvent2( mEvent, t1, t2 ) \
-    class mEvent##Type : public gxEvent2< t1, t2 > {}; \
-    gxImpEventCommon( mEvent ) \
-    void Fire( mEvent##Type &aEvent, t1 a1, t2 a2 ) \
-        gxImpFire( aEvent, a1, a2 ) \
-
-/** Generates code for events with 3 parameters. */
-#define gxDefineEvent3( mEvent, t1, t2, t3 ) \
-    class mEvent##Type : public gxEvent3< t1, t2, t3 > {}; \
-    gxImpEventCommon( mEvent ) \
-    void Fire( mEvent##Type &aEvent, t1 a1, t2 a2, t3 a3 ) \
-        gxImpFire( aEvent, a1, a2, a3 ) \
-
-/** Generates code for events with 4 parameters. */
-#define gxDefineEvent4( mEvent, t1, t2, t3, t4 ) \
-    class mEvent##Type : public gxEvent4< t1, t2, t3, t4 > {}; \
-    gxImpEventCommon( mEvent ) \
-    void Fire( mEvent##Type &aEvent, t1 a1, t2 a2, t3 a3, t4 a4 ) \
-        gxImpFire( aEvent, a1, a2, a3, a4 ) \
-
-
-/** A router macros to get us to the macro with the correct amount of parameters.
- * Based on http://stackoverflow.com/questions/3046889/optional-parameters-with-c-macros
- */
-#define gxDefineEventX( x, A, B, C, D, BINGO, ...) BINGO
 /**
  * Defines a non-bound event and its (variable length) parameters. 
  * Example usage:
  *
  *     gxDefineEvent( evAgeChange, int )
  *
+ * Events may have up to eight parameters. The generated Fire method takes
+ * any arguments converting to these, and passes them on by reference.
+ *
  * **Note:** Do not use const before primitive types, as compilers often omit
  * that const in callback signature (the callback may still have const for its
  * parameters, just don't include it in the event definition). Non primitive
@@ -238,13 +408,13 @@ private:
  * @param mEvent The event name, which will become the name of the event member.
  */
 #define gxDefineEvent( mEvent, ...)\
-    gxDefineEventX( mEvent, ##__VA_ARGS__,\
-        gxDefineEvent4( mEvent, __VA_ARGS__),\
-        gxDefineEvent3( mEvent, __VA_ARGS__),\
-        gxDefineEvent2( mEvent, __VA_ARGS__),\
-        gxDefineEvent1( mEvent, __VA_ARGS__),\
-        gxDefineEvent0( mEvent )\
-    );
+    class mEvent##Type : public gxTypedEvent< __VA_ARGS__ > {}; \
+    gxImpEventCommon( mEvent ) \
+    template < typename... tParams > \
+    void Fire( mEvent##Type &aEvent, const tParams&... aParams ) \
+    { \
+        gxSubject::Fire< __VA_ARGS__ >( aEvent, aParams... ); \
+    }
 
 ////////////////////////////////////////////////////////////////////////////////
 //                                 Bound Events                               //
@@ -265,19 +435,23 @@ private:
  * bound to.
  */
 #define gxDefineBoundEventWithoutSender( mEvent, t1, aGetter ) \
-    class mEvent##Type : public gxEvent1< t1 > {}; \
+    class mEvent##Type : public gxTypedEvent< t1 > {}; \
     mEvent##Type mEvent; \
-    void mEvent##Subscribe( mEvent##Type::gxDelegate aDelegate ) \
+    gxSubscription mEvent##Subscribe( mEvent##Type::gxDelegate aDelegate ) \
     { \
-        Subscribe( mEvent, aDelegate.GetMemento() ); \
-        mEvent.SetParams( aGetter ); \
-        gxSubject::Fire( mEvent, aDelegate.GetMemento() ); \
+        gxSubscription iSubscription = Subscribe( mEvent, aDelegate.GetMemento() ); \
+        gxSubject::FireTo( mEvent, aDelegate.GetMemento(), aGetter ); \
+        return iSubscription; \
     } \
     gxImpUnsubscribe( mEvent )\
-    void Fire( mEvent##Type &aEvent, t1 a1 ) \
-        gxImpFire( aEvent, a1 ) \
+    void Fire( mEvent##Type &aEvent, gxParam< t1 >::type a1 ) \
+    { \
+        gxSubject::Fire( aEvent, a1 ); \
+    } \
     void Fire( mEvent##Type &aEvent ) \
-        gxImpFire( aEvent, aGetter ) \
+    { \
+        gxSubject::Fire( aEvent, aGetter ); \
+    }
 
 /**
  * Defines a bound event that also carries the sender when being fired.
@@ -292,21 +466,27 @@ private:
  * bound to.
  */
 #define gxDefineBoundEventWithSender( mEvent, tSubject, t1, aGetter ) \
-    class mEvent##Type : public gxEvent2< tSubject, t1 > {}; \
+    class mEvent##Type : public gxTypedEvent< tSubject, t1 > {}; \
     mEvent##Type mEvent; \
-    void mEvent##Subscribe( mEvent##Type::gxDelegate aDelegate ) \
+    gxSubscription mEvent##Subscribe( mEvent##Type::gxDelegate aDelegate ) \
     { \
-        Subscribe( mEvent, aDelegate.GetMemento() ); \
-        mEvent.SetParams( this, aGetter ); \
-        gxSubject::Fire( mEvent, aDelegate.GetMemento() ); \
+        gxSubscription iSubscription = Subscribe( mEvent, aDelegate.GetMemento() ); \
+        gxSubject::FireTo( mEvent, aDelegate.GetMemento(), this, aGetter ); \
+        return iSubscription; \
     } \
     gxImpUnsubscribe( mEvent )\
-    void Fire( mEvent##Type &aEvent, tSubject aSubject, t1 a1 ) \
-        gxImpFire( aEvent, aSubject, a1 ) \
-    void Fire( mEvent##Type &aEvent, t1 a1 ) \
-        gxImpFire( aEvent, this, a1 ) \
+    void Fire( mEvent##Type &aEvent, gxParam< tSubject >::type aSubject, gxParam< t1 >::type a1 ) \
+    { \
+        gxSubject::Fire( aEvent, aSubject, a1 ); \
+    } \
+    void Fire( mEvent##Type &aEvent, gxParam< t1 >::type a1 ) \
+    { \
+        gxSubject::Fire( aEvent, this, a1 ); \
+    } \
     void Fire( mEvent##Type &aEvent ) \
-        gxImpFire( aEvent, this, aGetter ) \
+    { \
+        gxSubject::Fire( aEvent, this, aGetter ); \
+    }
 
 /** A router macros to get us to the macro with the correct amount of parameters.
  * Based on http://stackoverflow.com/questions/3046889/optional-parameters-with-c-macros
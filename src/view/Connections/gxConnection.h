@@ -25,6 +25,16 @@ public:
      */
     void SetDestinationAnchor( gxAnchor* aAnchor );
     
+    /**
+     * @brief Returns the source anchor of this connection.
+     */
+    gxAnchor* GetSourceAnchor() const { return mSource; }
+    
+    /**
+     * @brief Returns the destination anchor of this connection.
+     */
+    gxAnchor* GetDestinationAnchor() const { return mDestination; }
+    
     /**
      * @brief Invalidates this connection.
      *
@@ -0,0 +1,91 @@
+#include "View/Connections/gxConnectionManager.h"
+#include "View/Connections/gxLineConnection.h"
+#include "core/gxAssert.h"
+
+#include <vector>
+
+gxConnectionManager::gxConnectionManager()
+  : mSuspended   ( 0     ),
+    mRevalidating( false )
+{
+}
+
+void gxConnectionManager::SuspendRevalidation()
+{
+    ++mSuspended;
+}
+
+void gxConnectionManager::ResumeRevalidation()
+{
+    gxWarnIf( mSuspended == 0, "ResumeRevalidation called, but not suspended" );
+
+    if ( mSuspended == 0 || --mSuspended > 0 )
+        return;
+
+    Revalidate();
+}
+
+bool gxConnectionManager::Collect( gxLineConnection* aConnection )
+{
+    // Connections invalidated while revalidating (routed ones) validate on
+    // their own.
+    if ( !IsSuspended() || mRevalidating )
+        return false;
+
+    mCollected.insert( aConnection );
+
+    return true;
+}
+
+void gxConnectionManager::Remove( gxLineConnection* aConnection )
+{
+    mCollected.erase( aConnection );
+}
+
+gxRect gxConnectionManager::GetAbsoluteBounds( gxViewElement* aFigure )
+{
+    if ( mRevalidating )
+    {
+        BoundsCache::iterator iCached = mBounds.find( aFigure );
+
+        if ( iCached != mBounds.end() )
+            return iCached->second;
+    }
+
+    gxRect iBounds = aFigure->GetBounds();
+    aFigure->TransformToAbsolute( iBounds );
+
+    if ( mRevalidating )
+        mBounds[ aFigure ] = iBounds;
+
+    return iBounds;
+}
+
+void gxConnectionManager::Revalidate()
+{
+    if ( mCollected.empty() )
+        return;
+
+    // Connections may be invalidated while revalidating, so work on a copy.
+    std::vector< gxLineConnection* > iConnections( mCollected.begin(),
+                                                   mCollected.end() );
+    mCollected.clear();
+
+    mRevalidating = true;
+
+    gxRect         iDamage;
+    gxViewElement* iRepainter = NULL;
+
+    for ( size_t i = 0; i < iConnections.size(); ++i )
+    {
+        if ( iConnections[ i ]->Revalidate( iDamage ) )
+            iRepainter = iConnections[ i ];
+    }
+
+    mBounds.clear();
+    mRevalidating = false;
+
+    // Connections are absolute, so the damage region is absolute too.
+    if ( iRepainter && iDamage.width && iDamage.height )
+        iRepainter->Repaint( iDamage, false );
+}
@@ -0,0 +1,99 @@
+#ifndef gxConnectionManager_h
+#define gxConnectionManager_h
+
+#include "core/gxObject.h"
+#include "core/geometry/gxGeometry.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+// Forward declarations
+class gxViewElement;
+class gxLineConnection;
+
+/**
+ * @brief Revalidates connections in batches, for mutations that move many
+ * figures at once (like dragging a selection).
+ *
+ * Normally, each figure that moves invalidates its anchored connections,
+ * each of which erases itself and goes through validation on its own - a
+ * connection between two moved figures does so twice.
+ *
+ * While suspended, the manager instead collects the connections invalidated
+ * (each once). Once resumed, it recomputes all their end points in one pass,
+ * transforming the bounds of each anchored figure to absolute coordinates
+ * only once however many connections it has, and then repaints a single
+ * region - the union of the connections bounds before and after the change.
+ *
+ * Connections use the manager once {@link gxLineConnection::SetManager()
+ * set} to it. The manager must outlive them.
+ */
+class gxConnectionManager: public gxObject
+{
+public:
+    gxConnectionManager();
+
+    /**
+     * @brief Suspends the revalidation of connections, collecting them
+     * instead.
+     *
+     * Calls can be nested; revalidation resumes with the outermost
+     * ResumeRevalidation().
+     */
+    void SuspendRevalidation();
+
+    /**
+     * @brief Resumes the revalidation of connections, revalidating all
+     * collected ones.
+     */
+    void ResumeRevalidation();
+
+    /**
+     * @brief Returns whether or not revalidation is suspended.
+     */
+    bool IsSuspended() const { return mSuspended > 0; }
+
+    /**
+     * @brief Collects an invalid connection, if revalidation is suspended.
+     *
+     * Called by connections when invalidated.
+     *
+     * @return True if the connection was collected (or already was); false
+     *         if revalidation isn't suspended, and the connection should
+     *         validate on its own.
+     */
+    bool Collect( gxLineConnection* aConnection );
+
+    /**
+     * @brief Forgets a connection (called by connections being deleted).
+     */
+    void Remove( gxLineConnection* aConnection );
+
+    /**
+     * @brief Returns the bounds of a figure in absolute coordinates.
+     *
+     * While revalidating, bounds are cached, so each figure is only
+     * transformed once.
+     */
+    gxRect GetAbsoluteBounds( gxViewElement* aFigure );
+
+private:
+    typedef std::unordered_set< gxLineConnection* >        Connections;
+    typedef std::unordered_map< gxViewElement*, gxRect >  BoundsCache;
+
+    // The nesting level of SuspendRevalidation() calls
+    int mSuspended;
+
+    // Whether or not revalidation is taking place (so bounds are cached)
+    bool mRevalidating;
+
+    Connections mCollected;
+    BoundsCache mBounds;
+
+    /**
+     * @brief Revalidates all collected connections.
+     */
+    void Revalidate();
+};
+
+#endif //gxConnectionManager_h
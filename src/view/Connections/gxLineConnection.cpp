@@ -2,10 +2,91 @@
 #include "core/gxLog.h"
 
 gxLineConnection::gxLineConnection()
+  : mRouter ( NULL ),
+    mManager( NULL )
 { }
 
+gxLineConnection::~gxLineConnection()
+{
+    if ( mRouter )
+        mRouter->Remove( this );
+    
+    if ( mManager )
+        mManager->Remove( this );
+}
+
+void gxLineConnection::SetRouter( gxOrthogonalRouter* aRouter )
+{
+    if ( mRouter )
+        mRouter->Remove( this );
+    
+    mRouter = aRouter;
+    
+    if ( mRouter )
+        mRouter->Add( this );
+    
+    InvalidateConnection();
+}
+
+void gxLineConnection::SetManager( gxConnectionManager* aManager )
+{
+    if ( mManager )
+        mManager->Remove( this );
+    
+    mManager = aManager;
+}
+
+bool gxLineConnection::Revalidate( gxRect& aDamage )
+{
+    if ( !mSource || !mDestination || Parentless() )
+        return false;
+    
+    if ( mRouter )
+    {
+        Erase();
+        gxLine::Invalidate();
+        return false;
+    }
+    
+    bool iVisible = IsVisible();
+    
+    if ( iVisible )
+        aDamage.Union( GetOuterBounds() );
+    
+    // The figures bounds are shared with the other connections revalidated
+    gxRect iSource      = mManager->GetAbsoluteBounds( mSource->GetParent() );
+    gxRect iDestination = mManager->GetAbsoluteBounds( mDestination->GetParent() );
+    
+    mFrom = mSource->GetPosition( mDestination->GetReference( iDestination ), iSource );
+    mTo =   mDestination->GetPosition( mSource->GetReference( iSource ), iDestination );
+    
+    if ( iVisible )
+        aDamage.Union( GetOuterBounds() );
+    
+    return iVisible;
+}
+
+gxRect gxLineConnection::GetBounds() const
+{
+    if ( mRoute.empty() )
+        return gxLine::GetBounds();
+    
+    gxRect iBounds;
+    
+    for ( size_t i = 1; i < mRoute.size(); ++i )
+    {
+        iBounds.Union( gxRect( mRoute[ i - 1 ], mRoute[ i ] ) );
+    }
+    
+    return iBounds;
+}
+
 void gxLineConnection::InvalidateConnection()
 {
+    // Erased and repainted by the manager along with the other connections
+    if ( mManager && mManager->Collect( this ) )
+        return;
+    
     Erase();
     gxLine::Invalidate();
 }
@@ -15,8 +96,28 @@ void gxLineConnection::DoValidate()
     if ( !mSource || !mDestination )
         return;
     
-    mFrom = mSource->GetPosition( mDestination->GetReference() );
-    mTo =   mDestination->GetPosition( mSource->GetReference() );
+    // Fall back to a straight line if there's no route
+    if ( mRouter && mRouter->Route( this, mRoute ) )
+    {
+        mFrom = mRoute.front();
+        mTo   = mRoute.back();
+    } else {
+        mRoute.clear();
+        
+        mFrom = mSource->GetPosition( mDestination->GetReference() );
+        mTo =   mDestination->GetPosition( mSource->GetReference() );
+    }
     
     Repaint();
 }
+
+void gxLineConnection::PaintShape( gxPainter &aPainter )
+{
+    if ( mRoute.empty() )
+    {
+        gxLine::PaintShape( aPainter );
+        return;
+    }
+    
+    aPainter.DrawLines( &mRoute[0], mRoute.size() );
+}
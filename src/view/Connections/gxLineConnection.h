@@ -3,19 +3,63 @@
 
 #include "View/Elements/Visual/shapes/gxLine.h"
 #include "View/Connections/gxConnection.h"
+#include "View/Connections/gxOrthogonalRouter.h"
+#include "View/Connections/gxConnectionManager.h"
+
+#include <vector>
 
 class gxLineConnection: public gxLine,
                         public gxConnection
 {
 public:
     gxLineConnection();
+    ~gxLineConnection();
+    
+    /**
+     * @brief Sets the router this connection is routed by.
+     *
+     * @param aRouter The router, or NULL for a straight line.
+     */
+    void SetRouter( gxOrthogonalRouter* aRouter );
+    
+    /**
+     * @brief Sets the manager revalidating this connection in batches.
+     *
+     * @param aManager The manager, or NULL for the connection to validate on
+     *        its own.
+     */
+    void SetManager( gxConnectionManager* aManager );
+    
+    /**
+     * @brief Recomputes the end points of this connection, without going
+     * through validation. Called by the connection manager.
+     *
+     * Routed connections are invalidated instead, as routes depend on other
+     * figures too.
+     *
+     * @param aDamage Unioned with the bounds of this connection, before and
+     *        after the change.
+     * @return True if aDamage was extended.
+     */
+    bool Revalidate( gxRect& aDamage );
+    
+    virtual gxRect GetBounds() const;
     
     virtual void InvalidateConnection();
 protected:
     virtual void DoValidate();
     
+    virtual void PaintShape( gxPainter &aPainter );
+    
     // Connections use absolute positioning
     virtual bool IsRelative() { return false; }
+    
+    gxOrthogonalRouter*  mRouter;
+    gxConnectionManager* mManager;
+    
+    // The route points (absolute), from source to destination; empty if the
+    // connection is a straight line.
+    std::vector< gxPoint > mRoute;
 };
 
 #endif // gxLineConnection_h
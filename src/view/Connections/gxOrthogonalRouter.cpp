@@ -0,0 +1,735 @@
+#include "View/Connections/gxOrthogonalRouter.h"
+#include "View/Connections/gxConnection.h"
+#include "View/Elements/gxViewElement.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <queue>
+
+// Beyond this number of visibility graph nodes a search takes too much memory
+// and time, and the connection is drawn straight instead.
+static const size_t MaxSearchNodes = 1 << 20;
+
+// Directions of route segments; opposite directions differ by the last bit.
+enum
+{
+    Right,
+    Left,
+    Down,
+    Up
+};
+
+/**
+ * @brief Returns a lower bound of the cost of a route between two points: the
+ * Manhattan distance, plus a bend if the points aren't aligned.
+ */
+static long EstimateCost( gxPix          aX,
+                          gxPix          aY,
+                          const gxPoint& aTo,
+                          gxPix          aBendPenalty )
+{
+    long iCost = std::labs( long( aTo.X ) - aX ) + std::labs( long( aTo.Y ) - aY );
+
+    if ( aX != aTo.X && aY != aTo.Y )
+        iCost += aBendPenalty;
+
+    return iCost;
+}
+
+gxOrthogonalRouter::gxOrthogonalRouter( gxViewElement* aContainer ) :
+    mContainer  ( aContainer ),
+    mSpacing    ( 10         ),
+    mBendPenalty( 40         ),
+    mStamp      ( 0          ),
+    mRescan     ( true       ),
+    mCorridorGrid( 256       ),
+    mRouting    ( NULL       )
+{
+    mContainer->SetChildWatcher( this );
+}
+
+gxOrthogonalRouter::~gxOrthogonalRouter()
+{
+    if ( mContainer->GetChildWatcher() == this )
+        mContainer->SetChildWatcher( NULL );
+}
+
+void gxOrthogonalRouter::SetSpacing( gxPix aSpacing )
+{
+    mSpacing = aSpacing;
+}
+
+void gxOrthogonalRouter::SetBendPenalty( gxPix aBendPenalty )
+{
+    mBendPenalty = aBendPenalty;
+}
+
+void gxOrthogonalRouter::Add( gxConnection* aConnection )
+{
+    if ( mCorridorIds.count( aConnection ) )
+        return;
+
+    int iId;
+
+    if ( mFreeCorridors.empty() )
+    {
+        iId = int( mCorridors.size() );
+        mCorridors.push_back( Corridor() );
+    } else {
+        iId = mFreeCorridors.back();
+        mFreeCorridors.pop_back();
+    }
+
+    mCorridors[ iId ].mConnection = aConnection;
+    mCorridors[ iId ].mBounds     = gxRect();
+    mCorridors[ iId ].mRoute.clear();
+
+    mCorridorIds[ aConnection ] = iId;
+}
+
+void gxOrthogonalRouter::Remove( gxConnection* aConnection )
+{
+    std::unordered_map< gxConnection*, int >::iterator iId = mCorridorIds.find( aConnection );
+
+    if ( iId == mCorridorIds.end() )
+        return;
+
+    SetCorridor( iId->second, gxRect() );
+
+    mCorridors[ iId->second ].mConnection = NULL;
+    mFreeCorridors.push_back( iId->second );
+    mCorridorIds.erase( iId );
+}
+
+void gxOrthogonalRouter::SetCorridor( int           aId,
+                                      const gxRect& aBounds )
+{
+    Corridor& iCorridor = mCorridors[ aId ];
+
+    if ( !iCorridor.mBounds.IsEmpty() )
+        mCorridorGrid.Remove( aId, iCorridor.mBounds );
+
+    iCorridor.mBounds = aBounds;
+
+    if ( !iCorridor.mBounds.IsEmpty() )
+        mCorridorGrid.Insert( aId, iCorridor.mBounds );
+}
+
+void gxOrthogonalRouter::OnChildChanged( gxViewElement* aChild )
+{
+    mChanged.insert( aChild );
+}
+
+void gxOrthogonalRouter::OnChildRemoved( gxViewElement* aChild )
+{
+    // The child may be deleted next, so it's dropped right away.
+    mChanged.erase( aChild );
+
+    std::map< gxViewElement*, int >::iterator iId = mIds.find( aChild );
+
+    if ( iId != mIds.end() )
+        RemoveObstacle( iId->second );
+}
+
+void gxOrthogonalRouter::OnValidate()
+{
+    Update();
+}
+
+bool gxOrthogonalRouter::GetLocalBounds( gxViewElement* aElement,
+                                         gxRect&        aBounds )
+{
+    gxFixedRect iBounds = gxToFixed( aElement->GetBounds() );
+
+    for ( gxViewElement* iElement = aElement; iElement; iElement = iElement->GetParent() )
+    {
+        if ( iElement->GetParent() == mContainer )
+        {
+            aBounds = gxToPix( iBounds );
+            return true;
+        }
+
+        if ( iElement->GetParent() )
+            iElement->GetParent()->Transform( iBounds );
+    }
+
+    return false;
+}
+
+void gxOrthogonalRouter::TransformToAbsolute( std::vector< gxPoint >& aPoints )
+{
+    for ( size_t i = 0; i < aPoints.size(); ++i )
+    {
+        gxFixedRect iPoint( aPoints[ i ].X, aPoints[ i ].Y, 0, 0 );
+
+        mContainer->Transform( iPoint );
+        mContainer->TransformToAbsolute( iPoint );
+
+        aPoints[ i ] = gxToPix( iPoint.GetPosition() );
+    }
+}
+
+int gxOrthogonalRouter::GetObstacle( gxViewElement* aElement )
+{
+    for ( gxViewElement* iElement = aElement; iElement; iElement = iElement->GetParent() )
+    {
+        if ( iElement->GetParent() == mContainer )
+        {
+            std::map< gxViewElement*, int >::iterator iId = mIds.find( iElement );
+
+            return iId != mIds.end() ? iId->second : -1;
+        }
+    }
+
+    return -1;
+}
+
+void gxOrthogonalRouter::UpdateObstacle( gxViewElement* aChild )
+{
+    std::map< gxViewElement*, int >::iterator iId = mIds.find( aChild );
+
+    // Connections in the container aren't obstacles, and hidden children
+    // are gone as far as routes are concerned.
+    if ( aChild->GetParent() != mContainer ||
+         !aChild->IsVisible() ||
+         dynamic_cast< gxConnection* >( aChild ) )
+    {
+        if ( iId != mIds.end() )
+            RemoveObstacle( iId->second );
+
+        return;
+    }
+
+    gxRect iBounds = aChild->GetBounds();
+
+    if ( iId == mIds.end() )
+    {
+        int iNewId;
+
+        if ( mFreeIds.empty() )
+        {
+            iNewId = int( mObstacles.size() );
+            mObstacles.push_back( Obstacle() );
+        } else {
+            iNewId = mFreeIds.back();
+            mFreeIds.pop_back();
+        }
+
+        Obstacle& iObstacle = mObstacles[ iNewId ];
+        iObstacle.mElement = aChild;
+        iObstacle.mBounds  = iBounds;
+        iObstacle.mStamp   = mStamp;
+
+        mIds[ aChild ] = iNewId;
+        mGrid.Insert( iNewId, iBounds );
+        mDamage.push_back( iBounds );
+        return;
+    }
+
+    Obstacle& iObstacle = mObstacles[ iId->second ];
+    iObstacle.mStamp = mStamp;
+
+    if ( iObstacle.mBounds != iBounds )
+    {
+        mGrid.Remove( iId->second, iObstacle.mBounds );
+        mGrid.Insert( iId->second, iBounds );
+
+        mDamage.push_back( iObstacle.mBounds );
+        mDamage.push_back( iBounds );
+
+        iObstacle.mBounds = iBounds;
+    }
+}
+
+void gxOrthogonalRouter::RemoveObstacle( int aId )
+{
+    Obstacle& iObstacle = mObstacles[ aId ];
+
+    mGrid.Remove( aId, iObstacle.mBounds );
+    mDamage.push_back( iObstacle.mBounds );
+
+    mIds.erase( iObstacle.mElement );
+    iObstacle.mElement = NULL;
+    mFreeIds.push_back( aId );
+}
+
+void gxOrthogonalRouter::Update()
+{
+    if ( mRescan )
+    {
+        mRescan = false;
+        mChanged.clear();
+        mStamp++;
+
+        gxViewElement::Iterator iChildren( mContainer->GetChildren() );
+
+        for ( iChildren.First(); iChildren.Current(); iChildren.Next() )
+        {
+            UpdateObstacle( iChildren.Current() );
+        }
+
+        // Obstacles not seen are gone
+        for ( size_t i = 0; i < mObstacles.size(); ++i )
+        {
+            if ( mObstacles[ i ].mElement && mObstacles[ i ].mStamp != mStamp )
+                RemoveObstacle( int( i ) );
+        }
+    } else {
+        for ( std::unordered_set< gxViewElement* >::iterator iChild = mChanged.begin();
+              iChild != mChanged.end();
+              ++iChild )
+        {
+            UpdateObstacle( *iChild );
+        }
+
+        mChanged.clear();
+    }
+
+    if ( mDamage.empty() )
+        return;
+
+    // The extent only changes if old or new bounds reach its edges.
+    bool iOnEdge = false;
+
+    for ( size_t i = 0; i < mDamage.size() && !iOnEdge; ++i )
+    {
+        const gxRect& iDamage = mDamage[ i ];
+
+        iOnEdge = iDamage.GetLeft()   <= mExtent.GetLeft()  ||
+                  iDamage.GetTop()    <= mExtent.GetTop()   ||
+                  iDamage.GetRight()  >= mExtent.GetRight() ||
+                  iDamage.GetBottom() >= mExtent.GetBottom();
+    }
+
+    if ( iOnEdge )
+    {
+        mExtent = gxRect();
+
+        for ( size_t i = 0; i < mObstacles.size(); ++i )
+        {
+            if ( mObstacles[ i ].mElement )
+                mExtent.Union( mObstacles[ i ].mBounds );
+        }
+    }
+
+    // Invalidate the connections whose corridor is affected. The one being
+    // routed is up to date already.
+    std::vector< int > iIds;
+
+    for ( size_t i = 0; i < mDamage.size(); ++i )
+    {
+        gxRect iArea = mDamage[ i ];
+        iArea.Inflate( mSpacing );
+
+        mCorridorGrid.Query( iArea, iIds );
+
+        for ( size_t j = 0; j < iIds.size(); ++j )
+        {
+            Corridor& iCorridor = mCorridors[ iIds[ j ] ];
+
+            if ( iCorridor.mConnection == mRouting || !iCorridor.mBounds.Intersects( iArea ) )
+                continue;
+
+            gxConnection* iConnection = iCorridor.mConnection;
+
+            SetCorridor( iIds[ j ], gxRect() );
+            iConnection->InvalidateConnection();
+        }
+    }
+
+    mDamage.clear();
+}
+
+bool gxOrthogonalRouter::Route( gxConnection*           aConnection,
+                                std::vector< gxPoint >& aPoints )
+{
+    aPoints.clear();
+
+    mRouting = aConnection;
+    Update();
+    mRouting = NULL;
+
+    gxAnchor* iSourceAnchor      = aConnection->GetSourceAnchor();
+    gxAnchor* iDestinationAnchor = aConnection->GetDestinationAnchor();
+
+    if ( !iSourceAnchor || !iDestinationAnchor ||
+         !iSourceAnchor->GetParent() || !iDestinationAnchor->GetParent() )
+        return false;
+
+    // Routes go around the container children, so figures elsewhere aren't
+    // routed.
+    gxRect iSource;
+    gxRect iDestination;
+
+    if ( !GetLocalBounds( iSourceAnchor->GetParent(),      iSource ) ||
+         !GetLocalBounds( iDestinationAnchor->GetParent(), iDestination ) )
+        return false;
+
+    std::unordered_map< gxConnection*, int >::iterator iId = mCorridorIds.find( aConnection );
+
+    // Unless changes along the corridor emptied it, or the figures moved, the
+    // route found last time still holds.
+    if ( iId != mCorridorIds.end() )
+    {
+        const Corridor& iCorridor = mCorridors[ iId->second ];
+
+        if ( !iCorridor.mBounds.IsEmpty() &&
+             iCorridor.mSource      == iSource &&
+             iCorridor.mDestination == iDestination )
+        {
+            aPoints = iCorridor.mRoute;
+            TransformToAbsolute( aPoints );
+
+            return !aPoints.empty();
+        }
+    }
+
+    // The figures of the anchors are where the route starts and ends, so
+    // aren't obstacles.
+    int iIgnore1 = GetObstacle( iSourceAnchor );
+    int iIgnore2 = GetObstacle( iDestinationAnchor );
+
+    gxRect iArea = iSource;
+    iArea.Union( iDestination );
+    iArea.Inflate( 8 * mSpacing );
+
+    bool iFound = Search( iArea, iSource.GetCenter(), iDestination.GetCenter(), iIgnore1, iIgnore2, aPoints );
+
+    // Go around all obstacles if the corridor is blocked
+    if ( !iFound && !iArea.Contains( mExtent ) )
+    {
+        gxRect iExtent = mExtent;
+        iExtent.Inflate( 2 * mSpacing );
+
+        iArea.Union( iExtent );
+        iFound = Search( iArea, iSource.GetCenter(), iDestination.GetCenter(), iIgnore1, iIgnore2, aPoints );
+    }
+
+    if ( iFound )
+        iFound = Clip( aPoints, iSource, iDestination );
+
+    // Keep the corridor, so changes along it cause a reroute. Without a route
+    // the connection is straight, so it's the figures that matter.
+    gxRect iCorridor = iSource;
+    iCorridor.Union( iDestination );
+
+    if ( iFound )
+    {
+        iCorridor = gxRect();
+
+        for ( size_t i = 1; i < aPoints.size(); ++i )
+        {
+            iCorridor.Union( gxRect( aPoints[ i - 1 ], aPoints[ i ] ) );
+        }
+    } else {
+        aPoints.clear();
+    }
+
+    if ( iId != mCorridorIds.end() )
+    {
+        Corridor& iKept = mCorridors[ iId->second ];
+
+        iKept.mSource      = iSource;
+        iKept.mDestination = iDestination;
+        iKept.mRoute       = aPoints;
+
+        SetCorridor( iId->second, iCorridor );
+    }
+
+    TransformToAbsolute( aPoints );
+
+    return iFound;
+}
+
+bool gxOrthogonalRouter::Search( const gxRect&           aArea,
+                                 const gxPoint&          aFrom,
+                                 const gxPoint&          aTo,
+                                 int                     aIgnore1,
+                                 int                     aIgnore2,
+                                 std::vector< gxPoint >& aPoints )
+{
+    // The obstacles within the area, grown by the spacing
+    std::vector< int >    iIds;
+    std::vector< gxRect > iObstacles;
+
+    mGrid.Query( aArea, iIds );
+
+    for ( size_t i = 0; i < iIds.size(); ++i )
+    {
+        if ( iIds[ i ] == aIgnore1 || iIds[ i ] == aIgnore2 )
+            continue;
+
+        gxRect iBounds = mObstacles[ iIds[ i ] ].mBounds;
+        iBounds.Inflate( mSpacing );
+
+        if ( iBounds.Intersects( aArea ) )
+            iObstacles.push_back( iBounds );
+    }
+
+    // The lines a route may follow - through the end points, and along the
+    // sides of the obstacles and the area.
+    std::vector< gxPix > iXs;
+    std::vector< gxPix > iYs;
+
+    iXs.push_back( aFrom.X );
+    iXs.push_back( aTo.X );
+    iXs.push_back( aArea.GetLeft() );
+    iXs.push_back( aArea.GetRight() );
+
+    iYs.push_back( aFrom.Y );
+    iYs.push_back( aTo.Y );
+    iYs.push_back( aArea.GetTop() );
+    iYs.push_back( aArea.GetBottom() );
+
+    for ( size_t i = 0; i < iObstacles.size(); ++i )
+    {
+        const gxRect& iBounds = iObstacles[ i ];
+
+        if ( iBounds.GetLeft() > aArea.GetLeft() )
+            iXs.push_back( iBounds.GetLeft() );
+
+        if ( iBounds.GetRight() < aArea.GetRight() )
+            iXs.push_back( iBounds.GetRight() );
+
+        if ( iBounds.GetTop() > aArea.GetTop() )
+            iYs.push_back( iBounds.GetTop() );
+
+        if ( iBounds.GetBottom() < aArea.GetBottom() )
+            iYs.push_back( iBounds.GetBottom() );
+    }
+
+    std::sort( iXs.begin(), iXs.end() );
+    iXs.erase( std::unique( iXs.begin(), iXs.end() ), iXs.end() );
+
+    std::sort( iYs.begin(), iYs.end() );
+    iYs.erase( std::unique( iYs.begin(), iYs.end() ), iYs.end() );
+
+    int iWidth  = int( iXs.size() );
+    int iHeight = int( iYs.size() );
+
+    if ( size_t( iWidth ) * iHeight > MaxSearchNodes )
+        return false;
+
+    // Nodes (line crossings) strictly inside obstacles, and segments to the
+    // next node to the right or below crossing obstacles. Routes may go along
+    // obstacle sides.
+    std::vector< char > iBlocked     ( iWidth * iHeight, 0 );
+    std::vector< char > iRightBlocked( iWidth * iHeight, 0 );
+    std::vector< char > iDownBlocked ( iWidth * iHeight, 0 );
+
+    for ( size_t k = 0; k < iObstacles.size(); ++k )
+    {
+        const gxRect& iBounds = iObstacles[ k ];
+
+        // The lines from the obstacle sides, and those strictly within
+        int iLeft     = int( std::lower_bound( iXs.begin(), iXs.end(), iBounds.GetLeft()   ) - iXs.begin() );
+        int iRight    = int( std::upper_bound( iXs.begin(), iXs.end(), iBounds.GetRight()  ) - iXs.begin() );
+        int iTop      = int( std::lower_bound( iYs.begin(), iYs.end(), iBounds.GetTop()    ) - iYs.begin() );
+        int iBottom   = int( std::upper_bound( iYs.begin(), iYs.end(), iBounds.GetBottom() ) - iYs.begin() );
+        int iInLeft   = int( std::upper_bound( iXs.begin(), iXs.end(), iBounds.GetLeft()   ) - iXs.begin() );
+        int iInRight  = int( std::lower_bound( iXs.begin(), iXs.end(), iBounds.GetRight()  ) - iXs.begin() );
+        int iInTop    = int( std::upper_bound( iYs.begin(), iYs.end(), iBounds.GetTop()    ) - iYs.begin() );
+        int iInBottom = int( std::lower_bound( iYs.begin(), iYs.end(), iBounds.GetBottom() ) - iYs.begin() );
+
+        for ( int j = iInTop; j < iInBottom; ++j )
+        {
+            for ( int i = iLeft; i + 1 < iRight; ++i )
+            {
+                iRightBlocked[ j * iWidth + i ] = 1;
+            }
+
+            for ( int i = iInLeft; i < iInRight; ++i )
+            {
+                iBlocked[ j * iWidth + i ] = 1;
+            }
+        }
+
+        for ( int j = iTop; j + 1 < iBottom; ++j )
+        {
+            for ( int i = iInLeft; i < iInRight; ++i )
+            {
+                iDownBlocked[ j * iWidth + i ] = 1;
+            }
+        }
+    }
+
+    int iStart = int( std::lower_bound( iYs.begin(), iYs.end(), aFrom.Y ) - iYs.begin() ) * iWidth +
+                 int( std::lower_bound( iXs.begin(), iXs.end(), aFrom.X ) - iXs.begin() );
+    int iGoal  = int( std::lower_bound( iYs.begin(), iYs.end(), aTo.Y   ) - iYs.begin() ) * iWidth +
+                 int( std::lower_bound( iXs.begin(), iXs.end(), aTo.X   ) - iXs.begin() );
+
+    // The end points may be covered by obstacles overlapping the figures
+    iBlocked[ iStart ] = 0;
+    iBlocked[ iGoal  ] = 0;
+
+    // A* over (node, direction of arrival) states, so bends can be costed
+    typedef std::pair< long, int > Entry;
+
+    std::vector< long > iCosts  ( iWidth * iHeight * 4, LONG_MAX );
+    std::vector< int >  iParents( iWidth * iHeight * 4, -1 );
+
+    std::priority_queue< Entry, std::vector< Entry >, std::greater< Entry > > iOpen;
+
+    long iEstimate = EstimateCost( aFrom.X, aFrom.Y, aTo, mBendPenalty );
+
+    for ( int d = Right; d <= Up; ++d )
+    {
+        iCosts[ iStart * 4 + d ] = 0;
+        iOpen.push( Entry( iEstimate, iStart * 4 + d ) );
+    }
+
+    int iFound = -1;
+
+    while ( !iOpen.empty() )
+    {
+        Entry iEntry = iOpen.top();
+        iOpen.pop();
+
+        int  iState     = iEntry.second;
+        int  iNode      = iState / 4;
+        int  iDirection = iState % 4;
+        int  i          = iNode % iWidth;
+        int  j          = iNode / iWidth;
+        long iCost      = iCosts[ iState ];
+
+        // Skip states reached at a lower cost since queued
+        if ( iEntry.first > iCost + EstimateCost( iXs[ i ], iYs[ j ], aTo, mBendPenalty ) )
+            continue;
+
+        if ( iNode == iGoal )
+        {
+            iFound = iState;
+            break;
+        }
+
+        for ( int d = Right; d <= Up; ++d )
+        {
+            // No going back
+            if ( d == ( iDirection ^ 1 ) )
+                continue;
+
+            int   iNext;
+            gxPix iLength;
+
+            if ( d == Right && i + 1 < iWidth && !iRightBlocked[ iNode ] )
+            {
+                iNext   = iNode + 1;
+                iLength = iXs[ i + 1 ] - iXs[ i ];
+            } else if ( d == Left && i > 0 && !iRightBlocked[ iNode - 1 ] ) {
+                iNext   = iNode - 1;
+                iLength = iXs[ i ] - iXs[ i - 1 ];
+            } else if ( d == Down && j + 1 < iHeight && !iDownBlocked[ iNode ] ) {
+                iNext   = iNode + iWidth;
+                iLength = iYs[ j + 1 ] - iYs[ j ];
+            } else if ( d == Up && j > 0 && !iDownBlocked[ iNode - iWidth ] ) {
+                iNext   = iNode - iWidth;
+                iLength = iYs[ j ] - iYs[ j - 1 ];
+            } else {
+                continue;
+            }
+
+            if ( iBlocked[ iNext ] )
+                continue;
+
+            long iNextCost  = iCost + iLength + ( d != iDirection ? mBendPenalty : 0 );
+            int  iNextState = iNext * 4 + d;
+
+            if ( iNextCost < iCosts[ iNextState ] )
+            {
+                iCosts  [ iNextState ] = iNextCost;
+                iParents[ iNextState ] = iState;
+
+                iOpen.push( Entry( iNextCost + EstimateCost( iXs[ iNext % iWidth ],
+                                                             iYs[ iNext / iWidth ],
+                                                             aTo,
+                                                             mBendPenalty ),
+                                   iNextState ) );
+            }
+        }
+    }
+
+    if ( iFound == -1 )
+        return false;
+
+    // Walk back from the goal, keeping only the bends
+    aPoints.clear();
+
+    for ( int iState = iFound; iState != -1; iState = iParents[ iState ] )
+    {
+        int     iNode  = iState / 4;
+        gxPoint iPoint( iXs[ iNode % iWidth ], iYs[ iNode / iWidth ] );
+
+        size_t iCount = aPoints.size();
+
+        if ( iCount >= 2 &&
+             ( ( aPoints[ iCount - 2 ].X == iPoint.X && aPoints[ iCount - 1 ].X == iPoint.X ) ||
+               ( aPoints[ iCount - 2 ].Y == iPoint.Y && aPoints[ iCount - 1 ].Y == iPoint.Y ) ) )
+            aPoints.back() = iPoint;
+        else
+            aPoints.push_back( iPoint );
+    }
+
+    std::reverse( aPoints.begin(), aPoints.end() );
+
+    // A route between coincident points
+    if ( aPoints.size() == 1 )
+        aPoints.push_back( aPoints.front() );
+
+    return true;
+}
+
+bool gxOrthogonalRouter::Clip( std::vector< gxPoint >& aPoints,
+                               const gxRect&           aSource,
+                               const gxRect&           aDestination )
+{
+    // Start where the route leaves the source
+    size_t iFirst = 0;
+
+    while ( iFirst < aPoints.size() && aSource.Contains( aPoints[ iFirst ] ) )
+    {
+        ++iFirst;
+    }
+
+    if ( iFirst == aPoints.size() )
+        return false;
+
+    if ( iFirst > 0 )
+    {
+        gxPoint& iInside  = aPoints[ iFirst - 1 ];
+        gxPoint& iOutside = aPoints[ iFirst ];
+
+        if ( iInside.Y == iOutside.Y )
+            iInside.X = iOutside.X > iInside.X ? aSource.GetRight() : aSource.GetLeft() - 1;
+        else
+            iInside.Y = iOutside.Y > iInside.Y ? aSource.GetBottom() : aSource.GetTop() - 1;
+
+        aPoints.erase( aPoints.begin(), aPoints.begin() + iFirst - 1 );
+    }
+
+    // End where the route enters the destination
+    size_t iLast = aPoints.size();
+
+    while ( iLast > 0 && aDestination.Contains( aPoints[ iLast - 1 ] ) )
+    {
+        --iLast;
+    }
+
+    if ( iLast == 0 )
+        return false;
+
+    if ( iLast < aPoints.size() )
+    {
+        gxPoint& iOutside = aPoints[ iLast - 1 ];
+        gxPoint& iInside  = aPoints[ iLast ];
+
+        if ( iInside.Y == iOutside.Y )
+            iInside.X = iOutside.X < iInside.X ? aDestination.GetLeft() - 1 : aDestination.GetRight();
+        else
+            iInside.Y = iOutside.Y < iInside.Y ? aDestination.GetTop() - 1 : aDestination.GetBottom();
+
+        aPoints.erase( aPoints.begin() + iLast + 1, aPoints.end() );
+    }
+
+    return aPoints.size() >= 2;
+}
@@ -0,0 +1,223 @@
+#ifndef gxOrthogonalRouter_h
+#define gxOrthogonalRouter_h
+
+#include "core/gxObject.h"
+#include "core/geometry/gxGeometry.h"
+#include "core/geometry/gxSpatialGrid.h"
+#include "View/Elements/gxChildWatcher.h"
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Forward declarations
+class gxViewElement;
+class gxConnection;
+
+/**
+ * @brief Routes connections as horizontal and vertical segments going around
+ * the children (obstacles) of a container.
+ *
+ * Obstacles are kept in a {@link gxSpatialGrid spatial grid}, in the
+ * coordinates of the container (as the bounds of its children are), so
+ * scrolling or zooming the container or its ancestors leaves them be. A route is searched for within a corridor around the source
+ * and destination figures: the obstacles within it, grown by the spacing,
+ * give the horizontal and vertical lines a route may follow (an orthogonal
+ * visibility graph), and A* finds the shortest route on these lines, each
+ * bend costing as much as the bend penalty in length. If there is no route
+ * within the corridor, the search is repeated around all obstacles.
+ *
+ * Routing is incremental. Each connection route is kept along with its
+ * corridor (the bounds of the route), in a spatial grid too; a connection
+ * routed again with its figures where they were (say, once zoomed) gets its
+ * route back, transformed to absolute coordinates, without searching. The router
+ * {@link gxChildWatcher watches} the container, collecting the obstacles
+ * added, moved, resized or removed; once the container validates (or a
+ * connection is routed), the changes are handled at once, and only the
+ * connections whose corridor intersects the old or new bounds of a changed
+ * obstacle are invalidated, and so routed again.
+ *
+ * The router must outlive the connections using it, and be deleted before
+ * its container.
+ */
+class gxOrthogonalRouter: public gxObject,
+                          public gxChildWatcher
+{
+public:
+    /**
+     * @param aContainer The view element whose children are the obstacles.
+     */
+    gxOrthogonalRouter( gxViewElement* aContainer );
+
+    ~gxOrthogonalRouter();
+
+    /**
+     * @brief Sets the distance routes keep from obstacles (10 by default).
+     */
+    void SetSpacing( gxPix aSpacing );
+
+    /**
+     * @brief Sets the cost of a bend, in pixels of route length (40 by
+     * default).
+     */
+    void SetBendPenalty( gxPix aBendPenalty );
+
+    /**
+     * @brief Registers a connection, so it is invalidated when obstacles
+     * change along its route.
+     */
+    void Add( gxConnection* aConnection );
+
+    /**
+     * @brief Unregisters a connection.
+     */
+    void Remove( gxConnection* aConnection );
+
+    /**
+     * @brief Routes a connection between the figures of its anchors.
+     *
+     * @param aConnection The connection.
+     * @param aPoints Receives the route points in absolute coordinates, from
+     *        the source figure bounds to the destination figure bounds.
+     * @return False if there is no route (aPoints is then left empty).
+     */
+    bool Route( gxConnection*           aConnection,
+                std::vector< gxPoint >& aPoints );
+
+    /**
+     * @brief Brings the obstacles in line with the container children,
+     * invalidating the connections whose route is affected by the changes.
+     *
+     * Only the children changed since the last update are looked at (all of
+     * them the first time).
+     */
+    void Update();
+
+    virtual void OnChildChanged( gxViewElement* aChild );
+    virtual void OnChildRemoved( gxViewElement* aChild );
+    virtual void OnValidate();
+
+private:
+    struct Obstacle
+    {
+        gxViewElement* mElement;
+        gxRect         mBounds;
+        unsigned       mStamp;
+    };
+
+    struct Corridor
+    {
+        gxConnection*          mConnection;
+        gxRect                 mBounds;
+
+        // The figures bounds the route was found for, and the route (empty
+        // if there is none)
+        gxRect                 mSource;
+        gxRect                 mDestination;
+        std::vector< gxPoint > mRoute;
+    };
+
+    gxViewElement* mContainer;
+
+    gxPix mSpacing;
+    gxPix mBendPenalty;
+
+    // The obstacles by id (removed ones have a NULL element) and the ids of
+    // their elements
+    std::vector< Obstacle >         mObstacles;
+    std::vector< int >              mFreeIds;
+    std::map< gxViewElement*, int > mIds;
+    gxSpatialGrid                   mGrid;
+
+    // The union of all obstacles bounds
+    gxRect mExtent;
+
+    // The stamp of the last full update, marking the obstacles still there
+    unsigned mStamp;
+
+    // The children changed since the last update, whether all need looking
+    // at, and the bounds of obstacles removed since
+    std::unordered_set< gxViewElement* > mChanged;
+    bool                                 mRescan;
+    std::vector< gxRect >                mDamage;
+
+    // The corridors of the registered connections by id (removed ones have
+    // a NULL connection, unrouted ones and those to route again empty bounds
+    // and aren't in the grid)
+    std::vector< Corridor >                   mCorridors;
+    std::vector< int >                        mFreeCorridors;
+    std::unordered_map< gxConnection*, int >  mCorridorIds;
+    gxSpatialGrid                             mCorridorGrid;
+
+    // The connection being routed
+    gxConnection* mRouting;
+
+    /**
+     * @brief Gets the bounds of a descendant of the container, in the
+     * coordinates of the container.
+     *
+     * @return False if the element isn't a descendant.
+     */
+    bool GetLocalBounds( gxViewElement* aElement,
+                         gxRect&        aBounds );
+
+    /**
+     * @brief Transforms points from the coordinates of the container to
+     * absolute ones.
+     */
+    void TransformToAbsolute( std::vector< gxPoint >& aPoints );
+
+    /**
+     * @brief Returns the id of the obstacle an element belongs to (-1 if
+     * none).
+     */
+    int GetObstacle( gxViewElement* aElement );
+
+    /**
+     * @brief Brings an obstacle in line with a child, adding or removing it
+     * as needed, and adds the bounds changed to the damage.
+     */
+    void UpdateObstacle( gxViewElement* aChild );
+
+    /**
+     * @brief Removes an obstacle, adding its bounds to the damage.
+     */
+    void RemoveObstacle( int aId );
+
+    /**
+     * @brief Sets the corridor of a connection, keeping the grid in line.
+     */
+    void SetCorridor( int           aId,
+                      const gxRect& aBounds );
+
+    /**
+     * @brief Searches for a route within an area.
+     *
+     * @param aArea The area.
+     * @param aFrom The route start.
+     * @param aTo The route end.
+     * @param aIgnore1 An obstacle to ignore (the source figure).
+     * @param aIgnore2 Another one (the destination figure).
+     * @param aPoints Receives the route bends, from start to end.
+     * @return False if there is no route.
+     */
+    bool Search( const gxRect&           aArea,
+                 const gxPoint&          aFrom,
+                 const gxPoint&          aTo,
+                 int                     aIgnore1,
+                 int                     aIgnore2,
+                 std::vector< gxPoint >& aPoints );
+
+    /**
+     * @brief Trims a route so it starts and ends on the bounds of the source
+     * and destination figures.
+     *
+     * @return False if nothing is left of the route.
+     */
+    bool Clip( std::vector< gxPoint >& aPoints,
+               const gxRect&           aSource,
+               const gxRect&           aDestination );
+};
+
+#endif //gxOrthogonalRouter_h
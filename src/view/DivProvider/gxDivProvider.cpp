@@ -2,19 +2,27 @@
 
 #include <math.h>
 
+// The number of divisions CalcDivs() converts at once, when all blocks are
+// alike.
+static const int DivBatchSize = 64;
+
 // -----------
 
 gxDivProvider::gxDivProvider( gxViewUnit *aViewUnit )
 : mMinBlockSize( 50 ),
     mScale( 1.0 ),
     mFixedBlockSize( true ),
-    mViewUnit ( aViewUnit )
+    mViewUnit ( aViewUnit ),
+    mNextDivsEntry( 0 )
 {
+    InvalidateDivs();
 }
 
 void gxDivProvider::SetMinBlockSize( gxPix aSize )
 { 
     mMinBlockSize = aSize;
+    InvalidateDivs();
+
     // If the block size fixed, this would be the right time to work out its
     // size, divisions, etc.
     if ( mFixedBlockSize )
@@ -58,13 +66,15 @@ void gxDivProvider::AdjustBlock( gxViewBlock &aBlock )
     CalcBlockSize( aBlock );
   
     int iExponent = 0;
+    int iFactor = 1;
 
     // Reduce the block size to 1 digit, but keep an exponent so we can go back
-    // to the same amount of digits later.
+    // to the same amount of digits later. (Rounding up, in integers.)
     while ( aBlock.Size > 10 )
     {
-        aBlock.Size = gxCeil( aBlock.Size / 10.0 );
+        aBlock.Size = ( aBlock.Size + 9 ) / 10;
         iExponent++;
+        iFactor *= 10;
     }
 
     // 3 or 4 become 5; 6, 7, 8, 9 become 10; 1, 2, 5, 10 stay.
@@ -97,7 +107,7 @@ void gxDivProvider::AdjustBlock( gxViewBlock &aBlock )
     }
 
     // Multiply the block size to the same amount of digits.
-    aBlock.Size = aBlock.Size * pow( 10, iExponent );
+    aBlock.Size = aBlock.Size * iFactor;
     // Calculate the amount of units per div
     aBlock.UnitsPerDiv = (int)( aBlock.Size / aBlock.DivCount );
 }
@@ -157,6 +167,106 @@ gxViewDiv* gxDivProvider::Next()
     return &mDiv;
 }
 
+void gxDivProvider::GetDivs( gxPix       aStart,
+                             gxPix       aEnd,
+                             gxViewDivs& aDivs )
+{
+    for ( int i = 0; i < DivsCacheSize; i++ )
+    {
+        const DivsEntry& iEntry = mDivsCache[i];
+
+        if ( iEntry.mValid &&
+             iEntry.mScale == mScale &&
+             iEntry.mStart == aStart &&
+             iEntry.mEnd   == aEnd )
+        {
+            aDivs = iEntry.mDivs;
+            return;
+        }
+    }
+
+    aDivs.clear();
+    CalcDivs( aStart, aEnd, aDivs );
+
+    DivsEntry& iEntry = mDivsCache[ mNextDivsEntry ];
+    iEntry.mValid = true;
+    iEntry.mScale = mScale;
+    iEntry.mStart = aStart;
+    iEntry.mEnd   = aEnd;
+    iEntry.mDivs  = aDivs;
+
+    mNextDivsEntry = ( mNextDivsEntry + 1 ) % DivsCacheSize;
+}
+
+void gxDivProvider::InvalidateDivs()
+{
+    for ( int i = 0; i < DivsCacheSize; i++ )
+        mDivsCache[i].mValid = false;
+}
+
+void gxDivProvider::CalcDivs( gxPix       aStart,
+                              gxPix       aEnd,
+                              gxViewDivs& aDivs )
+{
+    BlockAtPixel( aStart / mScale );
+
+    for ( ;; )
+    {
+        // All blocks are alike if the block size is fixed, so several of them
+        // can be converted at once. Otherwise, each block has its own size.
+        int iBlocks = mFixedBlockSize ?
+                      gxMax( 1, DivBatchSize / mBlock.DivCount ) :
+                      1;
+        size_t iCount = iBlocks * mBlock.DivCount;
+
+        if ( mUnits.size() < iCount )
+        {
+            mUnits.resize( iCount );
+            mPixels.resize( iCount );
+        }
+
+        size_t iUnit = 0;
+        for ( int b = 0; b < iBlocks; b++ )
+        {
+            int iBlockUnit = mBlock.Unit + b * mBlock.Size;
+
+            for ( int i = 0; i < mBlock.DivCount; i++ )
+                mUnits[ iUnit++ ] = iBlockUnit + i * mBlock.UnitsPerDiv;
+        }
+
+        mViewUnit->UnitsToPixels( &mUnits[0], &mPixels[0], iCount );
+
+        gxViewDiv iDiv;
+        for ( size_t i = 0; i < iCount; i++ )
+        {
+            // Stop at the first division (but the very first one) whose
+            // actual position, taking into account the scale, is past the end.
+            if ( !aDivs.empty() && gxFloor( mPixels[i] * mScale ) >= aEnd )
+                return;
+
+            iDiv.Index = (int)( i % mBlock.DivCount );
+            iDiv.Unit  = mUnits[i];
+            iDiv.Pixel = mPixels[i];
+
+            if ( iDiv.Index == 0 )
+                iDiv.Type = gxViewDiv::Block;
+            else if ( iDiv.Index % mBlock.KeyDivEvery == 0 )
+                iDiv.Type = gxViewDiv::Key;
+            else
+                iDiv.Type = gxViewDiv::Normal;
+
+            aDivs.push_back( iDiv );
+        }
+
+        mBlock.Unit += iBlocks * mBlock.Size;
+
+        // If the block size is not fixed, work it out based on the new block
+        // position
+        if ( !mFixedBlockSize )
+            AdjustBlock( mBlock );
+    }
+}
+
 gxString gxDivProvider::GetLabelOfPixel( const gxPix aPixel )
 {
     return mViewUnit->GetLabelOfPixel( aPixel );
@@ -167,3 +277,9 @@ gxString gxDivProvider::GetLabelOfUnit( const int aUnit )
     return mViewUnit->GetLabelOfUnit( aUnit );
 }
 
+void gxDivProvider::FormatLabelOfPixel( const gxPix aPixel,
+                                        gxString&   aLabel )
+{
+    mViewUnit->FormatLabelOfPixel( aPixel, aLabel );
+}
+
@@ -3,6 +3,8 @@
 
 #include "View/DivProvider/gxViewUnit.h"
 
+#include <vector>
+
 /**
  * @brief A structure that holds information regarding a view block used by
  * {@link gxDivProvider}.
@@ -41,6 +43,8 @@ struct gxViewDiv
     enum { Block, Key, Normal } Type;
 };
 
+typedef std::vector< gxViewDiv > gxViewDivs;
+
 /**
  * @brief A class that provides the divisions for rulers, grids, etc.
  * 
@@ -86,6 +90,33 @@ public:
     */
     virtual gxViewDiv* Next();
 
+    /**
+    * @brief Fills an array with all the divisions of a pixel interval.
+    *
+    * Divisions start from the block at the start of the interval, and stop
+    * before the first one at or past its end (the first one is always
+    * there). Both ends are in scaled pixels, i.e. as seen on screen.
+    * 
+    * The divisions are worked out a batch of blocks at a time, and kept for
+    * the last few intervals (and scales), so views sharing this div provider
+    * - say, a ruler and a grid - only work them out once. Like
+    * BlockAtPixel(), this moves the current block.
+    * @param aStart The first pixel of the interval.
+    * @param aEnd The pixel past the interval.
+    * @param aDivs Receives the divisions.
+    */
+    void GetDivs( gxPix       aStart,
+                  gxPix       aEnd,
+                  gxViewDivs& aDivs );
+
+    /**
+    * @brief Drops the divisions kept by GetDivs().
+    * 
+    * Needed if the view unit changes its mind about units (say, once the
+    * tempo of a bar:beat unit changes).
+    */
+    void InvalidateDivs();
+
     /**
     * @brief Returns the label of a given pixel.
     * @param aPixel The pixel value.
@@ -99,6 +130,15 @@ public:
     * @return The label for the given unit value.
     */
     gxString GetLabelOfUnit( const int aUnit );
+
+    /**
+    * @brief Formats the label of a given pixel into a string, reusing its
+    * storage.
+    * @param aPixel The pixel value.
+    * @param aLabel Receives the label.
+    */
+    void FormatLabelOfPixel( const gxPix aPixel,
+                             gxString&   aLabel );
 protected:
     /**
     * @brief Calculates the correct block size.
@@ -132,6 +172,19 @@ protected:
     */
     virtual gxViewDiv* BlockToDiv( gxViewBlock &aBlock );
 
+    /**
+    * @brief Works out the divisions of a pixel interval, for GetDivs().
+    * 
+    * Subclasses overriding how blocks and divisions are stepped through
+    * (BlockAtPixel(), NextBlock(), Next()) should override this too.
+    * @param aStart The first pixel of the interval (scaled).
+    * @param aEnd The pixel past the interval (scaled).
+    * @param aDivs Receives the divisions.
+    */
+    virtual void CalcDivs( gxPix       aStart,
+                           gxPix       aEnd,
+                           gxViewDivs& aDivs );
+
     /// The current block.
     gxViewBlock mBlock;
     /// The current div.
@@ -148,6 +201,28 @@ protected:
     /// when the scale or min block size changes. If the block size isn't fixed,
     /// the calculation happens per block.
     bool  mFixedBlockSize;
+
+private:
+    /// The divisions of an interval, as returned by GetDivs().
+    struct DivsEntry
+    {
+        bool       mValid;
+        float      mScale;
+        gxPix      mStart;
+        gxPix      mEnd;
+        gxViewDivs mDivs;
+    };
+
+    /// The number of intervals GetDivs() keeps.
+    static const int DivsCacheSize = 4;
+
+    DivsEntry   mDivsCache[ DivsCacheSize ];
+    /// The entry to be replaced next.
+    int         mNextDivsEntry;
+
+    /// Reused by CalcDivs(), to convert a batch of units at once.
+    std::vector< int >   mUnits;
+    std::vector< gxPix > mPixels;
 };
 
 #endif // gxDivProvider_h
\ No newline at end of file
@@ -1,16 +1,58 @@
 #include "View/DivProvider/gxViewUnit.h"
-#include <sstream>
 
 gxString gxViewUnit::GetLabelOfPixel( const gxPix aPixel )
 {
-    return GetLabelOfUnit( PixelToUnit( aPixel ) );
+    gxString iLabel;
+    FormatLabelOfPixel( aPixel, iLabel );
+    return iLabel;
 }
 
 gxString gxViewUnit::GetLabelOfUnit( const int aUnit )
 {
-    return gxString::Format( _T( "%i" ), aUnit );
+    gxString iLabel;
+    FormatLabelOfUnit( aUnit, iLabel );
+    return iLabel;
 }
 
+void gxViewUnit::FormatLabelOfPixel( const gxPix aPixel,
+                                     gxString&   aLabel )
+{
+    FormatLabelOfUnit( PixelToUnit( aPixel ), aLabel );
+}
+
+void gxViewUnit::FormatLabelOfUnit( const int aUnit,
+                                    gxString& aLabel )
+{
+    // The digits are written backwards, from the end of the buffer (which
+    // fits any int with its sign).
+    wchar_t iDigits[ 12 ];
+    wchar_t *iStart = iDigits + sizeof( iDigits ) / sizeof( iDigits[0] );
+    wchar_t *iEnd   = iStart;
+
+    // Negated as unsigned, so the smallest int doesn't overflow.
+    unsigned int iValue = aUnit < 0 ? 0u - (unsigned int)aUnit : (unsigned int)aUnit;
+
+    do
+    {
+        *--iStart = wchar_t( L'0' + iValue % 10 );
+        iValue /= 10;
+    } while ( iValue );
+
+    if ( aUnit < 0 )
+        *--iStart = L'-';
+
+    // Assigning keeps the label's storage, if large enough.
+    aLabel.assign( iStart, iEnd - iStart );
+}
+
+
+void gxViewUnit::UnitsToPixels( const int* aUnits,
+                                gxPix*     aPixels,
+                                size_t     aCount )
+{
+    for ( size_t i = 0; i < aCount; i++ )
+        aPixels[i] = UnitToPixel( aUnits[i] );
+}
 
 int gxPixelUnit::PixelToUnit( const gxPix aPixel )
 {
@@ -22,6 +64,14 @@ gxPix gxPixelUnit::UnitToPixel( const int aUnit )
     return aUnit;
 }
 
+void gxPixelUnit::UnitsToPixels( const int* aUnits,
+                                 gxPix*     aPixels,
+                                 size_t     aCount )
+{
+    for ( size_t i = 0; i < aCount; i++ )
+        aPixels[i] = aUnits[i];
+}
+
 int gxRationalViewUnit::PixelToUnit( const gxPix aPixel )
 {
     return gxFloor( aPixel * mPixelsPerUnit );
@@ -30,4 +80,15 @@ int gxRationalViewUnit::PixelToUnit( const gxPix aPixel )
 gxPix gxRationalViewUnit::UnitToPixel( const int aUnit )
 {
     return gxFloor( aUnit / mPixelsPerUnit );
-}
\ No newline at end of file
+}
+
+void gxRationalViewUnit::UnitsToPixels( const int* aUnits,
+                                        gxPix*     aPixels,
+                                        size_t     aCount )
+{
+    // The same as UnitToPixel(), without a call per unit.
+    const double iPixelsPerUnit = mPixelsPerUnit;
+
+    for ( size_t i = 0; i < aCount; i++ )
+        aPixels[i] = gxFloor( aUnits[i] / iPixelsPerUnit );
+}
@@ -4,6 +4,8 @@
 #include "core/gxString.h"
 #include "core/geometry/gxGeometry.h"
 
+#include <cstddef>
+
 /**
  * @brief A class to convert between pixels and the unit used in the view.
  * 
@@ -40,8 +42,26 @@ public:
     */
     virtual gxPix UnitToPixel( const int aUnit ) = 0;
 
+    /**
+    * @brief Converts an array of unit values to pixel values.
+    *
+    * Div providers convert the divisions of whole blocks at once. By default,
+    * each unit is converted by UnitToPixel(); units with a fixed ratio
+    * override this with a plain loop the compiler can vectorise.
+    * @param aUnits The unit values to convert.
+    * @param aPixels Receives the pixel values.
+    * @param aCount The number of values.
+    */
+    virtual void UnitsToPixels( const int* aUnits,
+                                gxPix*     aPixels,
+                                size_t     aCount );
+
     /**
     * @brief Returns the label of a given pixel.
+    *
+    * By default, the label formatted by FormatLabelOfPixel(). Subclasses
+    * overriding this should override FormatLabelOfPixel() as well, which
+    * rulers paint their labels with.
     * @param aPixel The pixel value.
     * @return The label for that pixel value.
     */
@@ -49,10 +69,35 @@ public:
 
     /**
     * @brief Returns the label of a given unit.
+    *
+    * By default, the label formatted by FormatLabelOfUnit(). Subclasses
+    * overriding this should override FormatLabelOfUnit() as well.
     * @param aUnit The unit value.
     * @return The label for the given unit value.
     */
     virtual gxString GetLabelOfUnit( const int aUnit );
+
+    /**
+    * @brief Formats the label of a given pixel into a string.
+    *
+    * Rulers format a label per block on every paint, so reuse the same
+    * string rather than allocating one per label.
+    * @param aPixel The pixel value.
+    * @param aLabel Receives the label.
+    */
+    virtual void FormatLabelOfPixel( const gxPix aPixel,
+                                     gxString&   aLabel );
+
+    /**
+    * @brief Formats the label of a given unit into a string.
+    *
+    * Subclasses override this to label units their own way (by default,
+    * units are labeled with their value).
+    * @param aUnit The unit value.
+    * @param aLabel Receives the label.
+    */
+    virtual void FormatLabelOfUnit( const int aUnit,
+                                    gxString& aLabel );
 };
 
 /**
@@ -62,6 +107,9 @@ class gxPixelUnit : public gxViewUnit
 {
     virtual int PixelToUnit( const gxPix aPixel );
     virtual gxPix UnitToPixel( const int aUnit );
+    virtual void UnitsToPixels( const int* aUnits,
+                                gxPix*     aPixels,
+                                size_t     aCount );
 };
 
 /**
@@ -79,6 +127,9 @@ public:
 
     virtual int PixelToUnit( const gxPix aPixel );
     virtual gxPix UnitToPixel( const int aUnit );
+    virtual void UnitsToPixels( const int* aUnits,
+                                gxPix*     aPixels,
+                                size_t     aCount );
 protected:
     double mPixelsPerUnit;
 };
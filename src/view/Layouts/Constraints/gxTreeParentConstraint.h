@@ -0,0 +1,23 @@
+#ifndef gxTreeParentConstraint_h
+#define gxTreeParentConstraint_h
+
+#include "View/Layouts/Constraints/gxPrimitiveConstraint.h"
+
+// Forward declaration
+class gxViewElement;
+
+/**
+ * @brief A constraint setting the parent node of a layoutee in a tree layout.
+ *
+ * The parent must be another layoutee of the same layouter. Layoutees without
+ * this constraint are the roots of the tree.
+ */
+class gxTreeParentConstraint : public gxPrimitiveConstraint< gxViewElement* >
+{
+public:
+    gxTreeParentConstraint( gxViewElement* aParent ) :
+        gxPrimitiveConstraint< gxViewElement* >( aParent )
+    {}
+};
+
+#endif //gxTreeParentConstraint_h
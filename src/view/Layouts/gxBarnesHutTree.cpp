@@ -0,0 +1,198 @@
+#include "View/Layouts/gxBarnesHutTree.h"
+
+gxBarnesHutTree::gxBarnesHutTree()
+{
+}
+
+void gxBarnesHutTree::Build( const Bodies& aBodies )
+{
+    mCells.clear();
+
+    if ( aBodies.empty() )
+        return;
+
+    // The root cell is the bounding square of all bodies
+    float iMinX = aBodies[ 0 ].X, iMaxX = iMinX;
+    float iMinY = aBodies[ 0 ].Y, iMaxY = iMinY;
+
+    for ( size_t i = 1; i < aBodies.size(); ++i )
+    {
+        iMinX = aBodies[ i ].X < iMinX ? aBodies[ i ].X : iMinX;
+        iMaxX = aBodies[ i ].X > iMaxX ? aBodies[ i ].X : iMaxX;
+        iMinY = aBodies[ i ].Y < iMinY ? aBodies[ i ].Y : iMinY;
+        iMaxY = aBodies[ i ].Y > iMaxY ? aBodies[ i ].Y : iMaxY;
+    }
+
+    float iHalf = ( iMaxX - iMinX > iMaxY - iMinY ? iMaxX - iMinX : iMaxY - iMinY ) / 2 + 1;
+
+    NewCell( ( iMinX + iMaxX ) / 2, ( iMinY + iMaxY ) / 2, iHalf );
+
+    for ( size_t i = 0; i < aBodies.size(); ++i )
+    {
+        Insert( aBodies, int( i ) );
+    }
+}
+
+void gxBarnesHutTree::AddRepulsion( const Bodies& aBodies,
+                                    int           aBody,
+                                    float         aStrength,
+                                    float         aTheta,
+                                    Body&         aForce ) const
+{
+    if ( mCells.empty() )
+        return;
+
+    const Body& iBody   = aBodies[ aBody ];
+    float       iTheta2 = aTheta * aTheta;
+
+    // A depth-first traversal never holds more than 3 cells per level
+    int iStack[ 3 * ( MaxDepth + 2 ) ];
+    int iTop = 0;
+
+    iStack[ iTop++ ] = 0;
+
+    while ( iTop )
+    {
+        const Cell& iCell = mCells[ iStack[ --iTop ] ];
+
+        // The body doesn't repel itself
+        if ( iCell.mBody == aBody || iCell.mMass == 0 )
+            continue;
+
+        float iDX = iBody.X - iCell.mSumX / iCell.mMass;
+        float iDY = iBody.Y - iCell.mSumY / iCell.mMass;
+        float iD2 = iDX * iDX + iDY * iDY;
+
+        bool  iIsLeaf = iCell.mBody != Internal;
+        float iSize   = 2 * iCell.mHalf;
+
+        // Open cells that are too close for their size
+        if ( !iIsLeaf && iSize * iSize >= iTheta2 * iD2 )
+        {
+            for ( int q = 0; q < 4; ++q )
+            {
+                if ( iCell.mChildren[ q ] != Empty )
+                    iStack[ iTop++ ] = iCell.mChildren[ q ];
+            }
+            continue;
+        }
+
+        // Coincident bodies are pushed apart in a direction derived from the
+        // body index, so they won't move as one.
+        if ( iD2 < 0.01f )
+        {
+            iDX = ( aBody % 2 ? 0.1f : -0.1f );
+            iDY = ( aBody % 3 ? 0.1f : -0.1f );
+            iD2 = 0.02f;
+        }
+
+        // aStrength / d in the direction (dx, dy) / d
+        float iFactor = aStrength * iCell.mMass / iD2;
+
+        aForce.X += iDX * iFactor;
+        aForce.Y += iDY * iFactor;
+    }
+}
+
+int gxBarnesHutTree::NewCell( float aCenterX,
+                              float aCenterY,
+                              float aHalf )
+{
+    Cell iCell;
+
+    iCell.mSumX    = 0;
+    iCell.mSumY    = 0;
+    iCell.mMass    = 0;
+    iCell.mCenterX = aCenterX;
+    iCell.mCenterY = aCenterY;
+    iCell.mHalf    = aHalf;
+    iCell.mBody    = Empty;
+
+    for ( int q = 0; q < 4; ++q )
+    {
+        iCell.mChildren[ q ] = Empty;
+    }
+
+    mCells.push_back( iCell );
+
+    return int( mCells.size() - 1 );
+}
+
+int gxBarnesHutTree::NewChild( int aCell,
+                               int aQuadrant )
+{
+    float iQuarter = mCells[ aCell ].mHalf / 2;
+    float iX       = mCells[ aCell ].mCenterX + ( aQuadrant & 1 ? iQuarter : -iQuarter );
+    float iY       = mCells[ aCell ].mCenterY + ( aQuadrant & 2 ? iQuarter : -iQuarter );
+
+    // Note that NewCell() may reallocate the cells, so no references are held
+    int iChild = NewCell( iX, iY, iQuarter );
+    mCells[ aCell ].mChildren[ aQuadrant ] = iChild;
+
+    return iChild;
+}
+
+int gxBarnesHutTree::GetQuadrant( int   aCell,
+                                  float aX,
+                                  float aY ) const
+{
+    return ( aX >= mCells[ aCell ].mCenterX ? 1 : 0 ) |
+           ( aY >= mCells[ aCell ].mCenterY ? 2 : 0 );
+}
+
+void gxBarnesHutTree::Insert( const Bodies& aBodies,
+                              int           aBody )
+{
+    float iX     = aBodies[ aBody ].X;
+    float iY     = aBodies[ aBody ].Y;
+    int   iCell  = 0;
+    int   iDepth = 0;
+
+    while ( true )
+    {
+        // Every cell on the way down accounts for the body
+        mCells[ iCell ].mSumX += iX;
+        mCells[ iCell ].mSumY += iY;
+        mCells[ iCell ].mMass += 1;
+
+        int iContent = mCells[ iCell ].mBody;
+
+        if ( iContent == Empty )
+        {
+            mCells[ iCell ].mBody = aBody;
+            return;
+        }
+
+        if ( iContent == Shared )
+            return;
+
+        // A leaf with a single body is split, pushing its body one level down
+        if ( iContent >= 0 )
+        {
+            if ( iDepth >= MaxDepth )
+            {
+                mCells[ iCell ].mBody = Shared;
+                return;
+            }
+
+            const Body& iOther = aBodies[ iContent ];
+            int         iChild = NewChild( iCell, GetQuadrant( iCell, iOther.X, iOther.Y ) );
+
+            mCells[ iChild ].mSumX = iOther.X;
+            mCells[ iChild ].mSumY = iOther.Y;
+            mCells[ iChild ].mMass = 1;
+            mCells[ iChild ].mBody = iContent;
+            mCells[ iCell  ].mBody = Internal;
+        }
+
+        // Descend to the quadrant of the body, creating it if needed
+        int iQuadrant = GetQuadrant( iCell, iX, iY );
+        int iNext     = mCells[ iCell ].mChildren[ iQuadrant ];
+
+        if ( iNext == Empty )
+            iNext = NewChild( iCell, iQuadrant );
+
+        iCell = iNext;
+        iDepth++;
+    }
+}
@@ -0,0 +1,125 @@
+#ifndef gxBarnesHutTree_h
+#define gxBarnesHutTree_h
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief A quadtree approximating the n-body repulsion of a set of points
+ * (after Barnes and Hut).
+ *
+ * Each cell holds the total mass and center of mass of the bodies within it.
+ * When computing the force on a body, cells that are far enough (relative to
+ * their size) are treated as a single body, which brings the cost of computing
+ * the repulsion on all bodies down to O(n log n).
+ *
+ * Once built, the tree is only read, so the forces on different bodies can be
+ * computed concurrently.
+ */
+class gxBarnesHutTree
+{
+public:
+    /**
+     * @brief A body (point) in the tree.
+     */
+    struct Body
+    {
+        float X;
+        float Y;
+    };
+
+    typedef std::vector< Body > Bodies;
+
+    gxBarnesHutTree();
+
+    /**
+     * @brief (Re)builds the tree out of the given bodies.
+     *
+     * The cells storage is kept between builds.
+     *
+     * @param aBodies The bodies.
+     */
+    void Build( const Bodies& aBodies );
+
+    /**
+     * @brief Adds the repulsion all other bodies exert on a body.
+     *
+     * The repulsion of a body is aStrength / distance, in the direction away
+     * from it.
+     *
+     * @param aBodies The bodies the tree was built with.
+     * @param aBody The index of the body the force is computed for.
+     * @param aStrength The repulsion strength.
+     * @param aTheta The approximation threshold - a cell is treated as a single
+     *        body if its size divided by its distance is below it.
+     * @param aForce The force to add the repulsion to.
+     */
+    void AddRepulsion( const Bodies& aBodies,
+                       int           aBody,
+                       float         aStrength,
+                       float         aTheta,
+                       Body&         aForce ) const;
+
+private:
+    // Bodies closer than the smallest cell at this depth share a leaf.
+    enum { MaxDepth = 24 };
+
+    // Special values of Cell::mBody
+    enum
+    {
+        // An empty cell
+        Empty    = -1,
+        // A cell with children
+        Internal = -2,
+        // A leaf with more than one (practically coincident) bodies
+        Shared   = -3
+    };
+
+    struct Cell
+    {
+        // The sum of the bodies positions and their count (mass)
+        float mSumX;
+        float mSumY;
+        float mMass;
+
+        // The cell square
+        float mCenterX;
+        float mCenterY;
+        float mHalf;
+
+        int mChildren[ 4 ];
+
+        // The body of a single-body leaf, or one of the special values
+        int mBody;
+    };
+
+    std::vector< Cell > mCells;
+
+    /**
+     * @brief Creates a new, empty cell and returns its index.
+     */
+    int NewCell( float aCenterX,
+                 float aCenterY,
+                 float aHalf );
+
+    /**
+     * @brief Creates the child of a cell at the given quadrant.
+     */
+    int NewChild( int aCell,
+                  int aQuadrant );
+
+    /**
+     * @brief Returns the quadrant of a cell a point is in.
+     */
+    int GetQuadrant( int   aCell,
+                     float aX,
+                     float aY ) const;
+
+    /**
+     * @brief Inserts a body into the tree.
+     */
+    void Insert( const Bodies& aBodies,
+                 int           aBody );
+};
+
+#endif //gxBarnesHutTree_h
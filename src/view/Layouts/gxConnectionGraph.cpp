@@ -0,0 +1,70 @@
+#include "View/Layouts/gxConnectionGraph.h"
+#include "View/Elements/gxViewElement.h"
+#include "View/Elements/Structural/Anchors/gxAnchor.h"
+#include "View/Connections/gxConnection.h"
+
+void gxConnectionGraph::Read( gxViewElement* aParent )
+{
+    mNodes.clear();
+    mEdges.clear();
+    mIndices.clear();
+
+    gxViewElement::VisualIterator iChildren( aParent->GetChildren() );
+
+    for ( iChildren.First(); iChildren.Current(); iChildren.Next() )
+    {
+        mIndices[ iChildren.Current() ] = int( mNodes.size() );
+        mNodes.push_back( iChildren.Current() );
+    }
+
+    // Look for anchors in the nodes and their descendants. Each connection is
+    // taken from its source anchor only, so it is only added once.
+    std::vector< gxViewElement* > iStack;
+
+    for ( size_t i = 0; i < mNodes.size(); ++i )
+    {
+        iStack.assign( 1, mNodes[ i ] );
+
+        while ( !iStack.empty() )
+        {
+            gxViewElement* iElement = iStack.back();
+            iStack.pop_back();
+
+            iStack.insert( iStack.end(), iElement->GetChildren()->begin(), iElement->GetChildren()->end() );
+
+            gxAnchor* iAnchor = dynamic_cast< gxAnchor* >( iElement );
+
+            if ( !iAnchor || !iAnchor->GetConnection() )
+                continue;
+
+            gxConnection* iConnection = iAnchor->GetConnection();
+
+            if ( iConnection->GetSourceAnchor() != iAnchor || !iConnection->GetDestinationAnchor() )
+                continue;
+
+            int iDestination = GetIndex( GetNode( aParent, iConnection->GetDestinationAnchor() ) );
+
+            if ( iDestination != -1 && iDestination != int( i ) )
+                mEdges.push_back( Edge( int( i ), iDestination ) );
+        }
+    }
+}
+
+int gxConnectionGraph::GetIndex( gxViewElement* aNode ) const
+{
+    std::map< gxViewElement*, int >::const_iterator iFound = mIndices.find( aNode );
+
+    return iFound != mIndices.end() ? iFound->second : -1;
+}
+
+gxViewElement* gxConnectionGraph::GetNode( gxViewElement* aParent,
+                                           gxViewElement* aElement )
+{
+    for ( gxViewElement* iElement = aElement; iElement; iElement = iElement->GetParent() )
+    {
+        if ( iElement->GetParent() == aParent )
+            return iElement;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,64 @@
+#ifndef gxConnectionGraph_h
+#define gxConnectionGraph_h
+
+#include <map>
+#include <vector>
+
+// Forward declarations
+class gxViewElement;
+
+/**
+ * @brief The directed graph formed by the connections between the children of
+ * a view element, as used by graph layouts.
+ *
+ * The nodes are the visible children of the view element. A {@link
+ * gxConnection connection} whose source and destination {@link gxAnchor
+ * anchors} belong to two different nodes (the anchor itself or any of its
+ * ancestors is the node) is an edge from the source node to the destination
+ * node.
+ */
+class gxConnectionGraph
+{
+public:
+    typedef std::pair< int, int > Edge;
+    typedef std::vector< Edge >   Edges;
+    typedef std::vector< gxViewElement* > Nodes;
+
+    /**
+     * @brief Reads the graph of the given view element children.
+     *
+     * @param aParent The view element whose children are the nodes.
+     */
+    void Read( gxViewElement* aParent );
+
+    /**
+     * @brief Returns the nodes, in the order of the children.
+     */
+    const Nodes& GetNodes() const { return mNodes; }
+
+    /**
+     * @brief Returns the edges, as pairs of (source, destination) node
+     * indices.
+     */
+    const Edges& GetEdges() const { return mEdges; }
+
+    /**
+     * @brief Returns the index of a node, or -1 if it isn't one.
+     */
+    int GetIndex( gxViewElement* aNode ) const;
+
+private:
+    Nodes mNodes;
+    Edges mEdges;
+
+    std::map< gxViewElement*, int > mIndices;
+
+    /**
+     * @brief Returns the child of the parent an element belongs to (NULL if
+     * none).
+     */
+    gxViewElement* GetNode( gxViewElement* aParent,
+                            gxViewElement* aElement );
+};
+
+#endif //gxConnectionGraph_h
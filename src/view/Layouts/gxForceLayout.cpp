@@ -0,0 +1,276 @@
+#include "View/Layouts/gxForceLayout.h"
+#include "View/Elements/gxViewElement.h"
+#include "core/gxParallel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+
+// Below this number of layoutees per thread, threads cost more than they save.
+static const size_t MinLayouteesPerThread = 1024;
+
+gxForceLayout::gxForceLayout() :
+    mEdgeLength        ( 80    ),
+    mGravity           ( 0.05f ),
+    mTheta             ( 0.8f  ),
+    mInitialTemperature( 160   ),
+    mFinalTemperature  ( 0.5f  ),
+    mCooling           ( 0.97f ),
+    mMaxSteps          ( 500   ),
+    mTemperature       ( 0     ),
+    mSteps             ( 0     ),
+    mTimeSlice         ( 0     ),
+    mThreads           ( 0     ),
+    mSettled           ( true  ),
+    mGraphChanged      ( true  ),
+    mChildCount        ( 0     )
+{
+    mCenter.X = mCenter.Y = 0;
+}
+
+gxForceLayout::gxForceLayout( gxPix aEdgeLength ) :
+    mEdgeLength        ( aEdgeLength     ),
+    mGravity           ( 0.05f           ),
+    mTheta             ( 0.8f            ),
+    mInitialTemperature( 2 * aEdgeLength ),
+    mFinalTemperature  ( 0.5f            ),
+    mCooling           ( 0.97f           ),
+    mMaxSteps          ( 500             ),
+    mTemperature       ( 0               ),
+    mSteps             ( 0               ),
+    mTimeSlice         ( 0               ),
+    mThreads           ( 0               ),
+    mSettled           ( true            ),
+    mGraphChanged      ( true            ),
+    mChildCount        ( 0               )
+{
+    mCenter.X = mCenter.Y = 0;
+}
+
+gxForceLayout::~gxForceLayout()
+{
+}
+
+void gxForceLayout::SetTimeSlice( unsigned aTimeSlice )
+{
+    mTimeSlice = aTimeSlice;
+}
+
+void gxForceLayout::SetThreads( unsigned aThreads )
+{
+    mThreads = aThreads;
+}
+
+void gxForceLayout::Restart()
+{
+    mTemperature  = mInitialTemperature;
+    mSteps        = 0;
+    mSettled      = false;
+    mGraphChanged = true;
+}
+
+bool gxForceLayout::Step( gxViewElement* aLayouter )
+{
+    SyncGraph( aLayouter );
+
+    if ( !mSettled )
+        Simulate();
+
+    MoveLayoutees( aLayouter );
+
+    return mSettled;
+}
+
+bool gxForceLayout::Run( gxViewElement* aLayouter,
+                         unsigned       aBudget )
+{
+    typedef std::chrono::steady_clock Clock;
+
+    SyncGraph( aLayouter );
+
+    Clock::time_point iStart = Clock::now();
+
+    while ( !mSettled )
+    {
+        Simulate();
+
+        if ( aBudget &&
+             Clock::now() - iStart >= std::chrono::milliseconds( aBudget ) )
+            break;
+    }
+
+    MoveLayoutees( aLayouter );
+
+    return mSettled;
+}
+
+void gxForceLayout::Remove( gxViewElement* aLayoutee )
+{
+    // The layoutee is dropped when the graph is next read.
+    mGraphChanged = true;
+}
+
+void gxForceLayout::DoLayout( gxViewElement* aLayouter )
+{
+    // If the simulation has settled, something changed since - so run it
+    // again. If it is just layoutees that moved, a gentle reheat will do.
+    if ( mSettled )
+    {
+        mGraphChanged = true;
+
+        bool iLayouteesChanged = SyncGraph( aLayouter );
+
+        mTemperature = iLayouteesChanged ? mInitialTemperature : mInitialTemperature / 10;
+        mSteps       = 0;
+        mSettled     = mPositions.empty();
+    }
+
+    Run( aLayouter, mTimeSlice );
+}
+
+bool gxForceLayout::SyncGraph( gxViewElement* aLayouter )
+{
+    // Gravity pulls to the center of the layouter
+    gxSize iSize = aLayouter->GetInnerBounds().GetSize();
+
+    mCenter.X = iSize.X / 2.0f;
+    mCenter.Y = iSize.Y / 2.0f;
+
+    gxViewElement::List* iChildren = aLayouter->GetChildren();
+
+    if ( !mGraphChanged && iChildren->size() == mChildCount )
+        return false;
+
+    mGraphChanged = false;
+    mChildCount   = iChildren->size();
+
+    // Keep the positions of existing layoutees
+    std::map< gxViewElement*, Body > iPrevious;
+
+    for ( size_t i = 0; i < mGraph.GetNodes().size(); ++i )
+    {
+        iPrevious[ mGraph.GetNodes()[ i ] ] = mPositions[ i ];
+    }
+
+    size_t iPreviousCount = mGraph.GetNodes().size();
+    size_t iKept          = 0;
+
+    mGraph.Read( aLayouter );
+
+    const gxConnectionGraph::Nodes& iLayoutees = mGraph.GetNodes();
+
+    mPositions.resize( iLayoutees.size() );
+    mDisplacements.resize( iLayoutees.size() );
+
+    for ( size_t i = 0; i < iLayoutees.size(); ++i )
+    {
+        std::map< gxViewElement*, Body >::iterator iFound = iPrevious.find( iLayoutees[ i ] );
+
+        if ( iFound != iPrevious.end() )
+        {
+            mPositions[ i ] = iFound->second;
+            iKept++;
+        } else {
+            // New layoutees start where they are
+            gxPoint iCenter = iLayoutees[ i ]->GetBounds().GetCenter();
+            mPositions[ i ].X = iCenter.X;
+            mPositions[ i ].Y = iCenter.Y;
+        }
+    }
+
+    return iKept != iPreviousCount || iKept != iLayoutees.size();
+}
+
+void gxForceLayout::CalcRepulsion( size_t aFirst,
+                                   size_t aLast )
+{
+    float iStrength = float( mEdgeLength ) * mEdgeLength;
+
+    for ( size_t i = aFirst; i < aLast; ++i )
+    {
+        mTree.AddRepulsion( mPositions, int( i ), iStrength, mTheta, mDisplacements[ i ] );
+    }
+}
+
+void gxForceLayout::Simulate()
+{
+    size_t iCount = mPositions.size();
+
+    if ( iCount == 0 )
+    {
+        mSettled = true;
+        return;
+    }
+
+    for ( size_t i = 0; i < iCount; ++i )
+    {
+        mDisplacements[ i ].X = 0;
+        mDisplacements[ i ].Y = 0;
+    }
+
+    // Repulsion - the tree is only read from here on, so layoutees can be
+    // split between threads, each writing its own displacements.
+    mTree.Build( mPositions );
+
+    gxParallelFor( this, &gxForceLayout::CalcRepulsion, iCount, MinLayouteesPerThread, mThreads );
+
+    // Attraction along the edges (d^2 / k)
+    const gxConnectionGraph::Edges& iEdges = mGraph.GetEdges();
+
+    for ( size_t i = 0; i < iEdges.size(); ++i )
+    {
+        Body& iFrom = mPositions[ iEdges[ i ].first  ];
+        Body& iTo   = mPositions[ iEdges[ i ].second ];
+
+        float iDX     = iFrom.X - iTo.X;
+        float iDY     = iFrom.Y - iTo.Y;
+        float iFactor = std::sqrt( iDX * iDX + iDY * iDY ) / mEdgeLength;
+
+        mDisplacements[ iEdges[ i ].first  ].X -= iDX * iFactor;
+        mDisplacements[ iEdges[ i ].first  ].Y -= iDY * iFactor;
+        mDisplacements[ iEdges[ i ].second ].X += iDX * iFactor;
+        mDisplacements[ iEdges[ i ].second ].Y += iDY * iFactor;
+    }
+
+    // Gravity, then move each layoutee by no more than the temperature
+    for ( size_t i = 0; i < iCount; ++i )
+    {
+        Body& iPosition     = mPositions[ i ];
+        Body& iDisplacement = mDisplacements[ i ];
+
+        iDisplacement.X += ( mCenter.X - iPosition.X ) * mGravity;
+        iDisplacement.Y += ( mCenter.Y - iPosition.Y ) * mGravity;
+
+        float iLength = std::sqrt( iDisplacement.X * iDisplacement.X +
+                                   iDisplacement.Y * iDisplacement.Y );
+
+        if ( iLength > 0 )
+        {
+            float iScale = std::min( iLength, mTemperature ) / iLength;
+
+            iPosition.X += iDisplacement.X * iScale;
+            iPosition.Y += iDisplacement.Y * iScale;
+        }
+    }
+
+    mTemperature *= mCooling;
+    mSteps++;
+
+    mSettled = mTemperature < mFinalTemperature || mSteps >= mMaxSteps;
+}
+
+void gxForceLayout::MoveLayoutees( gxViewElement* aLayouter )
+{
+    const gxConnectionGraph::Nodes& iLayoutees = mGraph.GetNodes();
+
+    for ( size_t i = 0; i < iLayoutees.size(); ++i )
+    {
+        gxRect iBounds = iLayoutees[ i ]->GetBounds();
+
+        iBounds.SetPosition( gxPoint( gxPix( std::floor( mPositions[ i ].X - iBounds.width  / 2.0f + 0.5f ) ),
+                                      gxPix( std::floor( mPositions[ i ].Y - iBounds.height / 2.0f + 0.5f ) ) ) );
+
+        iLayoutees[ i ]->SetBounds( iBounds );
+    }
+}
@@ -0,0 +1,167 @@
+#ifndef gxForceLayout_h
+#define gxForceLayout_h
+
+#include "View/Layouts/gxLayout.h"
+#include "View/Layouts/gxBarnesHutTree.h"
+#include "View/Layouts/gxConnectionGraph.h"
+
+/**
+ * @brief A layout that places its layoutees using a force-directed simulation
+ * of the graph formed by their connections.
+ *
+ * The graph is the {@link gxConnectionGraph connection graph} of the
+ * layoutees, with edge directions ignored.
+ *
+ * Connected layoutees attract each other, all layoutees repel each other and a
+ * weak gravity pulls them toward the center of the layouter. Repulsion is
+ * approximated with a {@link gxBarnesHutTree Barnes-Hut tree}, and is computed
+ * over several threads for large graphs. Each step moves the layoutees by no
+ * more than the current temperature, which cools down until the simulation
+ * settles.
+ *
+ * By default, a layout runs the simulation until it settles. With a time slice
+ * set, each layout runs for the time slice only and the layout carries on in
+ * the following validations, so large graphs settle across frames without
+ * blocking the UI. Step() and Run() allow the simulation to be driven directly
+ * too (from a timer, for instance).
+ */
+class gxForceLayout : public gxLayout
+{
+public:
+    gxForceLayout();
+
+    /**
+     * @param aEdgeLength The ideal length of an edge.
+     */
+    gxForceLayout( gxPix aEdgeLength );
+
+    ~gxForceLayout();
+
+    /**
+     * @brief Sets the time, in milliseconds, each layout is allowed to run.
+     *
+     * @param aTimeSlice The time slice; 0 (the default) runs the simulation to
+     * the end on each layout.
+     */
+    void SetTimeSlice( unsigned aTimeSlice );
+
+    /**
+     * @brief Sets the number of threads used to compute repulsion.
+     *
+     * @param aThreads The number of threads; 0 (the default) uses the number
+     * of cores, 1 computes everything on the calling thread.
+     */
+    void SetThreads( unsigned aThreads );
+
+    /**
+     * @brief Reheats the simulation so it runs again from the current
+     * positions, picking up changes to the connections.
+     */
+    void Restart();
+
+    /**
+     * @brief Runs a single simulation step and moves the layoutees.
+     *
+     * @param aLayouter The view element whose children are being laid out.
+     * @return True if the simulation has settled.
+     */
+    bool Step( gxViewElement* aLayouter );
+
+    /**
+     * @brief Runs simulation steps until the simulation settles or the time
+     * budget is spent, then moves the layoutees.
+     *
+     * @param aLayouter The view element whose children are being laid out.
+     * @param aBudget The time budget in milliseconds (0 for no limit).
+     * @return True if the simulation has settled.
+     */
+    bool Run( gxViewElement* aLayouter,
+              unsigned       aBudget );
+
+    /**
+     * @brief Returns whether or not the simulation has settled.
+     */
+    bool IsSettled() const { return mSettled; }
+
+    virtual void Remove( gxViewElement* aLayoutee );
+
+protected:
+    // The ideal edge length
+    gxPix mEdgeLength;
+
+    // The gravity pulling layoutees to the center of the layouter
+    float mGravity;
+
+    // The Barnes-Hut approximation threshold
+    float mTheta;
+
+    // The temperature the simulation starts at, and the one it settles at
+    float mInitialTemperature;
+    float mFinalTemperature;
+
+    // The factor the temperature cools down by each step
+    float mCooling;
+
+    // The maximal number of steps of a single run of the simulation
+    unsigned mMaxSteps;
+
+    virtual void DoLayout( gxViewElement* aLayouter );
+
+    virtual bool IsComplete() { return mSettled; }
+
+private:
+    typedef gxBarnesHutTree::Body   Body;
+    typedef gxBarnesHutTree::Bodies Bodies;
+
+    // The layoutees graph, with the (center) positions and step displacements
+    // of the layoutees
+    gxConnectionGraph mGraph;
+    Bodies            mPositions;
+    Bodies            mDisplacements;
+
+    gxBarnesHutTree mTree;
+
+    // The point gravity pulls to
+    Body mCenter;
+
+    float    mTemperature;
+    unsigned mSteps;
+    unsigned mTimeSlice;
+    unsigned mThreads;
+
+    bool mSettled;
+
+    // Whether the graph needs to be read again
+    bool mGraphChanged;
+
+    // The number of layouter children when the graph was last read
+    size_t mChildCount;
+
+    /**
+     * @brief Makes sure the graph is in line with the layouter children and
+     * their connections, keeping the positions of existing layoutees.
+     *
+     * @return True if layoutees were added or removed.
+     */
+    bool SyncGraph( gxViewElement* aLayouter );
+
+    /**
+     * @brief Computes the repulsion on a range of layoutees.
+     *
+     * Called concurrently for different ranges.
+     */
+    void CalcRepulsion( size_t aFirst,
+                        size_t aLast );
+
+    /**
+     * @brief Performs a single simulation step.
+     */
+    void Simulate();
+
+    /**
+     * @brief Moves the layoutees to their simulated positions.
+     */
+    void MoveLayoutees( gxViewElement* aLayouter );
+};
+
+#endif //gxForceLayout_h
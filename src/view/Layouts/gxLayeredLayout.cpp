@@ -0,0 +1,634 @@
+#include "View/Layouts/gxLayeredLayout.h"
+#include "View/Elements/gxViewElement.h"
+#include "core/gxParallel.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Below these numbers per thread, threads cost more than they save.
+static const size_t MinNodesPerThread = 4096;
+static const size_t MinEdgesPerThread = 4096;
+
+/**
+ * @brief Builds the sparse adjacency of a graph.
+ *
+ * @param aCount The number of nodes.
+ * @param aEdges The edges.
+ * @param aDown Whether to list the destinations of each node edges (or their
+ *        sources).
+ * @param aOffsets Receives, for each node, the index of its first neighbour
+ *        (followed by the total count).
+ * @param aNeighbours Receives the neighbours.
+ * @param aEdgeIndices Receives the edge of each neighbour, if not NULL.
+ */
+static void BuildAdjacency( size_t                          aCount,
+                            const gxConnectionGraph::Edges& aEdges,
+                            bool                            aDown,
+                            std::vector< int >&             aOffsets,
+                            std::vector< int >&             aNeighbours,
+                            std::vector< int >*             aEdgeIndices = NULL )
+{
+    aOffsets.assign( aCount + 1, 0 );
+    aNeighbours.resize( aEdges.size() );
+
+    if ( aEdgeIndices )
+        aEdgeIndices->resize( aEdges.size() );
+
+    for ( size_t i = 0; i < aEdges.size(); ++i )
+    {
+        aOffsets[ ( aDown ? aEdges[ i ].first : aEdges[ i ].second ) + 1 ]++;
+    }
+
+    for ( size_t i = 0; i < aCount; ++i )
+    {
+        aOffsets[ i + 1 ] += aOffsets[ i ];
+    }
+
+    std::vector< int > iNext( aOffsets.begin(), aOffsets.end() - 1 );
+
+    for ( size_t i = 0; i < aEdges.size(); ++i )
+    {
+        int iFrom = aDown ? aEdges[ i ].first  : aEdges[ i ].second;
+        int iTo   = aDown ? aEdges[ i ].second : aEdges[ i ].first;
+
+        if ( aEdgeIndices )
+            ( *aEdgeIndices )[ iNext[ iFrom ] ] = int( i );
+
+        aNeighbours[ iNext[ iFrom ]++ ] = iTo;
+    }
+}
+
+gxLayeredLayout::gxLayeredLayout() :
+    mNodeGap         ( 20 ),
+    mLayerGap        ( 40 ),
+    mMaxSweeps       ( 24 ),
+    mCoordinateSweeps( 4  ),
+    mRealCount       ( 0  ),
+    mCrossingCount   ( 0  ),
+    mSweepLayer      ( 0  ),
+    mSweepDown       ( true ),
+    mThreads         ( 0  )
+{
+}
+
+gxLayeredLayout::gxLayeredLayout( bool aOnMajorAxis ) :
+    gxLayout         ( aOnMajorAxis ),
+    mNodeGap         ( 20 ),
+    mLayerGap        ( 40 ),
+    mMaxSweeps       ( 24 ),
+    mCoordinateSweeps( 4  ),
+    mRealCount       ( 0  ),
+    mCrossingCount   ( 0  ),
+    mSweepLayer      ( 0  ),
+    mSweepDown       ( true ),
+    mThreads         ( 0  )
+{
+}
+
+gxLayeredLayout::gxLayeredLayout( gxPix aNodeGap,
+                                  gxPix aLayerGap,
+                                  bool  aOnMajorAxis ) :
+    gxLayout         ( aOnMajorAxis ),
+    mNodeGap         ( aNodeGap  ),
+    mLayerGap        ( aLayerGap ),
+    mMaxSweeps       ( 24        ),
+    mCoordinateSweeps( 4         ),
+    mRealCount       ( 0         ),
+    mCrossingCount   ( 0         ),
+    mSweepLayer      ( 0         ),
+    mSweepDown       ( true      ),
+    mThreads         ( 0         )
+{
+}
+
+gxLayeredLayout::~gxLayeredLayout()
+{
+}
+
+void gxLayeredLayout::SetThreads( unsigned aThreads )
+{
+    mThreads = aThreads;
+}
+
+void gxLayeredLayout::DoLayout( gxViewElement* aLayouter )
+{
+    mGraph.Read( aLayouter );
+
+    mRealCount     = int( mGraph.GetNodes().size() );
+    mCrossingCount = 0;
+
+    if ( mRealCount == 0 )
+        return;
+
+    gxConnectionGraph::Edges iEdges = mGraph.GetEdges();
+
+    BreakCycles( iEdges );
+    AssignLayers( iEdges );
+    BuildLayers( iEdges );
+    OrderLayers();
+    AssignCoordinates();
+    MoveLayoutees();
+}
+
+void gxLayeredLayout::BreakCycles( gxConnectionGraph::Edges& aEdges )
+{
+    std::vector< int > iOffsets;
+    std::vector< int > iNeighbours;
+    std::vector< int > iEdgeIndices;
+
+    BuildAdjacency( mRealCount, aEdges, true, iOffsets, iNeighbours, &iEdgeIndices );
+
+    // Nodes are unvisited (0), on the search path (1) or done (2). An edge to
+    // a node on the search path closes a cycle.
+    std::vector< char > iState( mRealCount, 0 );
+
+    // The search path, as nodes and the next neighbour to visit
+    std::vector< std::pair< int, int > > iPath;
+
+    for ( int iRoot = 0; iRoot < mRealCount; ++iRoot )
+    {
+        if ( iState[ iRoot ] )
+            continue;
+
+        iState[ iRoot ] = 1;
+        iPath.push_back( std::make_pair( iRoot, iOffsets[ iRoot ] ) );
+
+        while ( !iPath.empty() )
+        {
+            int iNode = iPath.back().first;
+            int iNext = iPath.back().second;
+
+            if ( iNext == iOffsets[ iNode + 1 ] )
+            {
+                iState[ iNode ] = 2;
+                iPath.pop_back();
+                continue;
+            }
+
+            iPath.back().second++;
+
+            int iNeighbour = iNeighbours[ iNext ];
+
+            if ( iState[ iNeighbour ] == 1 )
+            {
+                gxConnectionGraph::Edge& iEdge = aEdges[ iEdgeIndices[ iNext ] ];
+                std::swap( iEdge.first, iEdge.second );
+            } else if ( iState[ iNeighbour ] == 0 ) {
+                iState[ iNeighbour ] = 1;
+                iPath.push_back( std::make_pair( iNeighbour, iOffsets[ iNeighbour ] ) );
+            }
+        }
+    }
+}
+
+void gxLayeredLayout::AssignLayers( const gxConnectionGraph::Edges& aEdges )
+{
+    std::vector< int > iOffsets;
+    std::vector< int > iNeighbours;
+
+    BuildAdjacency( mRealCount, aEdges, true, iOffsets, iNeighbours );
+
+    std::vector< int > iInDegrees( mRealCount, 0 );
+
+    for ( size_t i = 0; i < aEdges.size(); ++i )
+    {
+        iInDegrees[ aEdges[ i ].second ]++;
+    }
+
+    // Visit the nodes in topological order, each one placed below all of its
+    // predecessors.
+    std::vector< int > iQueue;
+    iQueue.reserve( mRealCount );
+
+    for ( int i = 0; i < mRealCount; ++i )
+    {
+        if ( iInDegrees[ i ] == 0 )
+            iQueue.push_back( i );
+    }
+
+    mLayer.assign( mRealCount, 0 );
+
+    for ( size_t iHead = 0; iHead < iQueue.size(); ++iHead )
+    {
+        int iNode = iQueue[ iHead ];
+
+        for ( int i = iOffsets[ iNode ]; i < iOffsets[ iNode + 1 ]; ++i )
+        {
+            int iNeighbour = iNeighbours[ i ];
+
+            mLayer[ iNeighbour ] = gxMax( mLayer[ iNeighbour ], mLayer[ iNode ] + 1 );
+
+            if ( --iInDegrees[ iNeighbour ] == 0 )
+                iQueue.push_back( iNeighbour );
+        }
+    }
+}
+
+void gxLayeredLayout::BuildLayers( const gxConnectionGraph::Edges& aEdges )
+{
+    // Split long edges with dummy nodes
+    gxConnectionGraph::Edges iEdges;
+    iEdges.reserve( aEdges.size() );
+
+    int iCount = mRealCount;
+
+    for ( size_t i = 0; i < aEdges.size(); ++i )
+    {
+        int iFrom = aEdges[ i ].first;
+
+        for ( int iLayer = mLayer[ iFrom ] + 1; iLayer < mLayer[ aEdges[ i ].second ]; ++iLayer )
+        {
+            mLayer.push_back( iLayer );
+            iEdges.push_back( gxConnectionGraph::Edge( iFrom, iCount ) );
+            iFrom = iCount++;
+        }
+
+        iEdges.push_back( gxConnectionGraph::Edge( iFrom, aEdges[ i ].second ) );
+    }
+
+    BuildAdjacency( iCount, iEdges, true,  mDownOffsets, mDownNeighbours );
+    BuildAdjacency( iCount, iEdges, false, mUpOffsets,   mUpNeighbours   );
+
+    // Layers initially hold their nodes in the layoutees order
+    int iLayerCount = *std::max_element( mLayer.begin(), mLayer.end() ) + 1;
+
+    mLayers.assign( iLayerCount, Layer() );
+    mOrder.resize( iCount );
+
+    for ( int i = 0; i < iCount; ++i )
+    {
+        mOrder[ i ] = int( mLayers[ mLayer[ i ] ].size() );
+        mLayers[ mLayer[ i ] ].push_back( i );
+    }
+
+    mBarycenters.resize( iCount );
+    mPositions.resize( iCount );
+    mSizes.assign( iCount, 0 );
+
+    for ( int i = 0; i < mRealCount; ++i )
+    {
+        mSizes[ i ] = float( mGraph.GetNodes()[ i ]->GetSize( mOnMajorAxis ) );
+    }
+}
+
+void gxLayeredLayout::OrderLayers()
+{
+    int iLayerCount = int( mLayers.size() );
+
+    mCrossingCount = CountCrossings();
+
+    std::vector< Layer > iBest = mLayers;
+
+    for ( unsigned iSweep = 0; iSweep < mMaxSweeps && mCrossingCount > 0; ++iSweep )
+    {
+        for ( int i = 1; i < iLayerCount; ++i )
+        {
+            SortLayer( i, true );
+        }
+
+        for ( int i = iLayerCount - 2; i >= 0; --i )
+        {
+            SortLayer( i, false );
+        }
+
+        // Stop as soon as the sweep brings no improvement
+        long iCrossings = CountCrossings();
+
+        if ( iCrossings >= mCrossingCount )
+            break;
+
+        mCrossingCount = iCrossings;
+        iBest          = mLayers;
+    }
+
+    // Go back to the best ordering
+    mLayers.swap( iBest );
+
+    for ( int i = 0; i < iLayerCount; ++i )
+    {
+        for ( size_t j = 0; j < mLayers[ i ].size(); ++j )
+        {
+            mOrder[ mLayers[ i ][ j ] ] = int( j );
+        }
+    }
+}
+
+void gxLayeredLayout::SortLayer( int  aLayer,
+                                 bool aDown )
+{
+    Layer& iLayer = mLayers[ aLayer ];
+
+    mSweepLayer = aLayer;
+    mSweepDown  = aDown;
+
+    gxParallelFor( this, &gxLayeredLayout::CalcBarycenters, iLayer.size(), MinNodesPerThread, mThreads );
+
+    // Ties keep their current order
+    std::vector< std::pair< float, int > > iKeys( iLayer.size() );
+
+    for ( size_t i = 0; i < iLayer.size(); ++i )
+    {
+        iKeys[ i ] = std::make_pair( mBarycenters[ iLayer[ i ] ], int( i ) );
+    }
+
+    std::sort( iKeys.begin(), iKeys.end() );
+
+    Layer iSorted( iLayer.size() );
+
+    for ( size_t i = 0; i < iKeys.size(); ++i )
+    {
+        iSorted[ i ] = iLayer[ iKeys[ i ].second ];
+        mOrder[ iSorted[ i ] ] = int( i );
+    }
+
+    iLayer.swap( iSorted );
+}
+
+void gxLayeredLayout::CalcBarycenters( size_t aFirst,
+                                       size_t aLast )
+{
+    const Layer&              iLayer      = mLayers[ mSweepLayer ];
+    const std::vector< int >& iOffsets    = mSweepDown ? mUpOffsets    : mDownOffsets;
+    const std::vector< int >& iNeighbours = mSweepDown ? mUpNeighbours : mDownNeighbours;
+
+    for ( size_t i = aFirst; i < aLast; ++i )
+    {
+        int iNode  = iLayer[ i ];
+        int iBegin = iOffsets[ iNode ];
+        int iEnd   = iOffsets[ iNode + 1 ];
+
+        // Nodes without neighbours stay where they are
+        if ( iBegin == iEnd )
+        {
+            mBarycenters[ iNode ] = float( i );
+            continue;
+        }
+
+        float iSum = 0;
+
+        for ( int j = iBegin; j < iEnd; ++j )
+        {
+            iSum += mOrder[ iNeighbours[ j ] ];
+        }
+
+        mBarycenters[ iNode ] = iSum / ( iEnd - iBegin );
+    }
+}
+
+long gxLayeredLayout::CountCrossings()
+{
+    size_t iPairs = mLayers.empty() ? 0 : mLayers.size() - 1;
+
+    mCrossings.assign( iPairs, 0 );
+
+    // Only go concurrent when there are enough edges to count
+    size_t iMinPairs = mDownNeighbours.size() >= MinEdgesPerThread ? 1 : iPairs;
+
+    gxParallelFor( this, &gxLayeredLayout::CountLayerCrossings, iPairs, iMinPairs, mThreads );
+
+    long iTotal = 0;
+
+    for ( size_t i = 0; i < iPairs; ++i )
+    {
+        iTotal += mCrossings[ i ];
+    }
+
+    return iTotal;
+}
+
+void gxLayeredLayout::CountLayerCrossings( size_t aFirst,
+                                           size_t aLast )
+{
+    std::vector< int >  iSequence;
+    std::vector< long > iTree;
+
+    for ( size_t iLayer = aFirst; iLayer < aLast; ++iLayer )
+    {
+        const Layer& iUpper = mLayers[ iLayer ];
+
+        // The positions of the lower ends of the edges, sorted by upper end
+        // then lower end. Two edges cross when their lower ends are inverted.
+        iSequence.clear();
+
+        for ( size_t i = 0; i < iUpper.size(); ++i )
+        {
+            size_t iStart = iSequence.size();
+
+            for ( int j = mDownOffsets[ iUpper[ i ] ]; j < mDownOffsets[ iUpper[ i ] + 1 ]; ++j )
+            {
+                iSequence.push_back( mOrder[ mDownNeighbours[ j ] ] );
+            }
+
+            std::sort( iSequence.begin() + iStart, iSequence.end() );
+        }
+
+        // Count the inversions with an accumulator tree (after Barth, Juenger
+        // and Mutzel) - each leaf counts the edges ending at a lower position.
+        size_t iLeaves = 1;
+
+        while ( iLeaves < mLayers[ iLayer + 1 ].size() )
+        {
+            iLeaves *= 2;
+        }
+
+        iTree.assign( 2 * iLeaves - 1, 0 );
+
+        long iCrossings = 0;
+
+        for ( size_t i = 0; i < iSequence.size(); ++i )
+        {
+            size_t iIndex = iSequence[ i ] + iLeaves - 1;
+            iTree[ iIndex ]++;
+
+            while ( iIndex > 0 )
+            {
+                // Left children add the edges ending right of them
+                if ( iIndex % 2 )
+                    iCrossings += iTree[ iIndex + 1 ];
+
+                iIndex = ( iIndex - 1 ) / 2;
+                iTree[ iIndex ]++;
+            }
+        }
+
+        mCrossings[ iLayer ] = iCrossings;
+    }
+}
+
+void gxLayeredLayout::AssignCoordinates()
+{
+    int iLayerCount = int( mLayers.size() );
+
+    // Start with each layer packed and centered
+    for ( int i = 0; i < iLayerCount; ++i )
+    {
+        float iPosition = 0;
+
+        for ( size_t j = 0; j < mLayers[ i ].size(); ++j )
+        {
+            int iNode = mLayers[ i ][ j ];
+
+            mPositions[ iNode ] = iPosition + mSizes[ iNode ] / 2;
+            iPosition += mSizes[ iNode ] + mNodeGap;
+        }
+
+        for ( size_t j = 0; j < mLayers[ i ].size(); ++j )
+        {
+            mPositions[ mLayers[ i ][ j ] ] -= iPosition / 2;
+        }
+    }
+
+    // Then pull each layer toward the barycenters of its nodes neighbours,
+    // sweeping down and up. The last pass takes both sides into account.
+    std::vector< float > iDesired;
+
+    for ( unsigned iSweep = 0; iSweep <= 2 * mCoordinateSweeps; ++iSweep )
+    {
+        bool iDown  = iSweep % 2 == 0;
+        bool iFinal = iSweep == 2 * mCoordinateSweeps;
+
+        for ( int k = 0; k < iLayerCount; ++k )
+        {
+            const Layer& iLayer = mLayers[ iDown ? k : iLayerCount - 1 - k ];
+
+            iDesired.resize( iLayer.size() );
+
+            for ( size_t i = 0; i < iLayer.size(); ++i )
+            {
+                int   iNode  = iLayer[ i ];
+                float iSum   = 0;
+                int   iCount = 0;
+
+                if ( iDown || iFinal )
+                {
+                    for ( int j = mUpOffsets[ iNode ]; j < mUpOffsets[ iNode + 1 ]; ++j, ++iCount )
+                    {
+                        iSum += mPositions[ mUpNeighbours[ j ] ];
+                    }
+                }
+
+                if ( !iDown || iFinal )
+                {
+                    for ( int j = mDownOffsets[ iNode ]; j < mDownOffsets[ iNode + 1 ]; ++j, ++iCount )
+                    {
+                        iSum += mPositions[ mDownNeighbours[ j ] ];
+                    }
+                }
+
+                iDesired[ i ] = iCount ? iSum / iCount : mPositions[ iNode ];
+            }
+
+            PlaceLayer( iLayer, iDesired );
+        }
+    }
+
+    // Move everything to start at 0
+    float iMin = 0;
+    bool  iFirst = true;
+
+    for ( int i = 0; i < iLayerCount; ++i )
+    {
+        int   iNode = mLayers[ i ].front();
+        float iLeft = mPositions[ iNode ] - mSizes[ iNode ] / 2;
+
+        if ( iFirst || iLeft < iMin )
+            iMin = iLeft;
+
+        iFirst = false;
+    }
+
+    for ( size_t i = 0; i < mPositions.size(); ++i )
+    {
+        mPositions[ i ] -= iMin;
+    }
+}
+
+void gxLayeredLayout::PlaceLayer( const Layer&                aLayer,
+                                  const std::vector< float >& aDesired )
+{
+    // Each node must be at least its offset (the sizes and gaps of the nodes
+    // before it) after the first one. Subtracting the offsets turns this into
+    // finding the nondecreasing sequence closest to the desired positions,
+    // which pooling adjacent violators solves in linear time.
+    std::vector< float > iOffsets( aLayer.size() );
+
+    // The pooled blocks, as their total, count and last node
+    std::vector< float > iTotals;
+    std::vector< int >   iCounts;
+    std::vector< int >   iEnds;
+
+    float iOffset = 0;
+
+    for ( size_t i = 0; i < aLayer.size(); ++i )
+    {
+        if ( i > 0 )
+            iOffset += ( mSizes[ aLayer[ i - 1 ] ] + mSizes[ aLayer[ i ] ] ) / 2 + mNodeGap;
+
+        iOffsets[ i ] = iOffset;
+
+        iTotals.push_back( aDesired[ i ] - iOffset );
+        iCounts.push_back( 1 );
+        iEnds.push_back( int( i ) );
+
+        // Merge with the previous block while its mean is greater
+        while ( iTotals.size() > 1 )
+        {
+            size_t iLast = iTotals.size() - 1;
+
+            if ( iTotals[ iLast - 1 ] * iCounts[ iLast ] <= iTotals[ iLast ] * iCounts[ iLast - 1 ] )
+                break;
+
+            iTotals[ iLast - 1 ] += iTotals[ iLast ];
+            iCounts[ iLast - 1 ] += iCounts[ iLast ];
+            iEnds  [ iLast - 1 ]  = iEnds  [ iLast ];
+
+            iTotals.pop_back();
+            iCounts.pop_back();
+            iEnds.pop_back();
+        }
+    }
+
+    size_t iNode = 0;
+
+    for ( size_t i = 0; i < iTotals.size(); ++i )
+    {
+        float iMean = iTotals[ i ] / iCounts[ i ];
+
+        for ( ; int( iNode ) <= iEnds[ i ]; ++iNode )
+        {
+            mPositions[ aLayer[ iNode ] ] = iMean + iOffsets[ iNode ];
+        }
+    }
+}
+
+void gxLayeredLayout::MoveLayoutees()
+{
+    const gxConnectionGraph::Nodes& iLayoutees = mGraph.GetNodes();
+
+    // Each layer is as thick as its thickest layoutee
+    std::vector< gxPix > iLayerStarts( mLayers.size() + 1, 0 );
+
+    for ( int i = 0; i < mRealCount; ++i )
+    {
+        iLayerStarts[ mLayer[ i ] + 1 ] = gxMax( iLayerStarts[ mLayer[ i ] + 1 ],
+                                                 iLayoutees[ i ]->GetSize( !mOnMajorAxis ) );
+    }
+
+    for ( size_t i = 0; i < mLayers.size(); ++i )
+    {
+        iLayerStarts[ i + 1 ] += iLayerStarts[ i ] + mLayerGap;
+    }
+
+    // Layoutees are centered within their layer
+    for ( int i = 0; i < mRealCount; ++i )
+    {
+        gxRect iBounds    = iLayoutees[ i ]->GetBounds();
+        gxPix  iThickness = iLayerStarts[ mLayer[ i ] + 1 ] - iLayerStarts[ mLayer[ i ] ] - mLayerGap;
+
+        iBounds.SetPosition( gxPix( std::floor( mPositions[ i ] - mSizes[ i ] / 2 + 0.5f ) ), mOnMajorAxis );
+        iBounds.SetPosition( iLayerStarts[ mLayer[ i ] ] +
+                             ( iThickness - iBounds.GetSize( !mOnMajorAxis ) ) / 2, !mOnMajorAxis );
+
+        iLayoutees[ i ]->SetBounds( iBounds );
+    }
+}
@@ -0,0 +1,181 @@
+#ifndef gxLayeredLayout_h
+#define gxLayeredLayout_h
+
+#include "View/Layouts/gxLayout.h"
+#include "View/Layouts/gxConnectionGraph.h"
+
+#include <vector>
+
+/**
+ * @brief A layout that arranges the directed graph formed by the connections
+ * of its layoutees in layers (after Sugiyama, Tagawa and Toda).
+ *
+ * The graph is the {@link gxConnectionGraph connection graph} of the
+ * layoutees, edges going from the source anchor to the destination one. The
+ * layout runs in four phases:
+ * - Cycle breaking: edges closing a cycle in a depth-first search are
+ *   reversed, making the graph acyclic.
+ * - Layer assignment: each layoutee is placed one layer below the lowest of
+ *   its predecessors (longest path). Edges spanning more than one layer are
+ *   split by dummy nodes, one per layer crossed.
+ * - Crossing minimization: the layers are reordered by the barycenter of
+ *   each node's neighbours in the adjacent layer, sweeping down and up. The
+ *   sweeps stop as soon as a sweep no longer reduces the number of crossings
+ *   (counted in O(E log V) with an accumulator tree), and the best ordering
+ *   found is kept.
+ * - Coordinate assignment: each layer is placed as close as possible to the
+ *   barycenters of the nodes' neighbours without overlapping, which is solved
+ *   exactly for each layer by isotonic regression.
+ *
+ * Layers are stacked on the minor axis and nodes within a layer are spread on
+ * the major axis. The graph is kept in compressed sparse (offsets and
+ * neighbours) arrays, and for large graphs the barycenters of a layer and the
+ * crossings of the layer pairs are computed over several threads.
+ */
+class gxLayeredLayout : public gxLayout
+{
+public:
+    gxLayeredLayout();
+
+    gxLayeredLayout( bool aOnMajorAxis );
+
+    gxLayeredLayout( gxPix aNodeGap,
+                     gxPix aLayerGap,
+                     bool  aOnMajorAxis = true );
+
+    ~gxLayeredLayout();
+
+    /**
+     * @brief Sets the number of threads used for large graphs.
+     *
+     * @param aThreads The number of threads; 0 (the default) uses the number
+     * of cores, 1 computes everything on the calling thread.
+     */
+    void SetThreads( unsigned aThreads );
+
+    /**
+     * @brief Returns the number of edge crossings left by the last layout.
+     */
+    long GetCrossings() const { return mCrossingCount; }
+
+protected:
+    // The space between nodes of the same layer.
+    gxPix mNodeGap;
+
+    // The space between layers.
+    gxPix mLayerGap;
+
+    // The maximal number of crossing minimization (down and up) sweeps.
+    unsigned mMaxSweeps;
+
+    // The number of coordinate assignment (down and up) sweeps.
+    unsigned mCoordinateSweeps;
+
+    virtual void DoLayout( gxViewElement* aLayouter );
+
+private:
+    typedef std::vector< int > Layer;
+
+    gxConnectionGraph mGraph;
+
+    // The number of real nodes (layoutees); dummy nodes follow them.
+    int mRealCount;
+
+    // Per node (real and dummy) layer, index within the layer, barycenter,
+    // size on the major axis and center position on the major axis
+    std::vector< int >   mLayer;
+    std::vector< int >   mOrder;
+    std::vector< float > mBarycenters;
+    std::vector< float > mSizes;
+    std::vector< float > mPositions;
+
+    // The edges between adjacent layers, as the neighbours in the layer above
+    // (up) and below (down) of each node
+    std::vector< int > mUpOffsets;
+    std::vector< int > mUpNeighbours;
+    std::vector< int > mDownOffsets;
+    std::vector< int > mDownNeighbours;
+
+    std::vector< Layer > mLayers;
+
+    // The crossings between each layer and the one below it
+    std::vector< long > mCrossings;
+    long                mCrossingCount;
+
+    // The layer, and neighbours direction, barycenters are computed for
+    int  mSweepLayer;
+    bool mSweepDown;
+
+    unsigned mThreads;
+
+    /**
+     * @brief Reverses the edges that close a cycle.
+     */
+    void BreakCycles( gxConnectionGraph::Edges& aEdges );
+
+    /**
+     * @brief Assigns a layer to each real node (longest path layering).
+     */
+    void AssignLayers( const gxConnectionGraph::Edges& aEdges );
+
+    /**
+     * @brief Splits the edges into edges between adjacent layers, adding
+     * dummy nodes, and builds the layers and the sparse adjacency.
+     */
+    void BuildLayers( const gxConnectionGraph::Edges& aEdges );
+
+    /**
+     * @brief Reorders the layers, minimizing edge crossings.
+     */
+    void OrderLayers();
+
+    /**
+     * @brief Reorders a layer by the barycenters of its nodes neighbours.
+     *
+     * @param aLayer The layer.
+     * @param aDown Whether the neighbours are in the layer above (during a
+     *        down sweep) or below.
+     */
+    void SortLayer( int  aLayer,
+                    bool aDown );
+
+    /**
+     * @brief Computes the barycenters of a range of nodes of the sweep layer.
+     *
+     * Called concurrently for different ranges.
+     */
+    void CalcBarycenters( size_t aFirst,
+                          size_t aLast );
+
+    /**
+     * @brief Counts the crossings between all adjacent layers.
+     */
+    long CountCrossings();
+
+    /**
+     * @brief Counts the crossings below a range of layers.
+     *
+     * Called concurrently for different ranges.
+     */
+    void CountLayerCrossings( size_t aFirst,
+                              size_t aLast );
+
+    /**
+     * @brief Assigns the major axis positions of all nodes.
+     */
+    void AssignCoordinates();
+
+    /**
+     * @brief Places a layer as close as possible to the given node positions,
+     * keeping its order and the gap between nodes.
+     */
+    void PlaceLayer( const Layer&                aLayer,
+                     const std::vector< float >& aDesired );
+
+    /**
+     * @brief Moves the layoutees to their layers and positions.
+     */
+    void MoveLayoutees();
+};
+
+#endif //gxLayeredLayout_h
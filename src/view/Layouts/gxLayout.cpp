@@ -1,5 +1,6 @@
 #include "View/Layouts/gxLayout.h"
 #include "View/Elements/gxViewElement.h"
+#include "core/gxTrace.h"
 
 gxLayout::gxLayout() :
     mOnMajorAxis ( true ),
@@ -25,6 +26,8 @@ void gxLayout::Layout( gxViewElement* aLayouter )
     if ( mLayoutStatus == Valid )
         return;
     
+    gxTraceScope( "layout", typeid( *this ), aLayouter );
+
     // Mark the layout as in progress
     mLayoutStatus = InProgress;
     
@@ -33,7 +36,15 @@ void gxLayout::Layout( gxViewElement* aLayouter )
     DoLayout( aLayouter );
     
     Apply();
-    
+
+    // A layout that hasn't completed carries on in the next validation.
+    if ( !IsComplete() )
+    {
+        mLayoutStatus = Invalid;
+        aLayouter->Invalidate();
+        return;
+    }
+
     // Mark the layout as valid
     mLayoutStatus = Valid;
 }
@@ -53,7 +53,17 @@ protected:
      * will implement.
      */
     virtual void DoLayout( gxViewElement* aLayouter ) = 0;
-    
+
+    /**
+     * @brief Returns whether or not the last DoLayout() has completed the
+     * layout.
+     *
+     * Layouts that spread their work across several validations return false
+     * until they are done; the layout then remains invalid and the layouter is
+     * invalidated, so another validation is queued. Returns true by default.
+     */
+    virtual bool IsComplete() { return true; }
+
     // TODO: what's up with these?
     virtual void Init();
     virtual void Apply();
@@ -0,0 +1,583 @@
+#include "View/Layouts/gxTreeLayout.h"
+#include "View/Elements/gxViewElement.h"
+
+#include <algorithm>
+
+gxTreeLayout::Node::Node( gxViewElement* aElement ) :
+    mElement   ( aElement ),
+    mParent    ( NULL     ),
+    mChildCount( 0        ),
+    mSize      ( 0        ),
+    mOffset    ( 0        ),
+    mPosition  ( 0        ),
+    mDepth     ( 0        ),
+    mPass      ( 0        ),
+    mDirty     ( false    ),
+    mChanged   ( true     ),
+    mCollapsed ( false    ),
+    mConcealed ( false    ),
+    mVisible   ( false    )
+{
+}
+
+gxTreeLayout::gxTreeLayout() :
+    mSiblingGap( 10 ),
+    mLevelGap  ( 20 ),
+    mPass      ( 0  )
+{
+}
+
+gxTreeLayout::gxTreeLayout( bool aOnMajorAxis ) :
+    gxConstraintLayout( aOnMajorAxis ),
+    mSiblingGap       ( 10 ),
+    mLevelGap         ( 20 ),
+    mPass             ( 0  )
+{
+}
+
+gxTreeLayout::gxTreeLayout( gxPix aSiblingGap,
+                            gxPix aLevelGap,
+                            bool  aOnMajorAxis ) :
+    gxConstraintLayout( aOnMajorAxis ),
+    mSiblingGap       ( aSiblingGap  ),
+    mLevelGap         ( aLevelGap    ),
+    mPass             ( 0            )
+{
+}
+
+gxTreeLayout::~gxTreeLayout()
+{
+    for ( NodeMap::iterator iNode = mNodes.begin(); iNode != mNodes.end(); ++iNode )
+    {
+        delete iNode->second;
+    }
+}
+
+void gxTreeLayout::Collapse( gxViewElement* aNode )
+{
+    SetCollapsed( aNode, true );
+}
+
+void gxTreeLayout::Expand( gxViewElement* aNode )
+{
+    SetCollapsed( aNode, false );
+}
+
+bool gxTreeLayout::IsCollapsed( gxViewElement* aNode )
+{
+    NodeMap::iterator iNode = mNodes.find( aNode );
+
+    return iNode != mNodes.end() && iNode->second->mCollapsed;
+}
+
+void gxTreeLayout::Remove( gxViewElement* aLayoutee )
+{
+    NodeMap::iterator iNode = mNodes.find( aLayoutee );
+
+    if ( iNode != mNodes.end() )
+        DeleteNode( iNode->second );
+
+    gxConstraintLayout::Remove( aLayoutee );
+}
+
+bool gxTreeLayout::IsSupportedConstraint( const gxConstraintId aId )
+{
+    return aId == gxTypeId( gxTreeParentConstraint* );
+}
+
+void gxTreeLayout::DoLayout( gxViewElement* aLayouter )
+{
+    SyncNodes( aLayouter );
+
+    UpdateVisibility();
+
+    PropagateChanges();
+
+    CalcContours();
+
+    PlaceNodes();
+}
+
+gxTreeLayout::Node* gxTreeLayout::GetNode( gxViewElement* aLayoutee )
+{
+    NodeMap::iterator iNode = mNodes.find( aLayoutee );
+
+    if ( iNode != mNodes.end() )
+        return iNode->second;
+
+    Node* iNewNode = new Node( aLayoutee );
+    mNodes[ aLayoutee ] = iNewNode;
+
+    return iNewNode;
+}
+
+void gxTreeLayout::DeleteNode( Node* aNode )
+{
+    // Detach from the parent, whose contour is now stale
+    if ( aNode->mParent )
+    {
+        Nodes& iSiblings = aNode->mParent->mChildren;
+        iSiblings.erase( std::remove( iSiblings.begin(), iSiblings.end(), aNode ),
+                         iSiblings.end() );
+
+        aNode->mParent->mChanged = true;
+    }
+
+    // The children are now roots (until the next layout tells otherwise)
+    for ( Nodes::iterator iChild = aNode->mChildren.begin(); iChild != aNode->mChildren.end(); ++iChild )
+    {
+        (*iChild)->mParent = NULL;
+    }
+
+    mRoots.erase( std::remove( mRoots.begin(), mRoots.end(), aNode ),
+                  mRoots.end() );
+
+    mNodes.erase( aNode->mElement );
+
+    delete aNode;
+}
+
+void gxTreeLayout::SetCollapsed( gxViewElement* aNode,
+                                 bool           aCollapsed )
+{
+    Node* iNode = GetNode( aNode );
+
+    if ( iNode->mCollapsed == aCollapsed )
+        return;
+
+    iNode->mCollapsed = aCollapsed;
+    iNode->mChanged   = true;
+
+    // Invalidating the node will invalidate the layout
+    aNode->Invalidate();
+}
+
+void gxTreeLayout::SyncNodes( gxViewElement* aLayouter )
+{
+    mPass++;
+
+    Nodes iNodes;
+
+    gxViewElement::Iterator iLayoutees( aLayouter->GetChildren() );
+
+    for ( iLayoutees.First(); iLayoutees.Current(); iLayoutees.Next() )
+    {
+        Node* iNode = GetNode( iLayoutees.Current() );
+
+        iNode->mPass       = mPass;
+        iNode->mChildCount = 0;
+
+        // Only the size on the major axis affects the contour; the minor axis
+        // size is read when the levels are positioned.
+        gxPix iSize = iLayoutees.Current()->GetSize( mOnMajorAxis );
+
+        if ( iSize != iNode->mSize )
+        {
+            iNode->mSize    = iSize;
+            iNode->mChanged = true;
+        }
+
+        iNodes.push_back( iNode );
+    }
+
+    // Delete the nodes of layoutees that are no longer in the layouter
+    for ( NodeMap::iterator iNode = mNodes.begin(); iNode != mNodes.end(); )
+    {
+        Node* iCurrent = iNode->second;
+        ++iNode;
+
+        if ( iCurrent->mPass != mPass )
+            DeleteNode( iCurrent );
+    }
+
+    // Resolve parents and rebuild the children lists in place, marking nodes
+    // whose children have changed.
+    gxTreeParentConstraint* iParentConstraint;
+    size_t                  iRootCount = 0;
+
+    for ( Nodes::iterator iNode = iNodes.begin(); iNode != iNodes.end(); ++iNode )
+    {
+        Node* iParent = NULL;
+
+        mConstraints.Get( (*iNode)->mElement, iParentConstraint );
+
+        if ( iParentConstraint )
+        {
+            NodeMap::iterator iFound = mNodes.find( iParentConstraint->GetValue() );
+
+            if ( iFound != mNodes.end() && iFound->second != *iNode )
+                iParent = iFound->second;
+        }
+
+        (*iNode)->mParent = iParent;
+
+        // Roots are always placed again, so no need to track changes.
+        if ( iParent == NULL )
+        {
+            if ( iRootCount < mRoots.size() )
+                mRoots[ iRootCount ] = *iNode;
+            else
+                mRoots.push_back( *iNode );
+
+            iRootCount++;
+            continue;
+        }
+
+        Nodes& iChildren = iParent->mChildren;
+        size_t iIndex    = iParent->mChildCount++;
+
+        if ( iIndex < iChildren.size() )
+        {
+            if ( iChildren[ iIndex ] != *iNode )
+            {
+                iChildren[ iIndex ] = *iNode;
+                iParent->mChanged   = true;
+            }
+        } else {
+            iChildren.push_back( *iNode );
+            iParent->mChanged = true;
+        }
+    }
+
+    mRoots.resize( iRootCount );
+
+    // Trim children lists that got shorter
+    for ( Nodes::iterator iNode = iNodes.begin(); iNode != iNodes.end(); ++iNode )
+    {
+        if ( (*iNode)->mChildren.size() != (*iNode)->mChildCount )
+        {
+            (*iNode)->mChildren.resize( (*iNode)->mChildCount );
+            (*iNode)->mChanged = true;
+        }
+    }
+}
+
+void gxTreeLayout::UpdateVisibility()
+{
+    // Walk the tree top-down, so parents are always updated before their
+    // children.
+    Nodes iStack( mRoots.rbegin(), mRoots.rend() );
+
+    while ( !iStack.empty() )
+    {
+        Node* iNode = iStack.back();
+        iStack.pop_back();
+
+        // A node is concealed if its parent is collapsed or isn't shown
+        bool iConceal = iNode->mParent &&
+                        ( iNode->mParent->mCollapsed || !iNode->mParent->mVisible );
+
+        if ( iConceal != iNode->mConcealed )
+        {
+            iNode->mConcealed = iConceal;
+            iNode->mElement->SetVisible( !iConceal );
+        }
+
+        // A node that was shown or hidden changes its parent contour
+        bool iVisible = iNode->mElement->IsVisible();
+
+        if ( iVisible != iNode->mVisible )
+        {
+            iNode->mVisible = iVisible;
+
+            if ( iNode->mParent )
+                iNode->mParent->mChanged = true;
+        }
+
+        iStack.insert( iStack.end(), iNode->mChildren.rbegin(), iNode->mChildren.rend() );
+    }
+}
+
+void gxTreeLayout::PropagateChanges()
+{
+    for ( NodeMap::iterator iNode = mNodes.begin(); iNode != mNodes.end(); ++iNode )
+    {
+        if ( !iNode->second->mChanged )
+            continue;
+
+        iNode->second->mChanged = false;
+
+        // Stop at the first dirty ancestor - its own ancestors are dirty too.
+        for ( Node* iDirty = iNode->second; iDirty && !iDirty->mDirty; iDirty = iDirty->mParent )
+        {
+            iDirty->mDirty = true;
+        }
+    }
+}
+
+void gxTreeLayout::CalcContours()
+{
+    // Collect the dirty nodes top-down; as dirty nodes always have dirty
+    // ancestors, we only need to descend into dirty children.
+    Nodes iStack, iOrder;
+
+    for ( Nodes::iterator iRoot = mRoots.begin(); iRoot != mRoots.end(); ++iRoot )
+    {
+        if ( (*iRoot)->mDirty )
+            iStack.push_back( *iRoot );
+    }
+
+    while ( !iStack.empty() )
+    {
+        Node* iNode = iStack.back();
+        iStack.pop_back();
+
+        iOrder.push_back( iNode );
+
+        for ( Nodes::iterator iChild = iNode->mChildren.begin(); iChild != iNode->mChildren.end(); ++iChild )
+        {
+            if ( (*iChild)->mDirty )
+                iStack.push_back( *iChild );
+        }
+    }
+
+    // Now compute the contours bottom-up (children before their parents)
+    for ( Nodes::reverse_iterator iNode = iOrder.rbegin(); iNode != iOrder.rend(); ++iNode )
+    {
+        CalcContour( *iNode );
+        (*iNode)->mDirty = false;
+    }
+}
+
+void gxTreeLayout::CalcContour( Node* aNode )
+{
+    // The node's own level
+    Contour iOwnLevel = { 0, aNode->mSize, 0, NULL };
+
+    aNode->mContour.clear();
+    aNode->mContour.push_back( iOwnLevel );
+    aNode->mDepth = 1;
+
+    Nodes iChildren;
+    GetVisibleChildren( aNode, iChildren );
+
+    if ( iChildren.empty() )
+        return;
+
+    int      iDepth;
+    Contour* iChildrenContour = PlaceSiblings( iChildren, aNode->mContour, iDepth );
+
+    // Center the node above its first and last children
+    Node* iFirst = iChildren.front();
+    Node* iLast  = iChildren.back();
+
+    gxPix iPosition = ( iFirst->mOffset + iFirst->mSize / 2 +
+                        iLast->mOffset  + iLast->mSize  / 2 ) / 2 - aNode->mSize / 2;
+
+    // Make the children offsets relative to the node
+    for ( Nodes::iterator iChild = iChildren.begin(); iChild != iChildren.end(); ++iChild )
+    {
+        (*iChild)->mOffset -= iPosition;
+    }
+
+    // Link the node's own level to the merged contour of its children
+    aNode->mContour[ 0 ].mNext       = iChildrenContour;
+    aNode->mContour[ 0 ].mNextOffset = -iPosition;
+    aNode->mDepth                    = iDepth + 1;
+}
+
+void gxTreeLayout::PlaceNodes()
+{
+    Nodes iRoots;
+
+    for ( Nodes::iterator iRoot = mRoots.begin(); iRoot != mRoots.end(); ++iRoot )
+    {
+        if ( (*iRoot)->mVisible )
+            iRoots.push_back( *iRoot );
+    }
+
+    if ( iRoots.empty() )
+        return;
+
+    // Place the roots next to each other, like siblings
+    mForestContour.clear();
+
+    int      iDepth;
+    Contour* iContour = PlaceSiblings( iRoots, mForestContour, iDepth );
+
+    // Find the leftmost extent of the forest so it starts at 0
+    gxPix iFrame    = 0;
+    gxPix iLeftmost = iContour->mLo;
+
+    for ( Contour* iLevel = iContour; iLevel; iLevel = iLevel->mNext )
+    {
+        iLeftmost = gxMin( iLeftmost, iFrame + iLevel->mLo );
+        iFrame   += iLevel->mNextOffset;
+    }
+
+    // Work out the absolute positions and levels top-down
+    typedef std::pair< Node*, size_t > Entry;
+
+    std::vector< Entry > iStack, iOrder;
+    std::vector< gxPix > iLevelSizes;
+
+    for ( Nodes::reverse_iterator iRoot = iRoots.rbegin(); iRoot != iRoots.rend(); ++iRoot )
+    {
+        (*iRoot)->mPosition = (*iRoot)->mOffset - iLeftmost;
+        iStack.push_back( Entry( *iRoot, 0 ) );
+    }
+
+    Nodes iChildren;
+
+    while ( !iStack.empty() )
+    {
+        Entry iEntry = iStack.back();
+        iStack.pop_back();
+
+        iOrder.push_back( iEntry );
+
+        // Each level is as big as its biggest node on the minor axis
+        if ( iEntry.second >= iLevelSizes.size() )
+            iLevelSizes.resize( iEntry.second + 1, 0 );
+
+        iLevelSizes[ iEntry.second ] = gxMax( iLevelSizes[ iEntry.second ],
+                                              iEntry.first->mElement->GetSize( !mOnMajorAxis ) );
+
+        GetVisibleChildren( iEntry.first, iChildren );
+
+        for ( Nodes::reverse_iterator iChild = iChildren.rbegin(); iChild != iChildren.rend(); ++iChild )
+        {
+            (*iChild)->mPosition = iEntry.first->mPosition + (*iChild)->mOffset;
+            iStack.push_back( Entry( *iChild, iEntry.second + 1 ) );
+        }
+    }
+
+    // Turn the level sizes into level positions
+    gxPix iLevelPosition = 0;
+
+    for ( size_t iLevel = 0; iLevel < iLevelSizes.size(); ++iLevel )
+    {
+        gxPix iSize           = iLevelSizes[ iLevel ];
+        iLevelSizes[ iLevel ] = iLevelPosition;
+        iLevelPosition       += iSize + mLevelGap;
+    }
+
+    // Finally, set the bounds (elements that didn't move will ignore this)
+    for ( std::vector< Entry >::iterator iEntry = iOrder.begin(); iEntry != iOrder.end(); ++iEntry )
+    {
+        gxViewElement* iElement = iEntry->first->mElement;
+        gxRect         iBounds  = iElement->GetBounds();
+
+        iBounds.SetPosition( iEntry->first->mPosition,        mOnMajorAxis );
+        iBounds.SetPosition( iLevelSizes[ iEntry->second ], !mOnMajorAxis );
+
+        iElement->SetBounds( iBounds );
+    }
+}
+
+gxTreeLayout::Contour* gxTreeLayout::PlaceSiblings( const Nodes& aSiblings,
+                                                    Contours&    aStorage,
+                                                    int&         aDepth )
+{
+    // Merged entries point to each other, so work out how many will be
+    // created in order to reserve the storage up front (a merge creates as
+    // many entries as the depth of the shallower contour).
+    size_t iCount = 0;
+    aDepth        = aSiblings.front()->mDepth;
+
+    for ( size_t i = 1; i < aSiblings.size(); ++i )
+    {
+        iCount += gxMin( aDepth, aSiblings[ i ]->mDepth );
+        aDepth  = gxMax( aDepth, aSiblings[ i ]->mDepth );
+    }
+
+    aStorage.reserve( aStorage.size() + iCount );
+
+    // Place each sibling to the right of the merged contour of its left
+    // siblings.
+    Contour* iContour = &aSiblings.front()->mContour[ 0 ];
+    aSiblings.front()->mOffset = 0;
+
+    for ( size_t i = 1; i < aSiblings.size(); ++i )
+    {
+        Node*    iSibling     = aSiblings[ i ];
+        Contour* iSiblingHead = &iSibling->mContour[ 0 ];
+
+        iSibling->mOffset = Separation( iContour, iSiblingHead );
+
+        iContour = Merge( iContour, iSiblingHead, iSibling->mOffset, aStorage );
+    }
+
+    return iContour;
+}
+
+gxPix gxTreeLayout::Separation( Contour* aLeft,
+                                Contour* aRight )
+{
+    gxPix iLeftFrame  = 0;
+    gxPix iRightFrame = 0;
+    gxPix iSeparation = aLeft->mHi - aRight->mLo + mSiblingGap;
+
+    // Only walk down to the depth of the shallower contour
+    while ( aLeft && aRight )
+    {
+        iSeparation = gxMax( iSeparation,
+                             ( iLeftFrame + aLeft->mHi ) - ( iRightFrame + aRight->mLo ) + mSiblingGap );
+
+        iLeftFrame  += aLeft->mNextOffset;
+        iRightFrame += aRight->mNextOffset;
+        aLeft        = aLeft->mNext;
+        aRight       = aRight->mNext;
+    }
+
+    return iSeparation;
+}
+
+gxTreeLayout::Contour* gxTreeLayout::Merge( Contour*  aLeft,
+                                            Contour*  aRight,
+                                            gxPix     aOffset,
+                                            Contours& aStorage )
+{
+    gxPix    iLeftFrame  = 0;
+    gxPix    iRightFrame = aOffset;
+    Contour* iHead       = NULL;
+    Contour* iLast       = NULL;
+
+    // The common levels span from the left contour low to the right contour
+    // high; these are created in the frame of the left contour.
+    while ( aLeft && aRight )
+    {
+        Contour iLevel = { iLeftFrame  + aLeft->mLo,
+                           iRightFrame + aRight->mHi,
+                           0,
+                           NULL };
+
+        aStorage.push_back( iLevel );
+
+        if ( iLast )
+            iLast->mNext = &aStorage.back();
+        else
+            iHead = &aStorage.back();
+
+        iLast = &aStorage.back();
+
+        iLeftFrame  += aLeft->mNextOffset;
+        iRightFrame += aRight->mNextOffset;
+        aLeft        = aLeft->mNext;
+        aRight       = aRight->mNext;
+    }
+
+    // Below the common levels, the deeper contour is shared as is
+    if ( aLeft )
+    {
+        iLast->mNext       = aLeft;
+        iLast->mNextOffset = iLeftFrame;
+    } else if ( aRight ) {
+        iLast->mNext       = aRight;
+        iLast->mNextOffset = iRightFrame;
+    }
+
+    return iHead;
+}
+
+void gxTreeLayout::GetVisibleChildren( Node*  aNode,
+                                       Nodes& aChildren )
+{
+    aChildren.clear();
+
+    for ( Nodes::iterator iChild = aNode->mChildren.begin(); iChild != aNode->mChildren.end(); ++iChild )
+    {
+        if ( (*iChild)->mVisible )
+            aChildren.push_back( *iChild );
+    }
+}
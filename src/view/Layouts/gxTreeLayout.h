@@ -0,0 +1,255 @@
+#ifndef gxTreeLayout_h
+#define gxTreeLayout_h
+
+#include "View/Layouts/gxConstraintLayout.h"
+#include "View/Layouts/Constraints/gxTreeParentConstraint.h"
+
+#include <map>
+#include <vector>
+
+/**
+ * @brief A layout that arranges its layoutees as a tidy tree (after Reingold
+ * and Tilford).
+ *
+ * The tree structure is given by a {@link gxTreeParentConstraint tree parent
+ * constraint} on each non-root layoutee; layoutees without one are roots, and
+ * multiple roots are laid out side by side. Siblings keep the order they have
+ * in the layouter.
+ *
+ * Siblings are spread on the major axis and each depth level gets its own band
+ * on the minor axis. A parent is centered above its first and last children.
+ *
+ * Every subtree keeps its contour - the left and right extent of each of its
+ * levels, relative to the subtree root. Placing a subtree next to its left
+ * siblings only walks the contours down to the depth of the shallower of the
+ * two, which keeps the whole layout linear in the number of nodes.
+ *
+ * Contours are kept between layouts, so when a node is collapsed, expanded,
+ * resized, added or removed only the contours on the path from that node up to
+ * its root are recomputed.
+ */
+class gxTreeLayout : public gxConstraintLayout
+{
+public:
+    gxTreeLayout();
+
+    gxTreeLayout( bool aOnMajorAxis );
+
+    gxTreeLayout( gxPix aSiblingGap,
+                  gxPix aLevelGap,
+                  bool  aOnMajorAxis = true );
+
+    ~gxTreeLayout();
+
+    /**
+     * @brief Collapses a node, hiding all of its descendants.
+     *
+     * @param aNode The layoutee to collapse.
+     */
+    void Collapse( gxViewElement* aNode );
+
+    /**
+     * @brief Expands a node, showing its descendants again (apart from those
+     * below collapsed nodes).
+     *
+     * @param aNode The layoutee to expand.
+     */
+    void Expand( gxViewElement* aNode );
+
+    /**
+     * @brief Returns whether or not a node is collapsed.
+     *
+     * @param aNode The layoutee.
+     * @return True if the node is collapsed.
+     */
+    bool IsCollapsed( gxViewElement* aNode );
+
+    virtual void Remove( gxViewElement* aLayoutee );
+
+protected:
+    // The space between siblings (and between adjacent subtrees).
+    gxPix mSiblingGap;
+
+    // The space between levels.
+    gxPix mLevelGap;
+
+    virtual bool IsSupportedConstraint( const gxConstraintId aId );
+
+    virtual void DoLayout( gxViewElement* aLayouter );
+
+private:
+    /**
+     * @brief One level of a subtree contour.
+     *
+     * The extent of the level (mLo to mHi) is relative to the frame of the
+     * entry. The next (deeper) level might be in a different frame, so each
+     * entry also holds the offset of the next entry frame relative to its own.
+     *
+     * This allows the deeper levels of a contour to be shared, as is, with
+     * the contours of the subtree ancestors.
+     */
+    struct Contour
+    {
+        gxPix    mLo;
+        gxPix    mHi;
+        gxPix    mNextOffset;
+        Contour* mNext;
+    };
+
+    typedef std::vector< Contour > Contours;
+
+    struct Node;
+    typedef std::vector< Node* > Nodes;
+
+    /**
+     * @brief The layout data of a single layoutee.
+     */
+    struct Node
+    {
+        Node( gxViewElement* aElement );
+
+        gxViewElement* mElement;
+
+        // The tree parent (NULL for roots)
+        Node* mParent;
+
+        // The tree children, in the order of the layouter children
+        Nodes mChildren;
+
+        // The number of children found so far while syncing the nodes
+        size_t mChildCount;
+
+        // The size of the element on the major axis, as used by the contour
+        gxPix mSize;
+
+        // The position on the major axis, relative to the parent position.
+        gxPix mOffset;
+
+        // The absolute position on the major axis.
+        gxPix mPosition;
+
+        // The number of levels in the subtree contour.
+        int mDepth;
+
+        // The contour entries owned by this node. The first is the node's own
+        // level, the rest are created when the children contours are merged.
+        Contours mContour;
+
+        // The last layout pass in which the node was found in the layouter.
+        unsigned long mPass;
+
+        // Whether the subtree contour needs to be recomputed
+        bool mDirty;
+
+        // Whether something changed that affects the subtree contour
+        bool mChanged;
+
+        // Whether the node is collapsed
+        bool mCollapsed;
+
+        // Whether the node was hidden by the layout (under a collapsed node)
+        bool mConcealed;
+
+        // Whether the node took part in the last layout
+        bool mVisible;
+    };
+
+    typedef std::map< gxViewElement*, Node* > NodeMap;
+
+    NodeMap       mNodes;
+    Nodes         mRoots;
+    Contours      mForestContour;
+    unsigned long mPass;
+
+    /**
+     * @brief Returns the node of the given layoutee, creating one if needed.
+     */
+    Node* GetNode( gxViewElement* aLayoutee );
+
+    /**
+     * @brief Deletes a node, detaching it from its parent and children.
+     */
+    void DeleteNode( Node* aNode );
+
+    /**
+     * @brief Sets whether or not a node is collapsed.
+     */
+    void SetCollapsed( gxViewElement* aNode,
+                       bool           aCollapsed );
+
+    /**
+     * @brief Brings the nodes in line with the layoutees - their sizes,
+     * parents and order - and marks changed nodes.
+     */
+    void SyncNodes( gxViewElement* aLayouter );
+
+    /**
+     * @brief Hides the descendants of collapsed (or hidden) nodes and shows
+     * those that are no longer under one.
+     */
+    void UpdateVisibility();
+
+    /**
+     * @brief Marks every changed node, and all of its ancestors, as dirty.
+     */
+    void PropagateChanges();
+
+    /**
+     * @brief Recomputes the contours of all dirty nodes, bottom-up.
+     */
+    void CalcContours();
+
+    /**
+     * @brief Computes the contour of a single node, assuming the contours of
+     * its children are valid.
+     */
+    void CalcContour( Node* aNode );
+
+    /**
+     * @brief Places the roots next to each other, then sets the final bounds
+     * of all nodes.
+     */
+    void PlaceNodes();
+
+    /**
+     * @brief Places a list of sibling subtrees next to each other.
+     *
+     * Sets the offset of each sibling relative to the first one, and returns
+     * the merged contour of all of them (in the frame of the first one).
+     *
+     * @param aSiblings The visible siblings (at least one).
+     * @param aStorage Where the merged contour entries are created.
+     * @param aDepth Is set to the number of levels of the merged contour.
+     */
+    Contour* PlaceSiblings( const Nodes& aSiblings,
+                            Contours&    aStorage,
+                            int&         aDepth );
+
+    /**
+     * @brief Returns the offset at which the right contour has to be placed
+     * (relative to the left one) so the two won't overlap.
+     */
+    gxPix Separation( Contour* aLeft,
+                      Contour* aRight );
+
+    /**
+     * @brief Merges two contours, the right one at the given offset.
+     *
+     * Only the levels common to both contours are created; the deeper
+     * contour is linked from there on.
+     *
+     * @return The merged contour, in the frame of the left one.
+     */
+    Contour* Merge( Contour*  aLeft,
+                    Contour*  aRight,
+                    gxPix     aOffset,
+                    Contours& aStorage );
+
+    /**
+     * @brief Returns the visible children of a node.
+     */
+    void GetVisibleChildren( Node*  aNode,
+                             Nodes& aChildren );
+};
+
+#endif //gxTreeLayout_h
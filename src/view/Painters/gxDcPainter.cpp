@@ -4,7 +4,10 @@ gxDcPainter::gxDcPainter( gxPaintDC     *aDc,
                           gxRects const &aDamagedRects )
 {
     mDc = aDc;
-    mDamagedRects = aDamagedRects;
+    mDamagedRects.Assign( aDamagedRects );
+
+    // The DC font doesn't change while painting.
+    mFontId = mDc->GetFontId();
 }
 
 gxRect gxDcPainter::GetClipRect() const
@@ -14,9 +17,11 @@ gxRect gxDcPainter::GetClipRect() const
 
 bool gxDcPainter::NeedsPainting( gxRect const &aRect )
 {
-    // Transform the rect
-    gxRect iRect( aRect );
-    Transform( iRect );
+    // Transform the rect, into device pixels
+    gxFixedRect iFixedRect = gxToFixed( aRect );
+    Transform( iFixedRect );
+
+    gxRect iRect = gxToPix( iFixedRect );
 
     // Get the cliping rect
     gxRect iClipRect = GetClipRect();
@@ -26,18 +31,12 @@ bool gxDcPainter::NeedsPainting( gxRect const &aRect )
         return false;
 
     // If the rect intersects with any of the damaged rects return true
-    for( unsigned int i = 0; i < mDamagedRects.size(); i++ )
-    {
-        if ( mDamagedRects[i].Intersects( iRect ) )
-            return true;
-    }
-
-    return false;
+    return mDamagedRects.IntersectsAny( iRect );
 }
 
-void gxDcPainter::IntersectClipArea( gxRect const &aRect )
+void gxDcPainter::IntersectClipArea( gxFixedRect const &aRect )
 {
-    mDc->SetClippingRegion(aRect);
+    mDc->SetClippingRegion( gxToPix( aRect ) );
 }
 
 void gxDcPainter::SetAbsoluteClipArea( gxRect const &aRect )
@@ -46,30 +45,53 @@ void gxDcPainter::SetAbsoluteClipArea( gxRect const &aRect )
     mDc->SetClippingRegion( aRect );
 }
 
-void gxDcPainter::DoDrawRectangle( gxRect const &aRect )
+void gxDcPainter::DoDrawRectangle( gxFixedRect const &aRect )
 {
-    mDc->DrawRectangle( aRect );
+    mDc->DrawRectangle( gxToPix( aRect ) );
 }
 
-void gxDcPainter::DoDrawLine( gxPoint &aFrom,
-                              gxPoint &aTo )
+void gxDcPainter::DoDrawLine( gxFixedPoint &aFrom,
+                              gxFixedPoint &aTo )
 {
-    mDc->DrawLine( aFrom.X, aFrom.Y, aTo.X, aTo.Y );
+    gxPoint iFrom = gxToPix( aFrom );
+    gxPoint iTo   = gxToPix( aTo );
+
+    mDc->DrawLine( iFrom.X, iFrom.Y, iTo.X, iTo.Y );
 }
 
 void gxDcPainter::DoDrawText( gxString &aText,
-                              gxPix    &aX,
-                              gxPix    &aY,
+                              gxFixed  &aX,
+                              gxFixed  &aY,
                               double   aAngle )
 {
     if ( aAngle == 0 )
-        mDc->DrawText( aText, aX , aY );
+        mDc->DrawText( aText, gxToPix( aX ), gxToPix( aY ) );
     else
-        mDc->DrawRotatedText( aText, aX, aY, aAngle );
+        mDc->DrawRotatedText( aText, gxToPix( aX ), gxToPix( aY ), aAngle );
+}
+
+void gxDcPainter::DoDrawLabel( gxString &aText,
+                               gxFixed  &aX,
+                               gxFixed  &aY,
+                               bool     isHorizontal )
+{
+    mDc->DrawLabel( aText, gxToPix( aX ), gxToPix( aY ), isHorizontal );
+}
+
+bool gxDcPainter::DoBeginStrip( gxStrip       &aStrip,
+                                gxRect const  &aRect,
+                                gxPoint const &aShift,
+                                gxRect const  &aExposed )
+{
+    return mDc->BeginStrip( aStrip.GetId(), aRect, aShift, aExposed );
+}
+
+void gxDcPainter::DoEndStrip()
+{
+    mDc->EndStrip();
 }
 
 gxSize gxDcPainter::GetTextSize( gxString &aText )
 {
-    wxSize iSize = mDc->GetTextExtent( aText );
-    return gxSize( iSize.x, iSize.y );
+    return gxTextCache::Get().GetTextSize( mFontId, aText, *mDc );
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #define gxDcPainter_h
 
 #include "core/gxPaintDC.h"
+#include "core/gxTextCache.h"
+#include "core/geometry/gxRectBatch.h"
 #include "View/Painters/gxPainter.h"
 
 /**
@@ -23,30 +25,55 @@ public:
 
     virtual bool NeedsPainting( gxRect const &aRect );
 
-    // Overridden draw methods.
-    virtual void DoDrawRectangle( gxRect const &aRect );
+    // Overridden draw methods, converting to device pixels.
+    virtual void DoDrawRectangle( gxFixedRect const &aRect );
     
-    virtual void DoDrawLine( gxPoint &aFrom,
-                             gxPoint &aTo );
+    virtual void DoDrawLine( gxFixedPoint &aFrom,
+                             gxFixedPoint &aTo );
     
     virtual void DoDrawText( gxString &aText,
-                             gxPix    &aX,
-                             gxPix    &aY,
+                             gxFixed  &aX,
+                             gxFixed  &aY,
                              double   aAngle = 0 );
 
         
+    /**
+     * @brief Draws the label from the DC's label atlas.
+     */
+    virtual void DoDrawLabel( gxString &aText,
+                              gxFixed  &aX,
+                              gxFixed  &aY,
+                              bool     isHorizontal );
+
+    /**
+     * @brief Paints strips into bitmaps kept by the DC.
+     */
+    virtual bool DoBeginStrip( gxStrip       &aStrip,
+                               gxRect const  &aRect,
+                               gxPoint const &aShift,
+                               gxRect const  &aExposed );
+
+    virtual void DoEndStrip();
+
     void DrawRotatedText( gxString &aText,
                           gxPix  aX,
                           gxPix  aY,
                           double aAngle);
 
+    /**
+     * @brief Returns the size of a text, from the {@link gxTextCache text
+     * cache} if measured before.
+     */
     virtual gxSize GetTextSize( gxString &aText );
 protected:
-    virtual void IntersectClipArea( gxRect const &aRect );
+    virtual void IntersectClipArea( gxFixedRect const &aRect );
 private:
     /// The painting DC
     gxPaintDC *mDc;
-    gxRects   mDamagedRects;
+    gxRectBatch mDamagedRects;
+
+    /// The font of the DC, text sizes are cached by.
+    gxFontId  mFontId;
 };
 
 #endif // gxDcPainter_h
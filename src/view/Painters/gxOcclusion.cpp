@@ -0,0 +1,106 @@
+#include "View/Painters/gxOcclusion.h"
+
+// Returns whether or not a rect covers another one entirely. (Unlike
+// gxRect::Contains(), which takes the bottom-right corner as outside.)
+static bool Covers( const gxRect& aRect,
+                    const gxRect& aOther )
+{
+    return aOther.GetLeft()   >= aRect.GetLeft()  &&
+           aOther.GetTop()    >= aRect.GetTop()   &&
+           aOther.GetRight()  <= aRect.GetRight() &&
+           aOther.GetBottom() <= aRect.GetBottom();
+}
+
+// Returns the intersection of two rects. (Unlike gxRect::Intersect(), which
+// adds the bottom-right corner, a pixel past both.)
+static gxRect Intersect( const gxRect& aRect,
+                         const gxRect& aOther )
+{
+    gxPix iLeft   = gxMax( aRect.GetLeft(),   aOther.GetLeft() );
+    gxPix iTop    = gxMax( aRect.GetTop(),    aOther.GetTop() );
+    gxPix iRight  = gxMin( aRect.GetRight(),  aOther.GetRight() );
+    gxPix iBottom = gxMin( aRect.GetBottom(), aOther.GetBottom() );
+
+    if ( iRight <= iLeft || iBottom <= iTop )
+        return gxRect();
+
+    return gxRect( iLeft, iTop, iRight - iLeft, iBottom - iTop );
+}
+
+gxOcclusion::gxOcclusion() :
+    mDetailSize( 0 )
+{
+    mClipAreas.push_back( gxRect() );
+}
+
+void gxOcclusion::Reset( const gxRect&  aArea,
+                         const gxRects& aDamagedRects )
+{
+    mDamagedRects.Assign( aDamagedRects );
+
+    mClipAreas.clear();
+    mClipAreas.push_back( aArea );
+
+    mOccluders.clear();
+    mGrid.Clear();
+    mOccluded.clear();
+}
+
+bool gxOcclusion::NeedsPainting( const gxRect& aRect ) const
+{
+    if ( aRect.IsEmpty() )
+        return false;
+
+    return mDamagedRects.IntersectsAny( aRect );
+}
+
+bool gxOcclusion::Covers( const gxRect& aRect ) const
+{
+    if ( mOccluders.empty() )
+        return false;
+
+    // An occluder covering the rect covers its top-left corner too, so only
+    // the cell of the corner needs looking into.
+    mIds.clear();
+    mGrid.Query( gxRect( aRect.X, aRect.Y, 1, 1 ), mIds );
+
+    for ( unsigned int i = 0; i < mIds.size(); i++ )
+    {
+        if ( ::Covers( mOccluders[ mIds[i] ], aRect ) )
+            return true;
+    }
+
+    return false;
+}
+
+gxRect gxOcclusion::Clip( const gxRect& aRect ) const
+{
+    return ::Intersect( aRect, GetClipArea() );
+}
+
+void gxOcclusion::AddOccluder( const gxRect& aRect )
+{
+    gxRect iRect = Clip( aRect );
+
+    // Nothing seen of it, or covered already.
+    if ( iRect.IsEmpty() || Covers( iRect ) )
+        return;
+
+    mGrid.Insert( (int)mOccluders.size(), iRect );
+    mOccluders.push_back( iRect );
+}
+
+void gxOcclusion::PushClipArea( const gxRect& aRect )
+{
+    mClipAreas.push_back( Clip( aRect ) );
+}
+
+void gxOcclusion::PopClipArea()
+{
+    mClipAreas.pop_back();
+}
+
+void gxOcclusion::SetOccluded( const gxViewElement* aElement )
+{
+    mOccluded.insert( aElement );
+}
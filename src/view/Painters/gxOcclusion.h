@@ -0,0 +1,118 @@
+#ifndef gxOcclusion_h
+#define gxOcclusion_h
+
+#include "core/geometry/gxRect.h"
+#include "core/geometry/gxRectBatch.h"
+#include "core/geometry/gxSpatialGrid.h"
+
+#include <unordered_set>
+#include <vector>
+
+// Forward declaration
+class gxViewElement;
+
+/**
+ * @brief The region covered by opaque view elements, and the view elements
+ * it hides, for painting.
+ *
+ * Before painting, the view element hierarchy is traversed front to back
+ * (see {@link gxViewElement::Occlude()}): each {@link gxVisual::SetOpaque()
+ * opaque} visual adds its bounds to the region once its children have been
+ * visited, and view elements found entirely covered by what was added before
+ * them (that is, by what is painted over them) are marked occluded. Painting
+ * then leaves occluded view elements out, along with all their children.
+ *
+ * A rect counts as covered when a single occluder covers it; all rects are
+ * absolute (in control coordinates).
+ */
+class gxOcclusion
+{
+public:
+    gxOcclusion();
+
+    /**
+     * @brief Clears the region, ready for a new pass.
+     *
+     * @param aArea The area that can be seen (the control bounds).
+     * @param aDamagedRects The rects about to be painted; view elements
+     *        outside them are neither occluders nor occluded.
+     */
+    void Reset( const gxRect&  aArea,
+                const gxRects& aDamagedRects );
+
+    /**
+     * @brief Returns the on-screen size below which view elements are painted
+     * with less detail, and so don't occlude (0 for always in full).
+     */
+    gxPix GetDetailSize() const { return mDetailSize; }
+
+    void SetDetailSize( gxPix aDetailSize ) { mDetailSize = aDetailSize; }
+
+    /**
+     * @brief Returns whether or not a rect is about to be painted (intersects
+     * the damaged rects).
+     */
+    bool NeedsPainting( const gxRect& aRect ) const;
+
+    /**
+     * @brief Returns whether or not a rect is entirely covered by the region
+     * (as built so far).
+     */
+    bool Covers( const gxRect& aRect ) const;
+
+    /**
+     * @brief Adds an opaque rect to the region, clipped to the current clip
+     * area.
+     */
+    void AddOccluder( const gxRect& aRect );
+
+    /**
+     * @brief Returns the current clip area, which all that is visited is
+     * painted within.
+     */
+    const gxRect& GetClipArea() const { return mClipAreas.back(); }
+
+    /**
+     * @brief Returns the part of a rect within the clip area.
+     */
+    gxRect Clip( const gxRect& aRect ) const;
+
+    /**
+     * @brief Intersects the clip area with a rect, for the children of a
+     * view element clipping them.
+     */
+    void PushClipArea( const gxRect& aRect );
+
+    void PopClipArea();
+
+    /**
+     * @brief Marks a view element as occluded, so it isn't painted.
+     */
+    void SetOccluded( const gxViewElement* aElement );
+
+    /**
+     * @brief Returns whether or not a view element was found occluded.
+     */
+    bool IsOccluded( const gxViewElement* aElement ) const
+    {
+        return !mOccluded.empty() && mOccluded.count( aElement ) > 0;
+    }
+
+    /**
+     * @brief Returns the number of rects in the region.
+     */
+    unsigned long GetOccluderCount() const { return mOccluders.size(); }
+
+private:
+    gxRectBatch                                 mDamagedRects;
+    gxRects                                     mClipAreas;
+    gxRects                                     mOccluders;
+    gxSpatialGrid                               mGrid;
+    std::unordered_set< const gxViewElement* >  mOccluded;
+    gxPix                                       mDetailSize;
+
+    // Reused by Covers(), to save allocating per query
+    mutable std::vector< int >                  mIds;
+};
+
+#endif //gxOcclusion_h
@@ -0,0 +1,135 @@
+#ifndef gxPaintStats_h
+#define gxPaintStats_h
+
+#ifdef GX_PAINT_STATS
+    #include <chrono>
+#endif
+
+/**
+ * @brief What a frame took to paint, so slow frames can be told apart.
+ *
+ * Statistics are only collected when built with GX_PAINT_STATS defined, and
+ * then only while {@link gxLightweightSystem::SetPaintStatsEnabled()
+ * enabled}. Otherwise the counting compiles away, and all stay 0.
+ */
+struct gxPaintStats
+{
+public:
+    gxPaintStats() { Reset(); }
+
+    /**
+     * @brief Sets all statistics to 0.
+     */
+    void Reset()
+    {
+        visited        = 0;
+        culled         = 0;
+        occluded       = 0;
+        painted        = 0;
+        simplified     = 0;
+        rectangles     = 0;
+        lines          = 0;
+        texts          = 0;
+        statePushes    = 0;
+        clipChanges    = 0;
+        damagedRects   = 0;
+        damagedArea    = 0;
+        inputTime      = 0;
+        validationTime = 0;
+        damageTime     = 0;
+        paintTime      = 0;
+    }
+
+    /// The view elements asked to paint, those left out as they didn't need
+    /// painting (of which those covered by opaque ones), and those painted
+    /// (of which those painted with less than full detail).
+    unsigned long visited;
+    unsigned long culled;
+    unsigned long occluded;
+    unsigned long painted;
+    unsigned long simplified;
+
+    /// The primitives drawn, by type.
+    unsigned long rectangles;
+    unsigned long lines;
+    unsigned long texts;
+
+    /// The painter states pushed, and the changes of the clip area.
+    unsigned long statePushes;
+    unsigned long clipChanges;
+
+    /// The damaged rects painted, and their total area in pixels.
+    unsigned long damagedRects;
+    unsigned long damagedArea;
+
+    /// The wall time of each frame phase, in milliseconds.
+    double inputTime;
+    double validationTime;
+    double damageTime;
+    double paintTime;
+};
+
+/**
+ * @brief Counts a statistic, if collecting.
+ *
+ * @param aStats The statistics being collected, or NULL if not collecting.
+ * @param aCounter The {@link gxPaintStats} member to increase.
+ */
+#ifdef GX_PAINT_STATS
+    #define gxPaintStat( aStats, aCounter ) ( ( aStats ) ? ( void )++( aStats )->aCounter : ( void )0 )
+#else
+    #define gxPaintStat( aStats, aCounter ) ( ( void )0 )
+#endif
+
+/**
+ * @brief Times the phases of a frame.
+ *
+ * Each Lap() adds the time since the clock started, or since the previous
+ * lap, to a phase.
+ */
+class gxPaintClock
+{
+public:
+    /**
+     * @param aStats The statistics being collected, or NULL if not
+     *        collecting.
+     */
+    gxPaintClock( gxPaintStats *aStats )
+#ifdef GX_PAINT_STATS
+      : mStats( aStats )
+    {
+        if ( mStats )
+            mLast = Clock::now();
+    }
+#else
+    {}
+#endif
+
+    /**
+     * @brief Adds the time since the last lap to a phase.
+     *
+     * @param aPhase The {@link gxPaintStats} phase member, say
+     *        &gxPaintStats::paintTime.
+     */
+    void Lap( double gxPaintStats::*aPhase )
+    {
+#ifdef GX_PAINT_STATS
+        if ( !mStats )
+            return;
+
+        Clock::time_point iNow = Clock::now();
+        mStats->*aPhase += std::chrono::duration<double, std::milli>( iNow - mLast ).count();
+        mLast = iNow;
+#endif
+    }
+
+private:
+#ifdef GX_PAINT_STATS
+    typedef std::chrono::steady_clock Clock;
+
+    gxPaintStats      *mStats;
+    Clock::time_point  mLast;
+#endif
+};
+
+#endif //gxPaintStats_h
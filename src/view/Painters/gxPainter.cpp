@@ -3,44 +3,42 @@
 #include "core/gxLog.h"
 
 gxPainter::gxPainter()
-  : mRelative(true)
+  : mRelative(true),
+    mPaintInvalid(true),
+    mStats(NULL),
+    mOcclusion(NULL),
+    mDetailSize(0),
+    mPaintProxies(true)
 {
 }
 
 void gxPainter::SetTranslate( gxPoint aDelta )
 {
-    if ( ScaleNeeded() )
-    {
-        // Take into account any scaling that is in force.
-        // Say the value given is (40,40), with a scale set to 2 the resultant
-        // position will be (80,80). Makes sense innit?
-        mTrans.Translate += aDelta * mTrans.Scale;
-    } else {
-        mTrans.Translate += aDelta;
-    }
+    // The matrix takes into account any scaling that is in force.
+    // Say the value given is (40,40), with a scale set to 2 the resultant
+    // position will be (80,80). Makes sense innit?
+    mTrans.Matrix.Translate( gxToFixed( aDelta ) );
 }
 
 void gxPainter::SetScroll( gxPoint aScroll )
 {
-    if ( ScaleNeeded() )
-    {
-        // Take into account any scaling that is in force.
-        // Say the value given is (40,40), with a scale set to 2 the resultant
-        // position will be (80,80). Makes sense innit?
-        mTrans.Scroll += aScroll * mTrans.Scale;
-    } else {
-        mTrans.Scroll += aScroll;
-    }
+    // Take into account any scaling that is in force, as with SetTranslate().
+    gxFixedPoint iScroll = mTrans.Matrix.TransformVector( gxToFixed( aScroll ) );
+
+    mTrans.Matrix.PostTranslate( -iScroll );
+    mTrans.Scroll += iScroll;
 }
 
 void gxPainter::SetScale( gxScale const &aScale )
 {
     // We multiply the current scale with the new one.
-    mTrans.Scale *= aScale;
+    mTrans.Matrix.Scale( aScale );
 }
 
 void gxPainter::PushState()
 {
+    gxPaintStat( mStats, statePushes );
+
     gxPainterState *iState = new gxPainterState();
 
     iState->transformations = mTrans;
@@ -79,40 +77,34 @@ void gxPainter::RestoreState( gxPainterState *aState )
     mTrans    = aState->transformations;
     mRelative = aState->relative;
 
+    gxPaintStat( mStats, clipChanges );
     SetAbsoluteClipArea( aState->clipArea );
 }
 
 void gxPainter::SetClipArea( gxRect const &aRect )
 {
     // Transforms the rect, taking into account trnaslation, scale, etc.
-    gxRect iTransformedRect( aRect );
+    gxFixedRect iTransformedRect = gxToFixed( aRect );
     Transform( iTransformedRect );
   
+    gxPaintStat( mStats, clipChanges );
     IntersectClipArea( iTransformedRect );
 }
 
-void gxPainter::Transform( gxRect &aRect )
+void gxPainter::Transform( gxFixedRect &aRect )
 {
-    if ( ScaleNeeded() )
-        aRect.Scale( mTrans.Scale );
-
-    if ( TranslateNeeded() )
-        aRect += mTrans.Translate;
-
-    if ( ScrollNeeded() )
-        aRect -= mTrans.Scroll;
+    mTrans.Matrix.Apply( aRect );
 }
 
-void gxPainter::Transform( gxPoint &aPoint )
+void gxPainter::Transform( gxFixedPoint &aPoint )
 {
-    if ( ScaleNeeded() )
-        aPoint *= mTrans.Scale;
-
-    if ( TranslateNeeded() )
-        aPoint += mTrans.Translate;
+    mTrans.Matrix.Apply( aPoint );
+}
 
-    if ( ScrollNeeded() )
-        aPoint -= mTrans.Scroll;
+void gxPainter::Transform( gxFixedPoint *aPoints,
+                           size_t       aCount )
+{
+    mTrans.Matrix.Apply( aPoints, aCount );
 }
 
 bool gxPainter::IsRelative()
@@ -126,8 +118,8 @@ void gxPainter::SetRelative( bool aRelative )
     // transformations.
     if ( !aRelative )
     {
-        mTrans.Scale.Reset();
-        mTrans.Translate.Reset();
+        mTrans.Matrix.Reset();
+        mTrans.Matrix.PostTranslate( -mTrans.Scroll );
     }
 
     mRelative = aRelative;
@@ -161,8 +153,11 @@ void gxPainter::DrawRectangle( gxPix aX,
 
 void gxPainter::DrawRectangle( gxRect aRect )
 {
-    Transform( aRect );
-    DoDrawRectangle( aRect );
+    gxPaintStat( mStats, rectangles );
+
+    gxFixedRect iRect = gxToFixed( aRect );
+    Transform( iRect );
+    DoDrawRectangle( iRect );
 }
 
 void gxPainter::DrawLine( gxRect aRect )
@@ -181,9 +176,34 @@ void gxPainter::DrawLine( gxPix x1,
 void gxPainter::DrawLine( gxPoint aFrom,
                           gxPoint aTo )
 {
-    Transform( aFrom );
-    Transform( aTo );
-    DoDrawLine( aFrom, aTo );
+    gxPaintStat( mStats, lines );
+
+    gxFixedPoint iFrom = gxToFixed( aFrom );
+    gxFixedPoint iTo   = gxToFixed( aTo );
+    Transform( iFrom );
+    Transform( iTo );
+    DoDrawLine( iFrom, iTo );
+}
+
+void gxPainter::DrawLines( gxPoint const *aPoints,
+                           size_t        aCount )
+{
+    if ( aCount < 2 )
+        return;
+
+    // All the points are transformed at once.
+    mPoints.resize( aCount );
+
+    for ( size_t i = 0; i < aCount; i++ )
+        mPoints[i] = gxToFixed( aPoints[i] );
+
+    Transform( &mPoints[0], aCount );
+
+    for ( size_t i = 1; i < aCount; i++ )
+    {
+        gxPaintStat( mStats, lines );
+        DoDrawLine( mPoints[ i - 1 ], mPoints[i] );
+    }
 }
 
 void gxPainter::DrawText( gxString &aText,
@@ -191,7 +211,9 @@ void gxPainter::DrawText( gxString &aText,
                           gxPix    aY,
                           double   aAngle )
 {
-    gxPoint iPoint( aX, aY );
+    gxPaintStat( mStats, texts );
+
+    gxFixedPoint iPoint( aX, aY );
     Transform( iPoint );
     DoDrawText( aText, iPoint.X , iPoint.Y, aAngle );
 }
@@ -203,21 +225,93 @@ void gxPainter::DrawText( gxString &aText,
                           gxPix    aPadY,
                           bool     isHorizontal )
 {
-    gxPoint iPoint = isHorizontal ? gxPoint( aX, aY ) : gxPoint( aY, aX );
+    gxPaintStat( mStats, texts );
+
+    gxFixedPoint iPoint = isHorizontal ? gxFixedPoint( aX, aY ) : gxFixedPoint( aY, aX );
     
     Transform( iPoint );
     
     iPoint.X += aPadX;
     iPoint.Y += aPadY;
     
-    if ( isHorizontal )
+    if ( !isHorizontal )
     {
-        DoDrawText( aText, iPoint.X , iPoint.Y );
-    } else {
         // Text rotation is done with the top left point as origion,
         // so make the old top right the new top left
         iPoint.Y = iPoint.Y + GetTextSize( aText ).X;
         iPoint.X += 3; //TODO: remove hack
-        DoDrawText( aText, iPoint.X , iPoint.Y, 90 );
     }
+
+    DoDrawLabel( aText, iPoint.X , iPoint.Y, isHorizontal );
+}
+
+bool gxPainter::BeginStrip( gxStrip      &aStrip,
+                            gxRect const &aRect,
+                            bool         isHorizontal,
+                            gxPix        &aFrom,
+                            gxPix        &aTo )
+{
+    // Strips keep device pixels, so are laid out in whole pixels.
+    gxFixedRect iFixedRect = gxToFixed( aRect );
+    Transform( iFixedRect );
+
+    gxRect iRect = gxToPix( iFixedRect );
+
+    if ( iRect.IsEmpty() )
+        return false;
+
+    // Where the strip is from the painting origin, which doesn't move as the
+    // strip scrolls.
+    gxFixedPoint iFixedOrigin( 0, 0 );
+    Transform( iFixedOrigin );
+
+    gxPoint iOrigin = gxToPix( iFixedOrigin );
+
+    gxPix iOffset = isHorizontal ? iRect.X - iOrigin.X : iRect.Y - iOrigin.Y;
+    gxPix iLength = isHorizontal ? iRect.width : iRect.height;
+
+    // How much the pixels kept move along the strip, and the span exposed.
+    gxPix iShift = aStrip.mOffset - iOffset;
+    gxPix iFrom  = 0;
+    gxPix iTo    = iLength;
+
+    if ( !aStrip.mValid ||
+         aStrip.mSize != iRect.GetSize() ||
+         iShift >= iLength || -iShift >= iLength )
+    {
+        iShift = 0;
+    }
+    else if ( iShift > 0 )
+    {
+        iTo = iShift;
+    }
+    else
+    {
+        iFrom = iLength + iShift;
+    }
+
+    gxRect  iExposed = isHorizontal ?
+                       gxRect( iRect.X + iFrom, iRect.Y, iTo - iFrom, iRect.height ) :
+                       gxRect( iRect.X, iRect.Y + iFrom, iRect.width, iTo - iFrom );
+    gxPoint iShiftBy = isHorizontal ? gxPoint( iShift, 0 ) : gxPoint( 0, iShift );
+
+    if ( !DoBeginStrip( aStrip, iRect, iShiftBy, iExposed ) )
+    {
+        aStrip.Invalidate();
+        return false;
+    }
+
+    aStrip.mValid  = true;
+    aStrip.mSize   = iRect.GetSize();
+    aStrip.mOffset = iOffset;
+
+    aFrom = iOffset + iFrom;
+    aTo   = iOffset + iTo;
+
+    return true;
+}
+
+void gxPainter::EndStrip()
+{
+    DoEndStrip();
 }
@@ -3,14 +3,18 @@
 
 #include "core/gxObject.h"
 #include "core/gxString.h"
+#include "core/gxStrip.h"
 #include "core/geometry/gxGeometry.h"
 #include "View/gxTransformations.h"
+#include "View/Painters/gxPaintStats.h"
 
 #include <stack>
+#include <vector>
 
 
-// Forward declaration
+// Forward declarations
 class gxPainterState;
+class gxOcclusion;
 
 typedef std::stack< gxPainterState* > StateStack;
 
@@ -133,6 +137,15 @@ public:
                    gxPoint aTo );
     
     void DrawLine( gxRect aRect );
+
+    /**
+    * @brief Draws lines through an array of points (a polyline), transforming
+    * the points at once.
+    * @param aPoints The points.
+    * @param aCount The number of points.
+    */
+    void DrawLines( gxPoint const *aPoints,
+                    size_t        aCount );
     
     // Text
     void DrawText( gxString &aText,
@@ -158,17 +171,90 @@ public:
                    bool     isHorizontal = true );
     
     // Abstract drawing methods.
-    // These should be implemented by subclasses.
-    virtual void DoDrawRectangle( gxRect const &aRect ) = 0;
+    // These should be implemented by subclasses, and are given transformed
+    // geometry in fixed point, for them to convert to device pixels.
+    virtual void DoDrawRectangle( gxFixedRect const &aRect ) = 0;
     
-    virtual void DoDrawLine( gxPoint &aFrom,
-                             gxPoint &aTo ) = 0;
+    virtual void DoDrawLine( gxFixedPoint &aFrom,
+                             gxFixedPoint &aTo ) = 0;
     
     virtual void DoDrawText( gxString &aText,
-                             gxPix    &aX,
-                             gxPix    &aY,
+                             gxFixed  &aX,
+                             gxFixed  &aY,
                              double   aAngle = 0 ) = 0;
+
+    /**
+    * @brief Draws a label, like those of rulers, which are drawn again and
+    * again.
+    *
+    * By default this draws the text; painters may draw labels rendered
+    * before instead.
+    * @param aText The label.
+    * @param aX The X position.
+    * @param aY The Y position.
+    * @param isHorizontal Whether the label is horizontal, or rotated by 90
+    * degrees about the position.
+    */
+    virtual void DoDrawLabel( gxString &aText,
+                              gxFixed  &aX,
+                              gxFixed  &aY,
+                              bool     isHorizontal )
+    {
+        DoDrawText( aText, aX, aY, isHorizontal ? 0 : 90 );
+    }
     
+    /**
+    * @brief Starts painting into a {@link gxStrip strip}, rather than on the
+    * canvas.
+    *
+    * The pixels cached in the strip are first shifted by how much the strip
+    * moved along its axis (relative to the painting origin, i.e. scrolled);
+    * only the span exposed by the shift then needs painting, and painting is
+    * clipped to it. Painting ends with EndStrip(), which draws the strip on
+    * the canvas.
+    * @param aStrip The strip.
+    * @param aRect The rect the strip covers (which is relative).
+    * @param isHorizontal Whether the strip scrolls along its width, or its
+    * height.
+    * @param aFrom Receives where the exposed span starts along the axis, in
+    * on-screen pixels from the painting origin.
+    * @param aTo Receives where the exposed span ends (the same as aFrom if
+    * nothing is exposed).
+    * @return False if strips aren't painted into, in which case paint on the
+    * canvas as usual (and don't call EndStrip()).
+    */
+    bool BeginStrip( gxStrip      &aStrip,
+                     gxRect const &aRect,
+                     bool         isHorizontal,
+                     gxPix        &aFrom,
+                     gxPix        &aTo );
+
+    /**
+    * @brief Ends painting into a strip, drawing it on the canvas.
+    */
+    void EndStrip();
+
+    // Strip methods, to be implemented by painters caching strips.
+
+    /**
+    * @brief Starts painting into the pixels of a strip.
+    * @param aStrip The strip.
+    * @param aRect The absolute rect the strip covers.
+    * @param aShift How much to shift the pixels kept.
+    * @param aExposed The absolute rect to be painted.
+    * @return Whether or not the strip is painted into. By default, strips
+    * aren't.
+    */
+    virtual bool DoBeginStrip( gxStrip       &aStrip,
+                               gxRect const  &aRect,
+                               gxPoint const &aShift,
+                               gxRect const  &aExposed )
+    {
+        return false;
+    }
+
+    virtual void DoEndStrip() {}
+
     /**
     * @brief Returns the size of the given text.
     * @param aText The text whose size we enquire.
@@ -184,6 +270,83 @@ public:
     bool IsRelative();
     
     void SetRelative( bool aRelative );
+    
+    /**
+     * @brief Returns whether or not invalid view elements are painted (they
+     * are by default).
+     */
+    bool IsPaintingInvalid() const { return mPaintInvalid; }
+    
+    /**
+     * @brief Sets whether or not invalid view elements are painted.
+     *
+     * While validation is done in slices, invalid view elements may not be
+     * laid out yet, so are better left out until validated.
+     */
+    void SetPaintInvalid( bool aPaintInvalid ) { mPaintInvalid = aPaintInvalid; }
+
+    /**
+     * @brief Returns the on-screen size below which view elements are painted
+     * with less detail (see {@link gxVisual::GetDetail()}), or 0 if they are
+     * always painted in full (the default).
+     */
+    gxPix GetDetailSize() const { return mDetailSize; }
+
+    /**
+     * @brief Sets the on-screen size below which view elements are painted
+     * with less detail.
+     * @param aDetailSize The size in pixels, or 0 to always paint in full.
+     */
+    void SetDetailSize( gxPix aDetailSize ) { mDetailSize = aDetailSize; }
+
+    /**
+     * @brief Returns whether or not view elements painted with less detail
+     * are painted as proxies (they are by default), rather than left out.
+     */
+    bool IsPaintingProxies() const { return mPaintProxies; }
+
+    void SetPaintProxies( bool aPaintProxies ) { mPaintProxies = aPaintProxies; }
+
+    /**
+     * @brief Returns the on-screen size of a (relative) size, taking into
+     * account the scale in force.
+     * @param aSize The size.
+     */
+    gxSize GetScreenSize( gxSize const &aSize ) const
+    {
+        gxScale iScale = mTrans.Matrix.GetScale();
+
+        return gxSize( gxPix( aSize.X * iScale.X ),
+                       gxPix( aSize.Y * iScale.Y ) );
+    }
+
+    /**
+     * @brief Returns the statistics being collected, or NULL if not
+     * collecting (the default).
+     */
+    gxPaintStats* GetStats() const { return mStats; }
+
+    /**
+     * @brief Sets the statistics to collect painting into (see {@link
+     * gxPaintStats}).
+     * @param aStats The statistics, or NULL to stop collecting.
+     */
+    void SetStats( gxPaintStats *aStats ) { mStats = aStats; }
+
+    /**
+     * @brief Returns the region covered by opaque view elements, of which
+     * occluded view elements aren't painted, or NULL if not culling occluded
+     * view elements (the default).
+     */
+    gxOcclusion* GetOcclusion() const { return mOcclusion; }
+
+    /**
+     * @brief Sets the region covered by opaque view elements (see {@link
+     * gxOcclusion}).
+     * @param aOcclusion The region, built for the rects being painted, or
+     *        NULL to paint all.
+     */
+    void SetOcclusion( gxOcclusion *aOcclusion ) { mOcclusion = aOcclusion; }
 protected:
     /**
     * @brief Performs state restoration.  
@@ -192,22 +355,31 @@ protected:
 
     /**
     * @brief Intersects the current clip area with a new rectangle.
-    * @param aRect The absolute coordinates of the rect to intersect.
+    * @param aRect The absolute coordinates of the rect to intersect, in fixed
+    * point.
     */
-    virtual void IntersectClipArea( gxRect const &aRect ) = 0;
+    virtual void IntersectClipArea( gxFixedRect const &aRect ) = 0;
 
     /**
-    * @brief Transforms a {@link gxRect}, taking into account translate, scale
-    * , etc.
+    * @brief Transforms a {@link gxFixedRect}, taking into account translate,
+    * scale, etc.
     * @param aRect The rect to transform.
     */
-    virtual void Transform( gxRect &aRect );
+    virtual void Transform( gxFixedRect &aRect );
 
     /**
-    * @brief Transfroms a {@link gxPoint).
+    * @brief Transfroms a {@link gxFixedPoint).
     * @param aPoint The point to transform.
     */
-    virtual void Transform( gxPoint &aPoint );
+    virtual void Transform( gxFixedPoint &aPoint );
+
+    /**
+    * @brief Transforms an array of {@link gxFixedPoint points} at once.
+    * @param aPoints The points to transform.
+    * @param aCount The number of points.
+    */
+    void Transform( gxFixedPoint *aPoints,
+                    size_t       aCount );
 
     bool TranslateNeeded();
     bool ScaleNeeded();
@@ -221,6 +393,24 @@ protected:
     /// Whether or not painting is based on relative positioning (absolute
     /// positioning otherwise.
     bool              mRelative;
+    
+    /// Whether or not invalid view elements are painted.
+    bool              mPaintInvalid;
+
+    /// The statistics being collected, if any.
+    gxPaintStats     *mStats;
+
+    /// The region covered by opaque view elements, if culling those occluded.
+    gxOcclusion      *mOcclusion;
+
+    /// Reused by DrawLines(), for the transformed points.
+    std::vector< gxFixedPoint > mPoints;
+
+    /// The on-screen size below which view elements are painted with less
+    /// detail (0 for always in full), and whether they are then painted as
+    /// proxies.
+    gxPix             mDetailSize;
+    bool              mPaintProxies;
 };
 
 #endif // gxPainter_h
\ No newline at end of file
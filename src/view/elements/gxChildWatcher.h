@@ -0,0 +1,38 @@
+#ifndef gxChildWatcher_h
+#define gxChildWatcher_h
+
+// Forward declarations
+class gxViewElement;
+
+/**
+ * @brief Told of changes to the children of a view element, as they happen
+ * (see {@link gxViewElement::SetChildWatcher()}).
+ *
+ * Unlike invalidation, which only bubbles up from a child once until it's
+ * validated, a watcher is told of every change. Watchers typically collect
+ * the children changed, and handle them all once the view element
+ * validates.
+ */
+class gxChildWatcher
+{
+public:
+    virtual ~gxChildWatcher() {}
+
+    /**
+     * @brief Called when a child was added, moved, resized, shown or hidden.
+     */
+    virtual void OnChildChanged( gxViewElement* aChild ) = 0;
+
+    /**
+     * @brief Called when a child is about to be removed (or deleted).
+     */
+    virtual void OnChildRemoved( gxViewElement* aChild ) = 0;
+
+    /**
+     * @brief Called when the view element starts validating, before its
+     * children.
+     */
+    virtual void OnValidate() {}
+};
+
+#endif //gxChildWatcher_h
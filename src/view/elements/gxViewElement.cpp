@@ -2,10 +2,12 @@
 #include "View/gxLightweightSystem.h"
 #include "core/gxAssert.h"
 #include "core/gxLog.h"
+#include "core/gxTrace.h"
 
 gxViewElement::gxViewElement():
     mFlags( Visible | ClipChildren ),
-    mValid( Invalid )
+    mValid( Invalid ),
+    mChildWatcher( NULL )
 {
 }
 
@@ -36,7 +38,7 @@ gxLightweightSystem* gxViewElement::GetLightweightSystem() const
     return iLws;
 }
 
-void gxViewElement::TransformToAbsolute( gxRect& aRect )
+void gxViewElement::TransformToAbsolute( gxFixedRect& aRect )
 {
     gxViewElement* iParent = GetParent();
     
@@ -49,6 +51,14 @@ void gxViewElement::TransformToAbsolute( gxRect& aRect )
     iParent->TransformToAbsolute( aRect );
 }
 
+void gxViewElement::TransformToAbsolute( gxRect& aRect )
+{
+    gxFixedRect iRect = gxToFixed( aRect );
+    TransformToAbsolute( iRect );
+
+    aRect = gxToPix( iRect );
+}
+
 void gxViewElement::TransformToLocal( gxRect& aRect )
 {
     // A hackish way of doing transform to local:
@@ -62,9 +72,17 @@ void gxViewElement::TransformToLocal( gxRect& aRect )
     aRect -= iOffset.GetPosition();
 }
 
+void gxViewElement::Transform( gxFixedRect& aRect )
+{
+    aRect += gxToFixed( GetBounds().GetPosition() );
+}
+
 void gxViewElement::Transform( gxRect& aRect )
 {
-    aRect += GetBounds().GetPosition();
+    gxFixedRect iRect = gxToFixed( aRect );
+    Transform( iRect );
+
+    aRect = gxToPix( iRect );
 }
 
 void gxViewElement::Erase()
@@ -226,8 +244,23 @@ void gxViewElement::InvalidateDown()
     }
 }
 
-void gxViewElement::Validate()
+void gxViewElement::Validate( gxDeadline* aDeadline )
+{
+    // Validating in slices, frames are painted in between, leaving out
+    // invalid elements - which are painted in once valid.
+    Validate( aDeadline, aDeadline != NULL );
+}
+
+void gxViewElement::Validate( gxDeadline* aDeadline,
+                              bool        aRepaint )
 {
+    gxTraceScope( "validate", typeid( *this ), this );
+
+    // Let the watcher handle the children changed since the last
+    // validation, before they validate.
+    if ( mChildWatcher )
+        mChildWatcher->OnValidate();
+
     // Keep whether I was invalid before validating the children.
     bool iWasInvalid = IsInvalid();
     
@@ -236,6 +269,8 @@ void gxViewElement::Validate()
     // setting this view element to invalid.
     MarkValid();
     
+    // If I'm repainted once validated, so are the children I clip.
+    bool iRepaintChildren = aRepaint && !( iWasInvalid && IsClippingChildren() );
     
     Iterator iChildren( GetChildren() );
     
@@ -245,7 +280,22 @@ void gxViewElement::Validate()
     for ( iChildren.First(); iChildren.Current(); iChildren.Next() )
     {
         if ( iChildren.Current()->IsntValid() )
-            iChildren.Current()->Validate();
+        {
+            iChildren.Current()->Validate( aDeadline, iRepaintChildren );
+            
+            // Out of time - leave the rest for the next validation, which
+            // needs to travel down to here again (and validate me if I was
+            // invalid).
+            if ( aDeadline && aDeadline->HasPassed() )
+            {
+                if ( iWasInvalid )
+                    MarkInvalid();
+                else if ( IsValid() )
+                    mValid = Trace;
+                
+                return;
+            }
+        }
     }
 
     // If I was invalid before validating the descendants, and if I'm not
@@ -256,9 +306,29 @@ void gxViewElement::Validate()
     {
         DoValidate();
         Layout();
+
+        if ( aRepaint )
+            Repaint();
     }
 }
 
+unsigned long gxViewElement::CountInvalid()
+{
+    if ( IsValid() )
+        return 0;
+    
+    unsigned long iCount = IsInvalid() ? 1 : 0;
+    
+    Iterator iChildren( GetChildren() );
+    
+    for ( iChildren.First(); iChildren.Current(); iChildren.Next() )
+    {
+        iCount += iChildren.Current()->CountInvalid();
+    }
+    
+    return iCount;
+}
+
 void gxViewElement::MarkInvalid()
 {
     mValid = Invalid;
@@ -289,6 +359,25 @@ bool gxViewElement::IsntInvalid()
     return mValid != Invalid;
 }
 
+void gxViewElement::Occlude( gxOcclusion& aOcclusion )
+{
+    if ( !IsVisible() )
+        return;
+
+    OccludeChildren( aOcclusion );
+}
+
+void gxViewElement::OccludeChildren( gxOcclusion& aOcclusion )
+{
+    // Children are painted first to last, so the last is the front-most.
+    List* iChildren = GetChildren();
+
+    for ( List::reverse_iterator iChild = iChildren->rbegin(); iChild != iChildren->rend(); ++iChild )
+    {
+        ( *iChild )->Occlude( aOcclusion );
+    }
+}
+
 bool gxViewElement::IsVisible()
 {
     return mFlags.IsSet( Visible );
@@ -304,6 +393,7 @@ void gxViewElement::SetVisible( bool const aVisible )
     else
         mFlags.Unset( Visible );
 
+    NotifyChanged();
     Invalidate();
     Repaint();
 }
@@ -333,12 +423,17 @@ bool gxViewElement::IsClippingChildren()
 
 void gxViewElement::OnAddChild( gxViewElement* aChild )
 {
+    NotifyChildChanged( aChild );
+
     aChild->Invalidate();
     aChild->Repaint();
 }
 
 void gxViewElement::OnBeforeChildRemoval( gxViewElement* aChild )
 {
+    if ( mChildWatcher )
+        mChildWatcher->OnChildRemoved( aChild );
+
     // We need revalidation as the deletion of a child might affect layouts etc.
     aChild->Invalidate();
     
@@ -354,6 +449,25 @@ void gxViewElement::OnAfterChildRemoval()
 {
 }
 
+void gxViewElement::NotifyChanged()
+{
+    if ( GetParent() )
+        GetParent()->NotifyChildChanged( this );
+}
+
+void gxViewElement::NotifyChildChanged( gxViewElement* aChild )
+{
+    if ( !mChildWatcher )
+        return;
+
+    mChildWatcher->OnChildChanged( aChild );
+
+    // The child doesn't bubble up if it's invalid already (a new child is),
+    // yet the watcher handles changes on validation.
+    if ( IsValid() )
+        InvalidateUp( aChild, Trace );
+}
+
 gxLayout* gxViewElement::GetLayout()
 {
     // As only gxVisual has layouts, this returns NULL by default.
@@ -4,8 +4,11 @@
 #include "core/geometry/gxGeometry.h"
 #include "core/gxComposite.h"
 #include "View/Painters/gxPainter.h"
+#include "View/Painters/gxOcclusion.h"
 #include "View/gxTransformations.h"
 #include "View/Layouts/gxLayout.h"
+#include "core/gxDeadline.h"
+#include "View/Elements/gxChildWatcher.h"
 
 // Forward declarations
 class gxRootViewElement;
@@ -86,6 +89,16 @@ public:
      * @param aPainter The {@link gxPainter painter} to be used for drawing.
      */
     virtual void Paint( gxPainter& aPainter ) = 0;
+
+    /**
+     * @brief Adds the view element and its children to the region covered by
+     * opaque view elements, front to back (the reverse of painting order).
+     *
+     * By default only the children are visited, front-most first, as if the
+     * view element were transparent.
+     * @param aOcclusion The region being built.
+     */
+    virtual void Occlude( gxOcclusion& aOcclusion );
     
     /**
      * @brief Called when the figure needs to be repainted
@@ -216,10 +229,17 @@ public:
      *
      * Subclasses will override this method to perform their own translations.
      *
-     * Used by TransformToAbsolute.
+     * Used by TransformToAbsolute. Rects are transformed in fixed point, so
+     * nested scales don't round to whole pixels at each level.
      * @param aRect The rect to transform.
      */
-    virtual void Transform( gxRect& aRect );
+    virtual void Transform( gxFixedRect& aRect );
+
+    /**
+     * @brief Transforms a rect in whole pixels, rounding down once
+     * transformed.
+     */
+    void Transform( gxRect& aRect );
     
     /**
      * @brief Transforms a rect (typically bounds) to absolute coordinates.
@@ -227,7 +247,13 @@ public:
      * This is a recursive method that goes all the way up the parent tree.
      * @param aRect The rect to transform.
      */
-    virtual void TransformToAbsolute( gxRect& aRect );
+    virtual void TransformToAbsolute( gxFixedRect& aRect );
+
+    /**
+     * @brief Transforms a rect in whole pixels to absolute coordinates,
+     * rounding down once at the top of the tree (see gxToPix()).
+     */
+    void TransformToAbsolute( gxRect& aRect );
     
     
     virtual void TransformToLocal( gxRect& aRect );
@@ -269,12 +295,21 @@ public:
      * @brief Layouts the children of this view element.
      */
     virtual void Layout();
+
+    /**
+     * @brief Sets what is told of changes to the children of this view
+     * element (NULL for nothing).
+     */
+    void SetChildWatcher( gxChildWatcher* aWatcher ) { mChildWatcher = aWatcher; }
+
+    gxChildWatcher* GetChildWatcher() const { return mChildWatcher; }
 protected:
     
     enum Flags
     {
         Visible      = 0x01,
         ClipChildren = 0x02,
+        Opaque       = 0x04,
     };
     
     // Valid stands for whether the view elements position or size changed.
@@ -302,6 +337,13 @@ protected:
      */
     virtual void PaintChildren( gxPainter& aPainter ) = 0;
 
+    /**
+     * @brief Lets the children of this view element {@link
+     * gxViewElement::Occlude() occlude}, front-most first.
+     * @param aOcclusion The region being built.
+     */
+    void OccludeChildren( gxOcclusion& aOcclusion );
+
     /**
      * @brief Returns the {@link gxLightweightSystem lightweight system}
      * associated with this view element (and all its children).
@@ -352,8 +394,23 @@ protected:
      * @brief Provides the general validation logic (validating children,
      * layouting, mark as valid). The element-specific validation is done by
      * DoValidate, which is called by this method.
+     *
+     * @param aDeadline If given, validation stops once it passes (checked
+     *        after each child validated, so some progress is always made),
+     *        leaving this element and the ones not validated yet invalid; a
+     *        later call carries on from where it stopped. Elements validated
+     *        are repainted, as frames painted in between leave them out.
+     */
+    void Validate( gxDeadline* aDeadline = NULL );
+
+    /**
+     * @brief Validates, as Validate() does.
+     *
+     * @param aRepaint Whether or not to repaint the elements validated (or
+     *        leave it to an ancestor, whose repaint covers them).
      */
-    void Validate();
+    void Validate( gxDeadline* aDeadline,
+                   bool        aRepaint );
 
     /**
      * @brief Performs the actual element-specific validation.
@@ -362,6 +419,15 @@ protected:
      */
     virtual void DoValidate() {};
 
+    /**
+     * @brief Returns the number of invalid view elements, this one and its
+     * descendants.
+     *
+     * Only the descendants of view elements that aren't valid are counted, as
+     * those of valid ones are valid too.
+     */
+    unsigned long CountInvalid();
+
     /**
      * @brief Marks this view element as invalid (sets th valid flag to false);
      */
@@ -419,8 +485,22 @@ protected:
     virtual void OnAddChild( gxViewElement* aChild );
     virtual void OnBeforeChildRemoval( gxViewElement* aChild );
     virtual void OnAfterChildRemoval();
+
+    /**
+     * @brief Tells the child watcher of the parent, if any, that this view
+     * element changed.
+     */
+    void NotifyChanged();
+
+    /**
+     * @brief Tells the child watcher, if any, that the given child changed,
+     * making sure this view element validates so the watcher handles it.
+     */
+    void NotifyChildChanged( gxViewElement* aChild );
   
     gxFlags<gx8Flags> mFlags;
+
+    gxChildWatcher* mChildWatcher;
 };
 
 #endif // gxViewElement_h
\ No newline at end of file
@@ -20,6 +20,17 @@ void gxAnchor::UnsetConnection()
     mConnection = NULL;
 }
 
+gxPoint gxAnchor::GetPosition( const gxPoint& aReference,
+                               const gxRect&  aFigureBounds )
+{
+    return GetPosition( aReference );
+}
+
+gxPoint gxAnchor::GetReference( const gxRect& aFigureBounds )
+{
+    return GetReference();
+}
+
 void gxAnchor::OnAncestorInvalid()
 {
     if ( mConnection )
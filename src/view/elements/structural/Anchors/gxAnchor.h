@@ -28,6 +28,11 @@ public:
      */
     void UnsetConnection();
     
+    /*
+     * @brief Returns the connection of this anchor (NULL if none).
+     */
+    gxConnection* GetConnection() const { return mConnection; }
+    
     /*
      * @brief Returns the position of the connection anchor in absolute
      * coordinates.
@@ -50,6 +55,25 @@ public:
      * @return The anchor's feference point
      */
     virtual gxPoint GetReference() = 0;
+    
+    /*
+     * @brief Returns the position of the connection anchor, given the
+     * absolute bounds of the anchor's parent (the figure it is attached to).
+     *
+     * Used when revalidating many connections at once, so the bounds of a
+     * figure shared by several connections are only transformed once. By
+     * default, the bounds are ignored and GetPosition( aReference ) is called.
+     */
+    virtual gxPoint GetPosition( const gxPoint& aReference,
+                                 const gxRect&  aFigureBounds );
+    
+    /*
+     * @brief Returns the anchor's reference point, given the absolute bounds
+     * of the anchor's parent.
+     *
+     * By default, the bounds are ignored and GetReference() is called.
+     */
+    virtual gxPoint GetReference( const gxRect& aFigureBounds );
 protected:
     gxConnection* mConnection;
 
@@ -5,34 +5,45 @@ gxRectAnchor::gxRectAnchor()
 {
 }
 
-gxPoint gxRectAnchor::GetReference()
+gxRect gxRectAnchor::GetFigureBounds()
 {
     gxRect iRect = GetParent()->GetBounds();
     
     // It's the parent's bounds we need to transform, not ours; thus, the call
-    // to GetParent()
+    // to GetParent(). This gives us both the correct absolute center, but
+    // also the scaled width and height.
     GetParent()->TransformToAbsolute( iRect );
     
-    return iRect.GetCenter();
+    return iRect;
+}
+
+gxPoint gxRectAnchor::GetReference()
+{
+    return GetReference( GetFigureBounds() );
 }
 
 gxPoint gxRectAnchor::GetPosition( const gxPoint& aReference )
 {
-    gxRect iRect = GetParent()->GetBounds();
-    
-    // We transform the parent rect, which will give us both the correct
-    // absolute center, but also the scaled width and height
-    GetParent()->TransformToAbsolute( iRect );    
-    
+    return GetPosition( aReference, GetFigureBounds() );
+}
+
+gxPoint gxRectAnchor::GetReference( const gxRect& aFigureBounds )
+{
+    return aFigureBounds.GetCenter();
+}
+
+gxPoint gxRectAnchor::GetPosition( const gxPoint& aReference,
+                                   const gxRect&  aFigureBounds )
+{
     // We start with the center of the region
-    gxPoint iPosition = iRect.GetCenter();
+    gxPoint iPosition = aFigureBounds.GetCenter();
     
     // The deltas between the center point and the reference.
     gxPix dX = aReference.X - iPosition.X;
     gxPix dY = aReference.Y - iPosition.Y;
     
-    float lX = abs(dX) / (float)iRect.width;
-    float lY = abs(dY) / (float)iRect.height;
+    float lX = abs(dX) / (float)aFigureBounds.width;
+    float lY = abs(dY) / (float)aFigureBounds.height;
 
     float iScale = 0.5 / gxMax( lX, lY );
     
@@ -43,4 +54,4 @@ gxPoint gxRectAnchor::GetPosition( const gxPoint& aReference )
     iPosition.Y += dY;
     
     return iPosition;
-}
\ No newline at end of file
+}
@@ -10,6 +10,15 @@ public:
     
     virtual gxPoint GetPosition( const gxPoint& aReference );
     virtual gxPoint GetReference();    
+    
+    virtual gxPoint GetPosition( const gxPoint& aReference,
+                                 const gxRect&  aFigureBounds );
+    virtual gxPoint GetReference( const gxRect& aFigureBounds );
+private:
+    /**
+     * @brief Returns the parent bounds in absolute coordinates.
+     */
+    gxRect GetFigureBounds();
 };
 
 
@@ -0,0 +1,61 @@
+#ifndef gxItemSource_h
+#define gxItemSource_h
+
+#include "core/geometry/gxGeometry.h"
+
+#include <cstddef>
+
+// Forward declarations
+class gxViewElement;
+
+/**
+ * @brief An interface providing the items displayed by a
+ * {@link gxVirtualList virtual list}.
+ *
+ * The list only asks for as many item views as are visible at once, and
+ * binds each of them to different items as it scrolls.
+ */
+class gxItemSource
+{
+public:
+    virtual ~gxItemSource() {}
+
+    /**
+     * @brief Returns the number of items.
+     */
+    virtual size_t GetItemCount() = 0;
+
+    /**
+     * @brief Returns the size of a single item (all items are of the same
+     * size).
+     */
+    virtual gxSize GetItemSize() = 0;
+
+    /**
+     * @brief Creates a new item view.
+     *
+     * The list owns the returned view, and reuses it for different items.
+     */
+    virtual gxViewElement* CreateItemView() = 0;
+
+    /**
+     * @brief Makes an item view display an item.
+     *
+     * @param aView The item view, as created by CreateItemView().
+     * @param aIndex The index of the item.
+     */
+    virtual void BindItemView( gxViewElement *aView,
+                               size_t         aIndex ) = 0;
+
+    /**
+     * @brief Called when an item view no longer displays an item, and is
+     * kept for later reuse.
+     *
+     * @param aView The item view.
+     * @param aIndex The index of the item it displayed.
+     */
+    virtual void UnbindItemView( gxViewElement *aView,
+                                 size_t         aIndex ) {}
+};
+
+#endif // gxItemSource_h
@@ -43,12 +43,12 @@ void gxRootViewElement::InvalidateUp( gxViewElement* aChild,
     // requests (in some event loop).
     //
     // What this means is that after all modified objects have been doing their
-    // marking of invalid objects, the queue validation request will be processed
-    // and will lead to Validate() on this class being called.
+    // marking of invalid objects, the next frame of the lightweight system will
+    // lead to Validate() on this class being called.
     mLightweightSystem->QueueValidation();
 }
 
-void gxRootViewElement::TransformToAbsolute( gxRect &aRect )
+void gxRootViewElement::TransformToAbsolute( gxFixedRect &aRect )
 {
     // RootViewElement has no parent. So translation stops here.
 }
\ No newline at end of file
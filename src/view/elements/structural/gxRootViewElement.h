@@ -49,8 +49,12 @@ public:
 
     // Validate is promoted to public as the lightweight system needs to call it.
     using gxStructural::Validate;
+    
+    // As are these, for the lightweight system to validate in slices.
+    using gxStructural::IsntValid;
+    using gxStructural::CountInvalid;
 protected:
-    virtual void TransformToAbsolute( gxRect &aRect );
+    virtual void TransformToAbsolute( gxFixedRect &aRect );
     virtual void InvalidateUp( gxViewElement* aChild,
                                ValidState     aValid = Invalid );
 private:
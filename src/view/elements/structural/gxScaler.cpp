@@ -65,7 +65,7 @@ void gxScaler::Paint( gxPainter &aPainter )
     aPainter.PopState();
 }
 
-void gxScaler::Transform( gxRect &aRect )
+void gxScaler::Transform( gxFixedRect &aRect )
 {
     if ( mScale.IsntZero() )
     {
@@ -53,7 +53,7 @@ public:
     void Paint( gxPainter &aPainter );
 
 protected:
-    virtual void Transform( gxRect &aRect );
+    virtual void Transform( gxFixedRect &aRect );
 
     gxZoomManager *mZoomManager;
 private:
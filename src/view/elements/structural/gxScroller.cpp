@@ -1,6 +1,5 @@
 #include "View/Elements/Structural/gxScroller.h"
 #include "core/gxAssert.h"
-#include "core/gxLog.h"
 
 gxScroller::gxScroller()
   : mScrollManager( NULL )
@@ -65,15 +64,14 @@ void gxScroller::Paint( gxPainter &aPainter )
 
 void gxScroller::DoValidate()
 {
-    gxLog( "gxScroller::DoValidate()" );
     ReadjustScrollbars();
 }
 
-void gxScroller::Transform( gxRect &aRect )
+void gxScroller::Transform( gxFixedRect &aRect )
 {
     if ( mScrollPosition.IsntZero() )
     {
-        aRect -= mScrollPosition;
+        aRect -= gxToFixed( mScrollPosition );
     }
 }
 
@@ -31,7 +31,7 @@ public:
      * @param aScrollX The X axis scroll
      * @param aScaleY The Y axis scroll
      */
-    void SetScroll( gxPoint const &aScrollPosition );
+    virtual void SetScroll( gxPoint const &aScrollPosition );
 
     /**
      * @brief A handler method for scroll position events from the
@@ -52,7 +52,7 @@ public:
     
     virtual void GetDescendantsBounds( gxRect &aBounds );
 protected:
-    virtual void Transform( gxRect &aRect );
+    virtual void Transform( gxFixedRect &aRect );
 
     void DoValidate();
 
@@ -62,6 +62,11 @@ protected:
      */
     void ReadjustScrollbars();
 
+    /**
+     * @brief Returns the current scroll position.
+     */
+    const gxPoint& GetScrollPosition() const { return mScrollPosition; }
+
     gxScrollManager *mScrollManager;
 private:
     gxPoint mScrollPosition;
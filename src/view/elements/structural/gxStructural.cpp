@@ -32,6 +32,7 @@ void gxStructural::PaintChildren(gxPainter &aPainter)
     Iterator iChildren( GetChildren() );
     for ( iChildren.First(); iChildren.Current(); iChildren.Next() )
     {
+        gxPaintStat( aPainter.GetStats(), visited );
         iChildren.Current()->Paint( aPainter );
     }
 }
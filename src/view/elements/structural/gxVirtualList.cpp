@@ -0,0 +1,202 @@
+#include "View/Elements/Structural/gxVirtualList.h"
+#include "core/gxAssert.h"
+#include "core/gxLog.h"
+
+gxVirtualList::gxVirtualList()
+  : mItemSource( NULL ),
+    mColumns   ( 1    ),
+    mOverscan  ( 2    )
+{
+}
+
+gxVirtualList::gxVirtualList( gxScrollManager *aScrollManager )
+  : gxScroller ( aScrollManager ),
+    mItemSource( NULL ),
+    mColumns   ( 1    ),
+    mOverscan  ( 2    )
+{
+}
+
+gxVirtualList::~gxVirtualList()
+{
+    // The views are children, so are deleted along with the list.
+}
+
+void gxVirtualList::SetItemSource( gxItemSource *aItemSource )
+{
+    // Views are created by the item source, so can't be reused for another.
+    mViews.clear();
+    mPool.clear();
+    RemoveAllChildren( true );
+
+    mItemSource = aItemSource;
+
+    Invalidate();
+}
+
+void gxVirtualList::SetColumns( unsigned aColumns )
+{
+    if ( mColumns == aColumns )
+        return;
+
+    mColumns = aColumns;
+    Invalidate();
+}
+
+void gxVirtualList::SetOverscan( unsigned aOverscan )
+{
+    if ( mOverscan == aOverscan )
+        return;
+
+    mOverscan = aOverscan;
+    UpdateRange();
+}
+
+void gxVirtualList::ItemsChanged()
+{
+    // Release all views, so the visible ones are bound again.
+    while ( !mViews.empty() )
+    {
+        Release( mViews.begin() );
+    }
+
+    Invalidate();
+}
+
+gxViewElement* gxVirtualList::GetItemView( size_t aIndex )
+{
+    ViewMap::iterator iView = mViews.find( aIndex );
+
+    return iView != mViews.end() ? iView->second : NULL;
+}
+
+void gxVirtualList::SetScroll( gxPoint const &aScrollPosition )
+{
+    gxScroller::SetScroll( aScrollPosition );
+
+    UpdateRange();
+}
+
+void gxVirtualList::DoValidate()
+{
+    // Readjusting the scrollbars may change the scroll position, which
+    // updates the range too - but the visible size may have changed
+    // regardless.
+    gxScroller::DoValidate();
+
+    UpdateRange();
+}
+
+// The bounds of all items, whether they have views or not.
+void gxVirtualList::GetDescendantsBounds( gxRect &aBounds )
+{
+    if ( !mItemSource || mItemSource->GetItemCount() == 0 )
+        return;
+
+    gxSize   iItemSize = mItemSource->GetItemSize();
+    unsigned iColumns  = GetColumnCount();
+    size_t   iCount    = mItemSource->GetItemCount();
+    size_t   iRows     = ( iCount + iColumns - 1 ) / iColumns;
+
+    aBounds.Union( gxRect( 0,
+                           0,
+                           gxPix( gxMin( iCount, size_t( iColumns ) ) * iItemSize.X ),
+                           gxPix( iRows * iItemSize.Y ) ) );
+}
+
+void gxVirtualList::UpdateRange()
+{
+    if ( !mItemSource || Parentless() )
+        return;
+
+    gxSize iItemSize = mItemSource->GetItemSize();
+
+    if ( iItemSize.X <= 0 || iItemSize.Y <= 0 )
+        return;
+
+    unsigned iColumns = GetColumnCount();
+    size_t   iCount   = mItemSource->GetItemCount();
+    size_t   iRows    = ( iCount + iColumns - 1 ) / iColumns;
+
+    // The rows within sight, plus overscan
+    gxPix  iTop      = gxMax( GetScrollPosition().Y, 0 );
+    gxPix  iBottom   = iTop + GetBounds().height;
+    size_t iFirstRow = iTop / iItemSize.Y;
+    size_t iLastRow  = ( iBottom + iItemSize.Y - 1 ) / iItemSize.Y + mOverscan;
+
+    iFirstRow = iFirstRow > mOverscan ? iFirstRow - mOverscan : 0;
+    iLastRow  = gxMin( iLastRow, iRows );
+
+    size_t iFirst = iFirstRow * iColumns;
+    size_t iLast  = gxMax( iFirst, gxMin( iLastRow * iColumns, iCount ) );
+
+    // Release the views of items out of range first, so they can be reused
+    // for the items coming into range.
+    ViewMap::iterator iView = mViews.begin();
+
+    while ( iView != mViews.end() )
+    {
+        if ( iView->first < iFirst || iView->first >= iLast )
+            Release( iView++ );
+        else
+            ++iView;
+    }
+
+    for ( size_t i = iFirst; i < iLast; ++i )
+    {
+        gxViewElement *iItemView = GetItemView( i );
+
+        if ( !iItemView )
+        {
+            iItemView = Acquire();
+            mItemSource->BindItemView( iItemView, i );
+            mViews[ i ] = iItemView;
+        }
+
+        // Positions change along with the number of columns
+        iItemView->SetBounds( gxRect( gxPix( i % iColumns ) * iItemSize.X,
+                                      gxPix( i / iColumns ) * iItemSize.Y,
+                                      iItemSize.X,
+                                      iItemSize.Y ) );
+        iItemView->Show();
+    }
+}
+
+unsigned gxVirtualList::GetColumnCount()
+{
+    if ( mColumns > 0 )
+        return mColumns;
+
+    gxPix iItemWidth = mItemSource ? mItemSource->GetItemSize().X : 0;
+
+    if ( iItemWidth <= 0 || Parentless() )
+        return 1;
+
+    return gxMax( unsigned( GetBounds().width / iItemWidth ), 1u );
+}
+
+void gxVirtualList::Release( ViewMap::iterator aView )
+{
+    mItemSource->UnbindItemView( aView->second, aView->first );
+
+    aView->second->Hide();
+    mPool.push_back( aView->second );
+
+    mViews.erase( aView );
+}
+
+gxViewElement* gxVirtualList::Acquire()
+{
+    if ( mPool.empty() )
+    {
+        gxViewElement *iView = mItemSource->CreateItemView();
+        Add( iView );
+
+        return iView;
+    }
+
+    gxViewElement *iView = mPool.back();
+    mPool.pop_back();
+
+    return iView;
+}
@@ -0,0 +1,107 @@
+#ifndef gxVirtualList_h
+#define gxVirtualList_h
+
+#include "View/Elements/Structural/gxScroller.h"
+#include "View/Elements/Structural/gxItemSource.h"
+
+#include <map>
+#include <vector>
+
+/**
+ * @brief A scroller that displays the items of an {@link gxItemSource item
+ * source} as a list or a grid, creating views for the visible items only.
+ *
+ * Items are laid out in rows of one or more columns. Only the items within
+ * the visible rows (plus a few overscan rows above and below) have a view;
+ * as the list scrolls, views of items that go out of sight are kept in a pool
+ * and bound to the items that come into sight. The number of views therefore
+ * depends on the visible size only, not on the number of items.
+ *
+ * The descendants bounds, and so the scroll range reported to the
+ * {@link gxScrollManager scroll manager}, are those of all the items.
+ */
+class gxVirtualList: public gxScroller
+{
+public:
+    gxVirtualList();
+    gxVirtualList( gxScrollManager *aScrollManager );
+    ~gxVirtualList();
+
+    /**
+     * @brief Sets the item source, dropping the views of the previous one.
+     *
+     * The item source isn't owned by the list.
+     * @param aItemSource The new item source.
+     */
+    void SetItemSource( gxItemSource *aItemSource );
+
+    /**
+     * @brief Sets the number of columns.
+     * @param aColumns The number of columns; 1 (the default) for a list, 0
+     * for a grid with as many columns as fit the visible width.
+     */
+    void SetColumns( unsigned aColumns );
+
+    /**
+     * @brief Sets the number of rows with views beyond each side of the
+     * visible ones, so short scrolls don't have to bind new items.
+     * @param aOverscan The number of overscan rows (2 by default).
+     */
+    void SetOverscan( unsigned aOverscan );
+
+    /**
+     * @brief Called when the items of the source have changed (added, removed
+     * or modified), so all views are bound again and the range adjusted.
+     */
+    void ItemsChanged();
+
+    /**
+     * @brief Returns the view displaying an item, or NULL if the item has no
+     * view (it isn't near the visible part).
+     * @param aIndex The index of the item.
+     */
+    gxViewElement* GetItemView( size_t aIndex );
+
+    virtual void SetScroll( gxPoint const &aScrollPosition );
+
+    virtual void GetDescendantsBounds( gxRect &aBounds );
+protected:
+    void DoValidate();
+
+    /**
+     * @brief Makes sure exactly the items in the visible rows (plus overscan)
+     * have views, and that these are in place.
+     */
+    void UpdateRange();
+
+private:
+    typedef std::map< size_t, gxViewElement* > ViewMap;
+
+    /**
+     * @brief Returns the number of columns the items are laid out in.
+     */
+    unsigned GetColumnCount();
+
+    /**
+     * @brief Releases the view of an item back to the pool.
+     */
+    void Release( ViewMap::iterator aView );
+
+    /**
+     * @brief Returns a view from the pool, creating a new one if it is empty.
+     */
+    gxViewElement* Acquire();
+
+    gxItemSource *mItemSource;
+
+    unsigned mColumns;
+    unsigned mOverscan;
+
+    // The views bound to items, by item index
+    ViewMap mViews;
+
+    // Unbound (hidden) views
+    std::vector< gxViewElement* > mPool;
+};
+
+#endif // gxVirtualList_h
@@ -8,6 +8,7 @@ gxRuler::gxRuler( const gxRect  &aBounds,
   mScrollManager( NULL ),
   mIsHorizontal( aBounds.width > aBounds.height ),
   mBlockTextRatio( 0.5 ),
+  mScale( 1.0 ),
   mStartPixel( 0 ),
   mDivProvider( aDivProvider )
 {
@@ -67,6 +68,9 @@ void gxRuler::DoValidate()
     // system, which will only be available when Validate is called.
     CalcMinBlockSize();
 
+    // The blocks may have changed, so the strip needs painting in full.
+    mStrip.Invalidate();
+
     Repaint();
 }
 
@@ -84,15 +88,48 @@ void gxRuler::SetScale( const float aScale )
 {
     mScale = aScale;
     mDivProvider->SetScale( aScale );
+
+    // Scrolling shifts the strip painted, zooming paints it again.
+    mStrip.Invalidate();
 }
 
 void gxRuler::SetBounds( const gxRect &aNewBounds )
 {
     gxVisual::SetBounds( aNewBounds );
     mIsHorizontal = aNewBounds.width > aNewBounds.height;
+    mStrip.Invalidate();
 }
 
 void gxRuler::PaintSelf( gxPainter &aPainter )
+{
+    // The first and last pixels to be drawn, we need to take into account the
+    // scale
+    gxPix iStartPixel = mStartPixel;
+    gxPix iEndPixel   = mStartPixel + GetMyVisibleSize();
+
+    // The visible part of the ruler, in unscaled pixels
+    gxPix  iStart  = gxFloor( iStartPixel / mScale );
+    gxPix  iLength = gxCeil( ( iEndPixel - iStartPixel ) / mScale );
+    gxRect iStripRect = mIsHorizontal ?
+                        gxRect( iStart, 0, iLength, mBounds.height ) :
+                        gxRect( 0, iStart, mBounds.width, iLength );
+
+    // Paint into the strip, if the painter keeps strips, only what scrolled
+    // into view.
+    if ( aPainter.BeginStrip( mStrip, iStripRect, mIsHorizontal, iStartPixel, iEndPixel ) )
+    {
+        if ( iStartPixel < iEndPixel )
+            PaintDivs( aPainter, iStartPixel, iEndPixel );
+
+        aPainter.EndStrip();
+    }
+    else
+        PaintDivs( aPainter, iStartPixel, iEndPixel );
+}
+
+void gxRuler::PaintDivs( gxPainter &aPainter,
+                         gxPix     aStartPixel,
+                         gxPix     aEndPixel )
 {
     // Draw border
     aPainter.DrawRectangle( mBounds );
@@ -103,25 +140,24 @@ void gxRuler::PaintSelf( gxPainter &aPainter )
     // The length of the line of the div
     gxPix iLineLength;
   
-    // The last pixel to be drawn, we need to take into account the scale 
-    gxPix iEndPixel =  mStartPixel + GetMyVisibleSize();
-
     gxString iLabel;
     
     gxPoint iFrom, iTo;
 
-    // Start with the block at the start pixel
-    gxViewDiv *iDiv = mDivProvider->BlockAtPixel( mStartPixel / mScale );
-    do
+    // All the divs from the block at the start pixel up to the last pixel
+    mDivProvider->GetDivs( aStartPixel, aEndPixel, mDivs );
+
+    for ( unsigned int i = 0; i < mDivs.size(); i++ )
     {
-        iPos = iDiv->Pixel;
+        const gxViewDiv& iDiv = mDivs[i];
+        iPos = iDiv.Pixel;
 
         // Based on the type of the div draw different lines / text
-        switch ( iDiv->Type )
+        switch ( iDiv.Type )
         {
         case gxViewDiv::Block:
             iLineLength = mBounds.height;
-            iLabel = mDivProvider->GetLabelOfPixel( iPos );
+            mDivProvider->FormatLabelOfPixel( iPos, iLabel );
             aPainter.DrawText( iLabel, iPos, 0, 3, 3, mIsHorizontal );
             break;
         case gxViewDiv::Key:
@@ -139,12 +175,7 @@ void gxRuler::PaintSelf( gxPainter &aPainter )
         
         
         aPainter.DrawLine( iFrom, iTo );
-
-        iDiv = mDivProvider->Next();
-
-        // Stop when the actual position (taking into account the scale) of the
-        // next div is smaller than the last pixel to be drawn. 
-    } while ( gxFloor( iDiv->Pixel * mScale ) < iEndPixel );
+    }
 }
 
 gxPix gxRuler::GetMyVisibleSize()
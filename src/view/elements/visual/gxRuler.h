@@ -6,6 +6,7 @@
 #include "View/Managers/gxZoomManager.h"
 #include "View/Managers/gxScrollManager.h"
 #include "View/DivProvider/gxDivProvider.h"
+#include "core/gxStrip.h"
 
 /**
  * @brief A ruler view element.
@@ -64,8 +65,21 @@ public:
     virtual void SetBounds( const gxRect &aNewBounds );
 
 protected:
+    /**
+     * @brief Paints the ruler into its strip, so on scroll only the divisions
+     * scrolled into view are painted.
+     */
     void PaintSelf( gxPainter &aPainter );
 
+    /**
+     * @brief Paints the divisions between two (scaled) pixels.
+     * @param aStartPixel The first pixel to be painted.
+     * @param aEndPixel The pixel past the last one to be painted.
+     */
+    void PaintDivs( gxPainter &aPainter,
+                    gxPix     aStartPixel,
+                    gxPix     aEndPixel );
+
     /**
      * @brief Calculates the miminum block size in pixel.
      * 
@@ -108,6 +122,12 @@ protected:
     float mBlockTextRatio;
   
     gxDivProvider *mDivProvider;
+
+    /// The divs painted, kept so their storage is reused.
+    gxViewDivs mDivs;
+
+    /// The pixels of the ruler, kept as it scrolls.
+    gxStrip    mStrip;
 };
 
 #endif // gxRuler_h
\ No newline at end of file
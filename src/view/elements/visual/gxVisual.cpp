@@ -2,6 +2,7 @@
 #include "View/gxLightweightSystem.h"
 #include "core/gxLog.h"
 #include "core/gxAssert.h"
+#include "core/gxTrace.h"
 
 gxVisual::gxVisual() :
     mBounds( 0, 0, 0, 0 ),
@@ -24,6 +25,10 @@ void gxVisual::Paint( gxPainter& aPainter )
     if ( !IsVisible() )
         return;
 
+    // Not laid out yet, so would be painted out of place.
+    if ( IsInvalid() && !aPainter.IsPaintingInvalid() )
+        return;
+
     gxRect iBounds = GetBounds();
     
     // Check if the painter has a different positioning mode than the one we
@@ -38,9 +43,26 @@ void gxVisual::Paint( gxPainter& aPainter )
     }
     
     // Only paint if need to (intersect with the bounds of painting area and
-    // damaged areas).
-    if ( aPainter.NeedsPainting( iBounds ) )
+    // damaged areas, and not hidden by opaque view elements painted later).
+    gxOcclusion* iOcclusion = aPainter.GetOcclusion();
+    bool iOccluded = iOcclusion && iOcclusion->IsOccluded( this );
+
+    // Small on screen (say, zoomed out), so paint with less detail.
+    int iDetail = gxDetail::Full;
+
+    if ( !iOccluded && aPainter.GetDetailSize() > 0 )
     {
+        gxSize iScreenSize = aPainter.GetScreenSize( iBounds.GetSize() );
+
+        if ( gxMax( iScreenSize.X, iScreenSize.Y ) < aPainter.GetDetailSize() )
+            iDetail = GetDetail( aPainter, iScreenSize );
+    }
+
+    if ( !iOccluded && iDetail != gxDetail::None && aPainter.NeedsPainting( iBounds ) )
+    {
+        gxPaintStat( aPainter.GetStats(), painted );
+        gxTraceScope( "paint", typeid( *this ), this );
+
         // Push current painter state so it can be restored later on.
         aPainter.PushState();
 
@@ -48,13 +70,24 @@ void gxVisual::Paint( gxPainter& aPainter )
         if ( IsClippingChildren() )
             aPainter.SetClipArea( iBounds );
 
-        PaintSelf( aPainter );
-        PaintChildren( aPainter );
-        PaintBorder( aPainter );
+        if ( iDetail == gxDetail::Full )
+        {
+            PaintSelf( aPainter );
+            PaintChildren( aPainter );
+            PaintBorder( aPainter );
+        } else {
+            gxPaintStat( aPainter.GetStats(), simplified );
+            PaintDetail( aPainter, iDetail );
+        }
 
         // Pop (will also restore) the painter state to before any painting was
         // done.
         aPainter.PopState();
+    } else {
+        gxPaintStat( aPainter.GetStats(), culled );
+
+        if ( iOccluded )
+            gxPaintStat( aPainter.GetStats(), occluded );
     }
 
     if ( iPositioningModeDifferent )
@@ -64,6 +97,90 @@ void gxVisual::Paint( gxPainter& aPainter )
     
 }
 
+void gxVisual::Occlude( gxOcclusion& aOcclusion )
+{
+    if ( !IsVisible() )
+        return;
+
+    // May be left out of painting or not laid out yet, so neither hides nor
+    // is hidden.
+    if ( IsInvalid() )
+        return;
+
+    gxRect iBounds      = GetBounds();
+    gxRect iOuterBounds = GetOuterBounds();
+
+    if ( IsRelative() )
+    {
+        TransformToAbsolute( iBounds );
+        TransformToAbsolute( iOuterBounds );
+    }
+
+    // Only what can be seen of it matters.
+    iOuterBounds = aOcclusion.Clip( iOuterBounds );
+
+    if ( !aOcclusion.NeedsPainting( iOuterBounds ) )
+        return;
+
+    // Painted over entirely by what is in front of it. (Unless children may
+    // paint outside of it.)
+    if ( ( IsChildless() || IsClippingChildren() ) && aOcclusion.Covers( iOuterBounds ) )
+    {
+        aOcclusion.SetOccluded( this );
+        return;
+    }
+
+    // Painted with less detail, without its children, so left out.
+    if ( aOcclusion.GetDetailSize() > 0 &&
+         gxMax( iBounds.width, iBounds.height ) < aOcclusion.GetDetailSize() )
+        return;
+
+    // Children are in front of this view element.
+    if ( IsClippingChildren() )
+        aOcclusion.PushClipArea( iBounds );
+
+    OccludeChildren( aOcclusion );
+
+    if ( IsClippingChildren() )
+        aOcclusion.PopClipArea();
+
+    if ( IsOpaque() )
+        aOcclusion.AddOccluder( iBounds );
+}
+
+void gxVisual::SetOpaque( bool aOpaque )
+{
+    if ( aOpaque == IsOpaque() )
+        return;
+
+    if ( aOpaque )
+        mFlags.Set( Opaque );
+    else
+        mFlags.Unset( Opaque );
+
+    // What is behind may now show through.
+    if ( IsVisible() )
+        Repaint();
+}
+
+bool gxVisual::IsOpaque()
+{
+    return mFlags.IsSet( Opaque );
+}
+
+int gxVisual::GetDetail( gxPainter&    aPainter,
+                         const gxSize& aScreenSize )
+{
+    return aPainter.IsPaintingProxies() ? gxDetail::Proxy : gxDetail::None;
+}
+
+void gxVisual::PaintDetail( gxPainter& aPainter,
+                            int        aDetail )
+{
+    // A single rectangle stands for the element and all of its children.
+    aPainter.DrawRectangle( GetBounds() );
+}
+
 void gxVisual::Repaint()
 {
     gxRect iBounds = GetOuterBounds();
@@ -86,6 +203,7 @@ void gxVisual::PaintChildren( gxPainter& aPainter )
     for ( iChildren.First(); iChildren.Current(); iChildren.Next() )
     {
         // Paint the child
+        gxPaintStat( aPainter.GetStats(), visited );
         iChildren.Current()->Paint( aPainter );
     }
 
@@ -132,6 +250,9 @@ void gxVisual::SetBounds( const gxRect& aNewBounds )
         mBounds.SetSize( aNewBounds.GetSize() );
     }
 
+    if ( iChanged )
+        NotifyChanged();
+
     // Repaint
     if ( iChanged && IsVisible() )
     {
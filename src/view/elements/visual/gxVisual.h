@@ -3,6 +3,22 @@
 
 #include "View/Elements/gxViewElement.h"
 
+/**
+ * @brief Levels of detail visual view elements are painted with.
+ *
+ * Levels between Proxy and Full are left for view elements to define (see
+ * {@link gxVisual::GetDetail()}).
+ */
+struct gxDetail
+{
+    enum Type
+    {
+        None  = 0,  // Not painted at all
+        Proxy = 1,  // Painted as a rectangle, without children
+        Full  = 255 // Painted in full
+    };
+};
+
 /**
  * @brief A view element that has visual representation and defined bounds,
  * like shapes.
@@ -22,9 +38,35 @@ public:
      *
      * As part of the default painting mechanism, visual view elements clip the
      * painting of their children to their bounds.
+     *
+     * Once smaller on screen than the painter's {@link
+     * gxPainter::GetDetailSize() detail size}, the view element is painted
+     * with less detail (see {@link gxVisual::GetDetail() GetDetail()}).
      * @param aPainter The {@link gxPainter painter} to be used for drawing.
      */
     void Paint( gxPainter& aPainter );
+
+    /**
+     * @brief Marks the view element {@link gxOcclusion::SetOccluded()
+     * occluded} if covered by what is in front of it, otherwise lets its
+     * children occlude and then, if opaque, adds its bounds to the region.
+     * @param aOcclusion The region being built.
+     */
+    virtual void Occlude( gxOcclusion& aOcclusion );
+
+    /**
+     * @brief Sets whether or not the view element is opaque, that is, whether
+     * {@link gxVisual::PaintSelf() PaintSelf()} fills all of its bounds
+     * (it isn't by default).
+     *
+     * View elements behind an opaque one, and entirely covered by it, aren't
+     * painted when the {@link gxLightweightSystem::SetOcclusionCulling()
+     * lightweight system culls occluded view elements}.
+     * @param aOpaque Whether the view element is opaque.
+     */
+    void SetOpaque( bool aOpaque );
+
+    bool IsOpaque();
     
     /**
      * @brief Repaints the view element making its bounds dirty.
@@ -78,6 +120,34 @@ protected:
      */
     virtual void PaintBorder( gxPainter& aPainter ) {};
 
+    /**
+     * @brief Returns the level of detail to paint with, once smaller on
+     * screen than the painter's {@link gxPainter::GetDetailSize() detail
+     * size}.
+     *
+     * By default this is a proxy, or nothing if the painter {@link
+     * gxPainter::IsPaintingProxies() isn't painting proxies}. View elements
+     * may return levels between gxDetail::Proxy and gxDetail::Full, which
+     * they paint in {@link gxVisual::PaintDetail() PaintDetail()}.
+     * @param aPainter The {@link gxPainter painter} to be used for drawing.
+     * @param aScreenSize The on-screen size of the view element.
+     * @return A level from gxDetail::None to gxDetail::Full.
+     */
+    virtual int GetDetail( gxPainter&    aPainter,
+                           const gxSize& aScreenSize );
+
+    /**
+     * @brief Paints the view element with less than full detail, instead of
+     * painting itself, its children and its border.
+     *
+     * By default this draws the bounds (the proxy), whatever the level.
+     * @param aPainter The {@link gxPainter painter} to be used for drawing.
+     * @param aDetail The level of detail, from gxDetail::Proxy up to (not
+     *        including) gxDetail::Full.
+     */
+    virtual void PaintDetail( gxPainter& aPainter,
+                              int        aDetail );
+
     /**
      * @brief Translates (moves) the element.
      * @param aDelta The X/Y delta of pixels.
@@ -1,6 +1,10 @@
 #ifndef gxLightweightControl_h
 #define gxLightweightControl_h
 
-#include "adapters/wx/gxLightweightControl.h"
+#ifdef GX_HEADLESS
+    #include "adapters/headless/gxLightweightControl.h"
+#else
+    #include "adapters/wx/gxLightweightControl.h"
+#endif
 
 #endif // gxLightweightControl_h
\ No newline at end of file
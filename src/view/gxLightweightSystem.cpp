@@ -1,12 +1,42 @@
 #include "View/gxLightweightSystem.h"
 #include "gxLightweightControl.h"
 #include "View/Painters/gxDcPainter.h"
+#include "core/gxTextCache.h"
+#include "core/gxTrace.h"
+#include "core/geometry/gxRectBatch.h"
+
+#include <algorithm>
+
+// Validating may invalidate elements already validated (a layout resizing
+// its parent, say); validation is repeated up to this many times per frame,
+// so as not to paint elements mid-change.
+static const int MaxValidationPasses = 4;
+
+// Orders rects by area, larger first.
+static bool IsLarger( const gxRect& aRect,
+                      const gxRect& aOther )
+{
+    return (long long)aRect.width * aRect.height >
+           (long long)aOther.width * aOther.height;
+}
 
 gxLightweightSystem::gxLightweightSystem( gxLightweightControl *aControl )
 : mContents( NULL ),
   mScrollManager( NULL ),
-  mValidationQueued( false )
+  mFrameQueued( false ),
+  mValidationQueued( false ),
+  mValidationBudget( 0 ),
+  mValidationTotal( 0 ),
+  mInFrame( false ),
+  mPaintStatsEnabled( false ),
+  mPaintStatsOverlay( false ),
+  mDetailSize( 0 ),
+  mPaintProxies( true ),
+  mOcclusionCulling( false ),
+  mOccluded( false )
 {
+    mScrollPending[ 0 ] = mScrollPending[ 1 ] = false;
+
     // Sets this a the lightweight system of the control so delegation can start.
     aControl->SetLightweightSystem( this );
 
@@ -15,10 +45,24 @@ gxLightweightSystem::gxLightweightSystem( gxLightweightControl *aControl )
 
     // Create the root view element
     mRootViewElement = new gxRootViewElement( this );
+
+    // Coalesced events (like zoom and scroll changes) are fired with frames.
+    SetFlushRequest( fastdelegate::MakeDelegate( this, &gxLightweightSystem::QueueFrame ) );
+
+    // Events fired on other threads are delivered with frames too.
+    SetPostRequest( fastdelegate::MakeDelegate( this, &gxLightweightSystem::OnEventsPosted ) );
 }
 
 gxLightweightSystem::~gxLightweightSystem()
 {
+    // Unless another system has since taken over. This comes first, as
+    // posting threads may call OnEventsPosted() till it's unset.
+    if ( GetFlushRequest() == fastdelegate::MakeDelegate( this, &gxLightweightSystem::QueueFrame ) )
+        SetFlushRequest( gxFlushRequest() );
+
+    if ( GetPostRequest() == fastdelegate::MakeDelegate( this, &gxLightweightSystem::OnEventsPosted ) )
+        SetPostRequest( gxFlushRequest() );
+
     // Remove notification from previous scroll manager, (if such exist).
     if ( mScrollManager )
         mScrollManager->gxUnsubscribe( evScrollChanged );
@@ -43,8 +87,15 @@ void gxLightweightSystem::SetContents( gxViewElement *aViewElement )
     mRootViewElement->Add( mContents );
     
     // Composition should start with all view elements invalid, so validate them
-    // Now
-    mRootViewElement->Validate();
+    // Now - unless validating in slices, in which case validation starts with
+    // the next frame.
+    if ( mValidationBudget == 0 )
+    {
+        mRootViewElement->Validate();
+    } else {
+        mRootViewElement->Invalidate();
+        QueueValidation();
+    }
 }
 
 void gxLightweightSystem::SetScrollManager( gxScrollManager *aScrollManager )
@@ -59,24 +110,223 @@ void gxLightweightSystem::SetScrollManager( gxScrollManager *aScrollManager )
 
 void gxLightweightSystem::OnScrollChanged( const gxScroll *aScroll )
 {
-    mControl->SetScrollbar( wxHORIZONTAL, aScroll->mPosition.X, aScroll->mVisible.X, aScroll->mRange.X );
-    mControl->SetScrollbar( wxVERTICAL,   aScroll->mPosition.Y, aScroll->mVisible.Y, aScroll->mRange.Y );
+    mControl->UpdateScrollbars( aScroll );
 }
 
 void gxLightweightSystem::Paint( gxPaintDC *aDc, gxRects const &aDamagedRects )
 {
+    gxTraceScope( "paint", typeid( *this ), this );
+
+    gxPaintStats *iStats = GetCollectingStats();
+
+    // Paints outside of frames are told on their own (frames time the paint
+    // phase themselves).
+    if ( iStats && !mInFrame )
+        iStats->Reset();
+
+    gxPaintClock iClock( mInFrame ? NULL : iStats );
+
     // Create a painter
     gxDcPainter iPainter( aDc, aDamagedRects );
+    iPainter.SetStats( iStats );
+
+    // Leave out what isn't validated yet when validating in slices.
+    iPainter.SetPaintInvalid( mValidationTotal == 0 );
+
+    iPainter.SetDetailSize( mDetailSize );
+    iPainter.SetPaintProxies( mPaintProxies );
+
+    // Leave out what opaque view elements cover.
+    if ( mOcclusionCulling )
+    {
+        if ( !mOccluded )
+            Occlude( aDamagedRects );
+
+        iPainter.SetOcclusion( &mOcclusion );
+    }
 
     // Ask the root view element to paint itself using the painter.
     mRootViewElement->Paint( iPainter );
+
+    if ( iStats )
+    {
+        for ( unsigned int i = 0; i < aDamagedRects.size(); i++ )
+        {
+            iStats->damagedRects++;
+            iStats->damagedArea += aDamagedRects[i].width * aDamagedRects[i].height;
+        }
+
+        iClock.Lap( &gxPaintStats::paintTime );
+
+        if ( !mInFrame )
+            mLastPaintStats = *iStats;
+    }
+
+    // The region is only good for this paint.
+    mOccluded = false;
+
+    // Drawn last, so it's over the contents (and isn't counted).
+    if ( mPaintStatsOverlay )
+    {
+        iPainter.SetStats( NULL );
+        PaintStatsOverlay( iPainter );
+    }
+}
+
+void gxLightweightSystem::PaintStatsOverlay( gxPainter &aPainter )
+{
+    const gxPaintStats &iStats = mLastPaintStats;
+    const gxPix iPadding = 4;
+
+    gxString iLines[] =
+    {
+        gxString::Format( _T( "elements: %lu visited, %lu culled (%lu occluded), %lu painted, %lu simplified" ),
+                          iStats.visited, iStats.culled, iStats.occluded, iStats.painted, iStats.simplified ),
+        gxString::Format( _T( "primitives: %lu rects, %lu lines, %lu texts" ),
+                          iStats.rectangles, iStats.lines, iStats.texts ),
+        gxString::Format( _T( "painter: %lu pushes, %lu clips" ),
+                          iStats.statePushes, iStats.clipChanges ),
+        gxString::Format( _T( "damage: %lu rects, %lu px" ),
+                          iStats.damagedRects, iStats.damagedArea ),
+        gxString::Format( _T( "ms: %.2f input, %.2f validation, %.2f damage, %.2f paint" ),
+                          iStats.inputTime, iStats.validationTime,
+                          iStats.damageTime, iStats.paintTime )
+    };
+    const int iCount = sizeof( iLines ) / sizeof( iLines[0] );
+
+    // Size the overlay to fit the lines
+    gxSize iSizes[ iCount ];
+    gxRect iBounds( 0, 0, 0, iPadding );
+
+    for ( int i = 0; i < iCount; ++i )
+    {
+        iSizes[i] = aPainter.GetTextSize( iLines[i] );
+        iBounds.width   = gxMax( iBounds.width, iSizes[i].X + 2 * iPadding );
+        iBounds.height += iSizes[i].Y;
+    }
+    iBounds.height += iPadding;
+
+    aPainter.DrawRectangle( iBounds );
+
+    gxPix iY = iPadding;
+    for ( int i = 0; i < iCount; ++i )
+    {
+        aPainter.DrawText( iLines[i], iPadding, iY );
+        iY += iSizes[i].Y;
+    }
+
+    mPaintStatsOverlayBounds = iBounds;
+}
+
+void gxLightweightSystem::SetDetailSize( gxPix aSize,
+                                         bool  aPaintProxies )
+{
+    if ( mDetailSize == aSize && mPaintProxies == aPaintProxies )
+        return;
+
+    mDetailSize   = aSize;
+    mPaintProxies = aPaintProxies;
+
+    // Everything may be painted differently now.
+    gxRect iControlBounds = GetControlBounds();
+    gxRect iBounds( 0, 0, iControlBounds.width, iControlBounds.height );
+    AddDirtyRegion( iBounds );
+}
+
+void gxLightweightSystem::SetOcclusionCulling( bool aCulling )
+{
+    mOcclusionCulling = aCulling;
+    mOccluded         = false;
+}
+
+void gxLightweightSystem::Occlude( gxRects const &aDamagedRects )
+{
+    if ( !mOcclusionCulling )
+        return;
+
+    gxTraceScope( "occlude", typeid( *this ), this );
+
+    gxRect iControlBounds = GetControlBounds();
+    mOcclusion.Reset( gxRect( 0, 0, iControlBounds.width, iControlBounds.height ),
+                      aDamagedRects );
+    mOcclusion.SetDetailSize( mDetailSize );
+
+    mRootViewElement->Occlude( mOcclusion );
+
+    mOccluded = true;
+}
+
+bool gxLightweightSystem::IsOccluded( gxRect const &aRect ) const
+{
+    return mOccluded && mOcclusion.Covers( aRect );
+}
+
+void gxLightweightSystem::SetPaintStatsEnabled( bool aEnabled )
+{
+    mPaintStatsEnabled = aEnabled;
+
+    if ( !aEnabled )
+    {
+        mPaintStats.Reset();
+        mLastPaintStats.Reset();
+    }
+}
+
+void gxLightweightSystem::SetPaintStatsOverlay( bool aShow )
+{
+    if ( mPaintStatsOverlay == aShow )
+        return;
+
+    mPaintStatsOverlay = aShow;
+
+    if ( aShow )
+        SetPaintStatsEnabled( true );
+
+    // Paint the overlay in (it hasn't got bounds yet), or paint it out.
+    gxRect iBounds = mPaintStatsOverlayBounds;
+
+    if ( iBounds.IsEmpty() )
+    {
+        gxRect iControlBounds = GetControlBounds();
+        iBounds = gxRect( 0, 0, iControlBounds.width, iControlBounds.height );
+    }
+
+    AddDirtyRegion( iBounds );
 }
 
 void gxLightweightSystem::AddDirtyRegion( gxRect &aRect )
 {
-    // This will invalidate the rect and fire a paint event (the current event
-    // execution will continue).
-    mControl->RefreshRect( aRect );
+    if ( aRect.IsEmpty() )
+        return;
+
+    // Rects covered by others are dropped all at once, with the next frame
+    // (see MergeDirtyRegions()).
+    mDirtyRegions.push_back( aRect );
+    QueueFrame();
+}
+
+void gxLightweightSystem::MergeDirtyRegions()
+{
+    if ( mDirtyRegions.size() < 2 )
+        return;
+
+    // Larger rects first, so each rect need only be checked against the rects
+    // kept before it (a batch of them, checked some at a time).
+    std::stable_sort( mDirtyRegions.begin(), mDirtyRegions.end(), IsLarger );
+
+    gxRects     iKept;
+    gxRectBatch iKeptBatch;
+
+    for ( gxRectsIterator iRect = mDirtyRegions.begin(); iRect != mDirtyRegions.end(); ++iRect )
+    {
+        if ( iKeptBatch.CoversAny( *iRect ) )
+            continue;
+
+        iKeptBatch.Add( *iRect );
+        iKept.push_back( *iRect );
+    }
+
+    mDirtyRegions.swap( iKept );
 }
 
 gxRect gxLightweightSystem::GetControlBounds() const
@@ -86,32 +336,181 @@ gxRect gxLightweightSystem::GetControlBounds() const
 
 gxSize gxLightweightSystem::GetTextSize( gxString &aText )
 {
-    gxSize iSize = mControl->GetTextSize( aText );
-    return gxSize( iSize.X, iSize.Y );
+    return gxTextCache::Get().GetTextSize( mControl->GetFontId(), aText, *mControl );
 }
 
 void gxLightweightSystem::OnScroll ( const bool isVertical, const gxPix aPosition )
 {
-    if ( mScrollManager )
-        mScrollManager->SetPosition( isVertical, aPosition );
+    // Only the latest position matters, so scrolls are coalesced until the
+    // next frame.
+    mScrollPosition[ isVertical ] = aPosition;
+    mScrollPending[ isVertical ]  = true;
+    QueueFrame();
 }
 
 void gxLightweightSystem::QueueValidation()
 {
-    // To prevent duplicate events, only queue a validation request if none is
-    // currently queued.
+    mValidationQueued = true;
+    QueueFrame();
+}
+
+void gxLightweightSystem::SetValidationBudget( long aMilliseconds )
+{
+    mValidationBudget = aMilliseconds;
+}
+
+float gxLightweightSystem::GetValidationProgress()
+{
+    if ( mValidationTotal == 0 )
+        return 1;
+
+    // More elements may have been invalidated since validation started.
+    unsigned long iRemaining = mRootViewElement->CountInvalid();
+    mValidationTotal = gxMax( mValidationTotal, iRemaining );
+
+    return 1 - float( iRemaining ) / mValidationTotal;
+}
+
+void gxLightweightSystem::ValidateSlice()
+{
     if ( !mValidationQueued )
+        return;
+
+    mValidationQueued = false;
+
+    // Count what there is to validate, in case it takes more than a slice.
+    bool iStarting = mValidationTotal == 0;
+
+    if ( iStarting )
+        mValidationTotal = mRootViewElement->CountInvalid();
+
+    gxDeadline iDeadline( mValidationBudget );
+
+    // Validation may invalidate elements again, so carry on while there's
+    // time left.
+    do
     {
-        mControl->QueueValidation();
+        mRootViewElement->Validate( &iDeadline );
+    } while ( mRootViewElement->IsntValid() && !iDeadline.HasPassed() );
+
+    bool iDone = !mRootViewElement->IsntValid();
+
+    // Validated all in one slice - no progress to tell.
+    if ( iStarting && iDone )
+    {
+        mValidationTotal = 0;
+        return;
+    }
+
+    Fire( evValidationProgress, iDone ? 1 : GetValidationProgress() );
+
+    if ( iDone )
+        mValidationTotal = 0;
+    else
         mValidationQueued = true;
+}
+
+void gxLightweightSystem::QueueFrame()
+{
+    // To prevent duplicate events, only queue a frame if none is currently
+    // queued.
+    if ( !mFrameQueued )
+    {
+        mControl->QueueFrame();
+        mFrameQueued = true;
     }
 }
 
-void gxLightweightSystem::OnValidationRequest()
+void gxLightweightSystem::OnEventsPosted()
 {
-    // As this is the handler of the event, once this is called validation is
-    // no longer queued.
-    mValidationQueued = false;
+    // Called on the posting thread, so leave mFrameQueued alone: the extra
+    // frame is harmless.
+    mControl->QueueFrameFromThread();
+}
+
+void gxLightweightSystem::OnFrame()
+{
+    // Note that the frame stays queued while it runs, so requests made during
+    // it don't queue another.
+    mInFrame = true;
+
+    gxTraceScope( "frame", typeid( *this ), this );
+
+    gxPaintStats *iStats = GetCollectingStats();
+
+    if ( iStats )
+        iStats->Reset();
+
+    gxPaintClock iClock( iStats );
+
+    // Input
+    DeliverPostedEvents();
+
+    for ( int iVertical = 0; iVertical < 2; ++iVertical )
+    {
+        if ( !mScrollPending[ iVertical ] )
+            continue;
+
+        mScrollPending[ iVertical ] = false;
+
+        if ( mScrollManager )
+            mScrollManager->SetPosition( iVertical != 0, mScrollPosition[ iVertical ] );
+    }
+
+    // Coalesced events, once per frame
+    FlushCoalescedEvents();
+
+    iClock.Lap( &gxPaintStats::inputTime );
+
+    // Validation (and layout)
+    if ( mValidationBudget > 0 )
+    {
+        ValidateSlice();
+    } else {
+        for ( int iPass = 0; mValidationQueued && iPass < MaxValidationPasses; ++iPass )
+        {
+            mValidationQueued = false;
+            mRootViewElement->Validate();
+        }
+    }
+
+    iClock.Lap( &gxPaintStats::validationTime );
+
+    // Damage (the statistics overlay is refreshed along with anything else)
+    if ( mPaintStatsOverlay && !mDirtyRegions.empty() )
+    {
+        gxRect iOverlay = mPaintStatsOverlayBounds;
+        AddDirtyRegion( iOverlay );
+    }
+
+    MergeDirtyRegions();
+
+    for ( gxRectsIterator iRect = mDirtyRegions.begin(); iRect != mDirtyRegions.end(); ++iRect )
+    {
+        mControl->RefreshRect( *iRect );
+    }
 
-    mRootViewElement->Validate();
-}
\ No newline at end of file
+    iClock.Lap( &gxPaintStats::damageTime );
+
+    // Paint, now rather than once the control gets to it, so all of the
+    // damage is painted at once.
+    if ( !mDirtyRegions.empty() )
+    {
+        mDirtyRegions.clear();
+        mControl->Update();
+    }
+
+    iClock.Lap( &gxPaintStats::paintTime );
+
+    if ( iStats )
+        mLastPaintStats = *iStats;
+
+    mInFrame = false;
+
+    // Once done, the frame is no longer queued. If validation didn't settle,
+    // or painting caused damage, carry on with the next frame.
+    mFrameQueued = false;
+
+    if ( mValidationQueued || !mDirtyRegions.empty() )
+        QueueFrame();
+}
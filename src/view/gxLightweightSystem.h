@@ -4,8 +4,11 @@
 #include "core/gxObject.h"
 #include "core/gxPaintDC.h"
 #include "core/observer/gxObserver.h"
+#include "core/observer/gxSubject.h"
 #include "View/Elements/Structural/gxRootViewElement.h"
 #include "View/Managers/gxScrollManager.h"
+#include "View/Painters/gxPaintStats.h"
+#include "View/Painters/gxOcclusion.h"
 // forward declaration
 class gxLightweightControl;
 
@@ -18,10 +21,18 @@ class gxLightweightControl;
  *  like paint, to this class.
  * This class will send repaint requests to the control.
  */
-class gxLightweightSystem: public gxObject
+class gxLightweightSystem: public gxObject,
+                           public virtual gxSubject
 {
     gxDeclareObserver( gxLightweightSystem )
 public:
+    // Events definition
+
+    /// Fired after each slice of validation while validating in slices (see
+    /// SetValidationBudget()), with the progress (see
+    /// GetValidationProgress()).
+    gxDefineEvent( evValidationProgress, float )
+
     /**
      * The constructor of the lightweight system.
      *
@@ -65,10 +76,12 @@ public:
 
     /**
      * @brief Marks a rectangle that needs repainting (and will queue a
-     * repaint on the control).
+     * frame).
      *
      * {@link gxViewElement View elements} call this method when repaint is
-     *  required (like, for example, when they are erased).
+     *  required (like, for example, when they are erased). The rect is only
+     * passed on to the control with the next frame, once the view elements
+     * are valid, so they aren't painted mid-change.
      * @param aRect The rect needs repainting.
      */
     void AddDirtyRegion( gxRect &aRect );
@@ -79,7 +92,8 @@ public:
     gxRect GetControlBounds() const;
 
     /**
-     * @brief Returns the text size for a given string.
+     * @brief Returns the text size for a given string, from the {@link
+     * gxTextCache text cache} if measured before.
      * @param aText The text whose size we equire.
      * @return The given text size.
      */
@@ -88,19 +102,128 @@ public:
     /**
      * @brief Queues an asynchronous validation request.
      * 
-     * This will send and event loop an validation request event that will be
-     * processed after the currently processed event is handled.
+     * Validation takes place with the next frame.
      */
     void QueueValidation();
 
     /**
-     * @brief Handles a validation request that originated from
-     * {@link gxLightweightSystem::QueueValidation QueueValidation()}
+     * @brief Sets the time validation may take per frame.
+     *
+     * Validating a large hierarchy (say, once set as contents) may take long
+     * enough to freeze the application. With a budget, validation stops once
+     * it runs out, so the frame can paint what is valid (invalid view elements
+     * are left out), and carries on with the next frame - the event loop
+     * handling input in between.
+     *
+     * @param aMilliseconds The budget in milliseconds, or 0 (the default) for
+     *        validating all at once.
+     */
+    void SetValidationBudget( long aMilliseconds );
+
+    /**
+     * @brief Returns how far validation in slices has got, from 0 to 1 (1 if
+     * there's nothing to validate).
+     *
+     * Applications may use this to show a loading indicator.
      */
-    void OnValidationRequest();
+    float GetValidationProgress();
+
+    /**
+     * @brief Sets whether or not paint statistics are collected (they aren't
+     * by default).
+     *
+     * Statistics are only collected when built with GX_PAINT_STATS defined;
+     * otherwise they stay 0.
+     */
+    void SetPaintStatsEnabled( bool aEnabled );
+
+    bool IsPaintStatsEnabled() const { return mPaintStatsEnabled; }
+
+    /**
+     * @brief Returns the statistics of the last frame (or of the last paint
+     * outside of frames, say when the control got exposed).
+     */
+    const gxPaintStats& GetPaintStats() const { return mLastPaintStats; }
+
+    /**
+     * @brief Sets whether or not the paint statistics are shown over the
+     * contents, at the top left of the control.
+     *
+     * Showing them enables collecting them. The overlay is repainted along
+     * with any frame painting something else, with the statistics of the
+     * previous frame.
+     */
+    void SetPaintStatsOverlay( bool aShow );
+
+    /**
+     * @brief Sets the on-screen size below which view elements are painted
+     * with less detail.
+     *
+     * Zoomed out, thousands of view elements may be a few pixels each;
+     * painting them as proxies (see {@link gxVisual::GetDetail()}), without
+     * their children, saves painting what can't be told apart anyway.
+     * @param aSize The size in pixels, or 0 (the default) to always paint in
+     *        full.
+     * @param aPaintProxies Whether view elements below the size are painted
+     *        as proxies (rectangles), or left out.
+     */
+    void SetDetailSize( gxPix aSize,
+                        bool  aPaintProxies = true );
+
+    /**
+     * @brief Sets whether or not view elements covered by {@link
+     * gxVisual::SetOpaque() opaque} ones are left out of painting (they
+     * aren't by default).
+     *
+     * Before each paint, the view elements are traversed front to back to
+     * find those painted over entirely (see {@link gxOcclusion}). This pays
+     * off where opaque view elements stack up, say on dense dashboards.
+     */
+    void SetOcclusionCulling( bool aCulling );
+
+    bool IsOcclusionCulling() const { return mOcclusionCulling; }
+
+    /**
+     * @brief Finds the view elements covered by opaque ones, for painting
+     * the damaged rects.
+     *
+     * {@link gxLightweightSystem::Paint() Paint()} does so itself, unless
+     * already done for the same paint - as the control does to leave out
+     * background covered by opaque view elements (see IsOccluded()).
+     * @param aDamagedRects The rects about to be painted.
+     */
+    void Occlude( gxRects const &aDamagedRects );
+
+    /**
+     * @brief Returns whether or not a rect (in control coordinates) will be
+     * painted over entirely by opaque view elements, once Occlude() was
+     * called for the coming paint.
+     */
+    bool IsOccluded( gxRect const &aRect ) const;
+
+    /**
+     * @brief Handles a frame request that originated from the system queuing
+     * a frame (see {@link gxLightweightSystem::QueueFrame QueueFrame()}).
+     *
+     * Each frame runs a fixed pipeline, once:
+     *
+     * - Input - {@link gxSubject::SetThreadAffine() events fired on other
+     *   threads} are delivered, coalesced input (scroll positions) since the
+     *   last frame is applied, and {@link gxSubject::CoalesceEvents()
+     *   coalesced events} fired.
+     * - Validation - all invalid view elements are validated, which also lays
+     *   them out (or as many as the validation budget allows).
+     * - Damage - the dirty regions gathered since the last frame are passed on
+     *   to the control.
+     * - Paint - the control paints the damaged regions.
+     */
+    void OnFrame();
 
     /**
      * @brief Called upon scrol events on the control.
+     *
+     * The scroll is applied with the next frame, along with any later scroll
+     * on the same axis.
      * @param isVertical Whether the scroll was a vertical one (otherwise it's
      * horizontal).
      * @param aPosition The scroll position.
@@ -113,6 +236,47 @@ public:
      */
     void OnScrollChanged( const gxScroll *aScroll );
 protected:
+    /**
+     * @brief Queues a frame on the control, unless one is already queued.
+     */
+    void QueueFrame();
+
+    /**
+     * @brief Queues a frame to deliver events posted from another thread.
+     *
+     * This is called on the posting thread.
+     */
+    void OnEventsPosted();
+
+    /**
+     * @brief Validates for as long as the validation budget allows.
+     */
+    void ValidateSlice();
+
+    /**
+     * @brief Drops the dirty regions covered by others (elements are often
+     * erased and then repainted within the same bounds).
+     */
+    void MergeDirtyRegions();
+
+    /**
+     * @brief Returns the statistics to collect into, or NULL if not
+     * collecting.
+     */
+    gxPaintStats* GetCollectingStats()
+    {
+#ifdef GX_PAINT_STATS
+        return mPaintStatsEnabled ? &mPaintStats : NULL;
+#else
+        return NULL;
+#endif
+    }
+
+    /**
+     * @brief Paints the statistics overlay.
+     */
+    void PaintStatsOverlay( gxPainter &aPainter );
+
     /// The control this system is linked to.
     gxLightweightControl *mControl;
   
@@ -125,8 +289,54 @@ protected:
     /// the top-level view element.
     gxViewElement *mContents;
   
-    /// Denotes whether or not a validation request is already queued.
+    /// Denotes whether or not a frame is already queued.
+    bool mFrameQueued;
+
+    /// Denotes whether or not validation is needed with the next frame.
     bool mValidationQueued;
+
+    /// The time validation may take per frame (0 for no limit).
+    long mValidationBudget;
+
+    /// The number of invalid view elements when validation in slices
+    /// started, or 0 if not validating in slices.
+    unsigned long mValidationTotal;
+
+    /// The rects that need repainting with the next frame.
+    gxRects mDirtyRegions;
+
+    /// The scroll positions to apply with the next frame (horizontal, then
+    /// vertical), if pending.
+    gxPix mScrollPosition[ 2 ];
+    bool  mScrollPending[ 2 ];
+
+    /// Denotes whether or not a frame is running.
+    bool mInFrame;
+
+    /// Whether or not paint statistics are collected, and shown.
+    bool mPaintStatsEnabled;
+    bool mPaintStatsOverlay;
+
+    /// The statistics being collected, and those of the last frame.
+    gxPaintStats mPaintStats;
+    gxPaintStats mLastPaintStats;
+
+    /// Where the statistics overlay was last painted.
+    gxRect mPaintStatsOverlayBounds;
+
+    /// The on-screen size below which view elements are painted with less
+    /// detail, and whether they are then painted as proxies.
+    gxPix mDetailSize;
+    bool  mPaintProxies;
+
+    /// Whether or not occluded view elements are left out of painting, and
+    /// whether the region covered by opaque ones is built for the coming
+    /// paint.
+    bool mOcclusionCulling;
+    bool mOccluded;
+
+    /// The region covered by opaque view elements.
+    gxOcclusion mOcclusion;
 };
 
 #endif // gxLightweightSystem_h
\ No newline at end of file
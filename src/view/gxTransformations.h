@@ -3,20 +3,27 @@
 
 #include "core/gxFlags.h"
 #include "core/geometry/gxGeometry.h"
+#include "core/geometry/gxAffine.h"
  
 /**
  * @brief A structure containing the values of various transformations that
  * can be performed in the view layer.
+ *
+ * Scale, translate and scroll are composed into a single {@link gxAffine
+ * matrix} as they are set, so transforming is a single multiply-add.
  */
 struct gxTransformations
 {
-    gxScale Scale;
-    gxPoint Scroll;
-    gxPoint Translate;
+    /// Scale, translate and scroll, composed.
+    gxAffine     Matrix;
+
+    /// The (scaled) scroll composed into the matrix, kept as it outlives
+    /// the other transformations (see gxPainter::SetRelative()).
+    gxFixedPoint Scroll;
 
     bool ScaleNeeded()
     {
-        return Scale.IsntZero();
+        return !Matrix.IsTranslation();
     }
     
     bool ScrollNeeded()
@@ -26,7 +33,7 @@ struct gxTransformations
     
     bool TranslateNeeded()
     {
-        return Translate.IsntZero();
+        return Matrix.GetTranslation() != -Scroll;
     }
 };
 
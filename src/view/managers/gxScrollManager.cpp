@@ -3,6 +3,9 @@
 
 gxScrollManager::gxScrollManager()
 {
+    // Changes may come in faster than frames (say, with mouse wheel events),
+    // and observers only need the latest.
+    CoalesceEvents();
 }
 
 gxScrollManager::~gxScrollManager()
@@ -21,6 +21,9 @@ struct gxScroll
 /**
  * @brief Manages scroll by providing clients advance scroll modification
  * protocol and the ability to notify observers on changes.
+ *
+ * Events are {@link gxSubject::CoalesceEvents() coalesced}, so observers are
+ * notified at most once per frame, of the latest scroll.
  */
 class gxScrollManager: public gxObject,
                        public virtual gxSubject
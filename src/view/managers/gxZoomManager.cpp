@@ -2,6 +2,9 @@
 
 gxZoomManager::gxZoomManager()
 {
+    // Changes may come in faster than frames (say, with mouse wheel events),
+    // and observers only need the latest.
+    CoalesceEvents();
 }
 
 gxZoomManager::~gxZoomManager()
@@ -8,6 +8,9 @@
 /**
  * @brief Manages zoom by providing clients advance zoom modification protocol
  * and the ability to notify observers on changes.
+ *
+ * Events are {@link gxSubject::CoalesceEvents() coalesced}, so observers are
+ * notified at most once per frame, of the latest zoom.
  */
 class gxZoomManager: public gxObject,
                      public virtual gxSubject